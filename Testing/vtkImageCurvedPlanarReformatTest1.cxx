@@ -0,0 +1,313 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkImageCurvedPlanarReformat.h>
+#include <vtkParallelTransportFrame.h>
+#include <vtkParallelTransportFrameQuery.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix3x3.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double LinearFunction(const double position[3])
+{
+  return 2.0 * position[0] - 3.0 * position[1] + 0.5 * position[2] + 7.0;
+}
+
+//----------------------------------------------------------------------------
+bool IsInsideImage(vtkImageData* image, const double position[3], double index[3])
+{
+  image->TransformPhysicalPointToContinuousIndex(position, index);
+  int* extent = image->GetExtent();
+  for (int axis = 0; axis < 3; axis++)
+    {
+    if (index[axis] < extent[axis * 2] || index[axis] > extent[axis * 2 + 1])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Compares each output voxel to the expected value at the sample position.
+/// Voxels that are not inside the input image are expected to have the background value.
+int CheckReformattedImage(vtkImageCurvedPlanarReformat* reformat, vtkImageData* image, vtkPolyData* curve,
+  bool nearest, double tolerance)
+{
+  vtkNew<vtkParallelTransportFrameQuery> query;
+  CHECK_BOOL(query->Build(curve), true);
+  vtkImageData* output = reformat->GetOutput();
+  int* dimensions = output->GetDimensions();
+  double* origin = output->GetOrigin();
+  double* spacing = output->GetSpacing();
+  int numberOfInsideVoxels = 0;
+  for (int k = 0; k < dimensions[2]; k++)
+    {
+    double curvePosition[3] = { 0.0, 0.0, 0.0 };
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    double binormal[3] = { 0.0, 0.0, 0.0 };
+    query->GetFrame(origin[2] + k * spacing[2], curvePosition, normal, binormal, nullptr);
+    for (int j = 0; j < dimensions[1]; j++)
+      {
+      for (int i = 0; i < dimensions[0]; i++)
+        {
+        double position[3] = { 0.0, 0.0, 0.0 };
+        for (int axis = 0; axis < 3; axis++)
+          {
+          position[axis] = curvePosition[axis] + (origin[0] + i * spacing[0]) * normal[axis]
+            + (origin[1] + j * spacing[1]) * binormal[axis];
+          }
+        double index[3] = { 0.0, 0.0, 0.0 };
+        double expectedValue = reformat->GetBackgroundValue();
+        if (IsInsideImage(image, position, index))
+          {
+          numberOfInsideVoxels++;
+          if (nearest)
+            {
+            expectedValue = image->GetScalarComponentAsDouble(
+              vtkMath::Round(index[0]), vtkMath::Round(index[1]), vtkMath::Round(index[2]), 0);
+            }
+          else
+            {
+            expectedValue = LinearFunction(position);
+            }
+          }
+        else
+          {
+          // Skip voxels near the boundary, they may be interpolated or background
+          bool nearBoundary = false;
+          int* extent = image->GetExtent();
+          for (int axis = 0; axis < 3; axis++)
+            {
+            nearBoundary |= (index[axis] > extent[axis * 2] - 0.6 && index[axis] < extent[axis * 2 + 1] + 0.6);
+            }
+          if (nearBoundary)
+            {
+            continue;
+            }
+          }
+        CHECK_DOUBLE_TOLERANCE(output->GetScalarComponentAsDouble(i, j, k, 0), expectedValue, tolerance);
+        }
+      }
+    }
+  // Make sure the test is meaningful
+  CHECK_BOOL(numberOfInsideVoxels > 0, true);
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageCurvedPlanarReformatTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Input volume with non-identity direction matrix, filled with a linear function
+  // (linear interpolation of a linear function is exact)
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 59, 0, 69, 0, 49);
+  image->SetOrigin(-20.0, -25.0, -15.0);
+  image->SetSpacing(0.8, 0.9, 1.1);
+  vtkNew<vtkMatrix3x3> direction;
+  double angle = vtkMath::RadiansFromDegrees(30.0);
+  direction->SetElement(0, 0, cos(angle));
+  direction->SetElement(0, 1, -sin(angle));
+  direction->SetElement(1, 0, sin(angle));
+  direction->SetElement(1, 1, cos(angle));
+  image->SetDirectionMatrix(direction);
+  image->AllocateScalars(VTK_DOUBLE, 1);
+  for (int k = 0; k < 50; k++)
+    {
+    for (int j = 0; j < 70; j++)
+      {
+      for (int i = 0; i < 60; i++)
+        {
+        int index[3] = { i, j, k };
+        double position[3] = { 0.0, 0.0, 0.0 };
+        image->TransformIndexToPhysicalPoint(index, position);
+        image->SetScalarComponentFromDouble(i, j, k, 0, LinearFunction(position));
+        }
+      }
+    }
+
+  // Helix around the center of the volume
+  double center[3] = { 0.0, 0.0, 0.0 };
+  int centerIndex[3] = { 30, 35, 25 };
+  image->TransformIndexToPhysicalPoint(centerIndex, center);
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  const int numberOfCurvePoints = 40;
+  lines->InsertNextCell(numberOfCurvePoints);
+  for (int pointIndex = 0; pointIndex < numberOfCurvePoints; pointIndex++)
+    {
+    double t = vtkMath::Pi() * pointIndex / (numberOfCurvePoints - 1);
+    lines->InsertCellPoint(points->InsertNextPoint(
+      center[0] + 8.0 * cos(t), center[1] + 8.0 * sin(t), center[2] - 10.0 + 6.0 * t));
+    }
+  vtkNew<vtkPolyData> curve;
+  curve->SetPoints(points);
+  curve->SetLines(lines);
+
+  vtkNew<vtkParallelTransportFrame> parallelTransportFrame;
+  parallelTransportFrame->SetInputData(curve);
+  parallelTransportFrame->Update();
+
+  vtkNew<vtkImageCurvedPlanarReformat> reformat;
+  CHECK_INT(vtkImageCurvedPlanarReformat::GetInterpolationModeFromString(
+    vtkImageCurvedPlanarReformat::GetInterpolationModeAsString(vtkImageCurvedPlanarReformat::INTERPOLATION_NEAREST)),
+    vtkImageCurvedPlanarReformat::INTERPOLATION_NEAREST);
+
+  reformat->SetInputData(image);
+  reformat->SetCurve(parallelTransportFrame->GetOutput());
+  reformat->SetSliceSize(10.0, 8.0);
+  reformat->SetOutputSpacing(0.5, 0.4, 0.7);
+  reformat->SetBackgroundValue(-1000.0);
+  reformat->Update();
+
+  // Output geometry
+  {
+    vtkNew<vtkParallelTransportFrameQuery> query;
+    query->Build(parallelTransportFrame->GetOutput());
+    vtkImageData* output = reformat->GetOutput();
+    int* dimensions = output->GetDimensions();
+    CHECK_INT(dimensions[0], 20);
+    CHECK_INT(dimensions[1], 20);
+    CHECK_INT(dimensions[2], static_cast<int>(std::floor(query->GetCurveLength() / 0.7)) + 1);
+    CHECK_DOUBLE_TOLERANCE(output->GetOrigin()[0], -0.5 * 19 * 0.5, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(output->GetOrigin()[1], -0.5 * 19 * 0.4, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(output->GetOrigin()[2], 0.0, 1e-9);
+    CHECK_INT(output->GetScalarType(), VTK_DOUBLE);
+  }
+
+  // Linear interpolation
+  CHECK_EXIT_SUCCESS(CheckReformattedImage(reformat, image, parallelTransportFrame->GetOutput(), false, 1e-6));
+
+  // Slices that are partially outside of the volume are filled with background value
+  reformat->SetSliceSize(150.0, 150.0);
+  reformat->SetOutputSpacing(2.0, 2.0, 0.7);
+  reformat->Update();
+  CHECK_DOUBLE(reformat->GetOutput()->GetScalarComponentAsDouble(0, 0, 0, 0), -1000.0);
+  CHECK_EXIT_SUCCESS(CheckReformattedImage(reformat, image, parallelTransportFrame->GetOutput(), false, 1e-6));
+
+  // Nearest neighbor interpolation
+  reformat->SetInterpolationModeToNearest();
+  reformat->Update();
+  CHECK_EXIT_SUCCESS(CheckReformattedImage(reformat, image, parallelTransportFrame->GetOutput(), true, 1e-9));
+
+  // Changing only the voxels reuses the sampling positions but updates the output
+  reformat->SetInterpolationModeToLinear();
+  reformat->SetSliceSize(10.0, 8.0);
+  reformat->SetOutputSpacing(0.5, 0.4, 0.7);
+  reformat->Update();
+  double valueBefore = reformat->GetOutput()->GetScalarComponentAsDouble(10, 10, 5, 0);
+  for (int k = 0; k < 50; k++)
+    {
+    for (int j = 0; j < 70; j++)
+      {
+      for (int i = 0; i < 60; i++)
+        {
+        image->SetScalarComponentFromDouble(i, j, k, 0, 2.0 * image->GetScalarComponentAsDouble(i, j, k, 0));
+        }
+      }
+    }
+  image->Modified();
+  reformat->Update();
+  CHECK_DOUBLE_TOLERANCE(reformat->GetOutput()->GetScalarComponentAsDouble(10, 10, 5, 0), 2.0 * valueBefore, 1e-6);
+
+  // Changing parameters that do not affect the slice geometry reuses the sampling positions.
+  // Curve points are changed without calling Modified(), so the change is only noticed if the slices are recomputed.
+  vtkPoints* frameCurvePoints = parallelTransportFrame->GetOutput()->GetPoints();
+  int numberOfSlices = reformat->GetOutput()->GetDimensions()[2];
+  for (vtkIdType pointIndex = 0; pointIndex < frameCurvePoints->GetNumberOfPoints(); pointIndex++)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    frameCurvePoints->GetPoint(pointIndex, position);
+    position[2] *= 2.0;
+    frameCurvePoints->SetPoint(pointIndex, position);
+    }
+  reformat->SetBackgroundValue(-500.0);
+  reformat->SetInterpolationModeToNearest();
+  reformat->Update();
+  CHECK_INT(reformat->GetOutput()->GetDimensions()[2], numberOfSlices);
+  reformat->SetInterpolationModeToLinear();
+  reformat->SetBackgroundValue(-1000.0);
+  reformat->Update();
+  CHECK_INT(reformat->GetOutput()->GetDimensions()[2], numberOfSlices);
+  frameCurvePoints->Modified();
+  reformat->Update();
+  CHECK_BOOL(reformat->GetOutput()->GetDimensions()[2] > numberOfSlices, true);
+
+  // Changing the curve updates the sampling positions
+  for (int pointIndex = 0; pointIndex < numberOfCurvePoints; pointIndex++)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, position);
+    position[2] *= 0.5;
+    points->SetPoint(pointIndex, position);
+    }
+  points->Modified();
+  parallelTransportFrame->Update();
+  reformat->Update();
+  {
+    vtkNew<vtkParallelTransportFrameQuery> query;
+    query->Build(parallelTransportFrame->GetOutput());
+    CHECK_INT(reformat->GetOutput()->GetDimensions()[2], static_cast<int>(std::floor(query->GetCurveLength() / 0.7)) + 1);
+  }
+
+  // Unsigned char image with multiple components, nearest neighbor interpolation
+  vtkNew<vtkImageData> labelImage;
+  labelImage->SetExtent(0, 59, 0, 69, 0, 49);
+  labelImage->SetOrigin(image->GetOrigin());
+  labelImage->SetSpacing(image->GetSpacing());
+  labelImage->SetDirectionMatrix(direction);
+  labelImage->AllocateScalars(VTK_UNSIGNED_CHAR, 2);
+  for (int k = 0; k < 50; k++)
+    {
+    for (int j = 0; j < 70; j++)
+      {
+      for (int i = 0; i < 60; i++)
+        {
+        labelImage->SetScalarComponentFromDouble(i, j, k, 0, (i / 7 + j / 5 + k / 3) % 200);
+        labelImage->SetScalarComponentFromDouble(i, j, k, 1, 250);
+        }
+      }
+    }
+  reformat->SetInputData(labelImage);
+  reformat->SetInterpolationModeToNearest();
+  reformat->SetBackgroundValue(0);
+  reformat->Update();
+  CHECK_INT(reformat->GetOutput()->GetScalarType(), VTK_UNSIGNED_CHAR);
+  CHECK_INT(reformat->GetOutput()->GetNumberOfScalarComponents(), 2);
+  CHECK_EXIT_SUCCESS(CheckReformattedImage(reformat, labelImage, parallelTransportFrame->GetOutput(), true, 1e-9));
+  CHECK_DOUBLE(reformat->GetOutput()->GetScalarComponentAsDouble(10, 10, 5, 1), 250.0);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,395 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkImageLabelDilate3D.h>
+#include "vtkImageLabelTestingUtilities.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace vtkImageLabelTestingUtilities;
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a label image with small random blobs of a few labels.
+vtkSmartPointer<vtkImageData> CreateLabelImage(int scalarType, int numberOfComponents, int labelOffset, int labelStep,
+  unsigned int labelPercentage = 15)
+{
+  RandomSequence random(12345);
+  int extent[6] = { 0, 22, 0, 18, 0, 16 };
+  return CreateImage(extent, scalarType, numberOfComponents, [&](int, int, int, int)
+    {
+    unsigned int randomValue = random.Next(100);
+    return (randomValue < labelPercentage ? labelOffset + static_cast<int>(randomValue % 4) * labelStep : 0);
+    });
+}
+
+//----------------------------------------------------------------------------
+/// Compare filter output to a direct computation of the most frequent label in the neighborhood
+/// of each background voxel. Ties are resolved by choosing the smallest label.
+/// Voxels outside the mask or processing extent (if specified) must be unchanged.
+int CheckDilation(vtkImageData* input, vtkImageData* output, int kernelSize[3], double backgroundValue,
+  vtkImageData* mask = nullptr, const int* processingExtent = nullptr)
+{
+  int* outputExtent = output->GetExtent();
+  int numberOfComponents = input->GetNumberOfScalarComponents();
+  CHECK_INT(output->GetNumberOfScalarComponents(), numberOfComponents);
+  CHECK_INT(output->GetScalarType(), input->GetScalarType());
+  int numberOfDilatedVoxels = 0;
+  for (int k = outputExtent[4]; k <= outputExtent[5]; k++)
+    {
+    for (int j = outputExtent[2]; j <= outputExtent[3]; j++)
+      {
+      for (int i = outputExtent[0]; i <= outputExtent[1]; i++)
+        {
+        for (int c = 0; c < numberOfComponents; c++)
+          {
+          double expectedValue = input->GetScalarComponentAsDouble(i, j, k, c);
+          if (expectedValue == backgroundValue && IsEditable(i, j, k, mask, processingExtent))
+            {
+            int maxCount = GetMostFrequentValue(input, i, j, k, c, kernelSize, &backgroundValue, expectedValue);
+            if (maxCount > 0)
+              {
+              numberOfDilatedVoxels++;
+              }
+            }
+          CHECK_DOUBLE(output->GetScalarComponentAsDouble(i, j, k, c), expectedValue);
+          }
+        }
+      }
+    }
+  // Make sure the test is meaningful
+  CHECK_BOOL(numberOfDilatedVoxels > 0, true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestDilation(int scalarType, int numberOfComponents, int kernelSize0, int kernelSize1, int kernelSize2,
+  int labelOffset = 1, double backgroundValue = 0.0, int labelStep = 1)
+{
+  vtkSmartPointer<vtkImageData> input = CreateLabelImage(scalarType, numberOfComponents, labelOffset, labelStep);
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  int kernelSize[3] = { kernelSize0, kernelSize1, kernelSize2 };
+  dilate->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  dilate->SetBackgroundValue(backgroundValue);
+  dilate->Update();
+  return CheckDilation(input, dilate->GetOutput(), kernelSize, backgroundValue);
+}
+
+//----------------------------------------------------------------------------
+/// Create a larger label image that is mostly empty: a solid box, a few voxels near it, and a few far from it.
+/// Most regions of the image are either far from labels or inside the box.
+vtkSmartPointer<vtkImageData> CreateSparseLabelImage()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(-5, 69, 0, 49, 0, 39);
+  image->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+  image->GetPointData()->GetScalars()->Fill(0);
+  for (int k = 3; k <= 35; k++)
+    {
+    for (int j = 5; j <= 40; j++)
+      {
+      for (int i = 28; i <= 60; i++)
+        {
+        image->SetScalarComponentFromDouble(i, j, k, 0, 5);
+        }
+      }
+    }
+  image->SetScalarComponentFromDouble(26, 20, 20, 0, 7);
+  image->SetScalarComponentFromDouble(25, 21, 20, 0, 7);
+  image->SetScalarComponentFromDouble(61, 41, 36, 0, 7);
+  image->SetScalarComponentFromDouble(-5, 0, 0, 0, 3);
+  image->SetScalarComponentFromDouble(15, 47, 31, 0, 3);
+  image->SetScalarComponentFromDouble(69, 49, 39, 0, 2);
+  return image;
+}
+
+//----------------------------------------------------------------------------
+int TestSparseDilation(int kernelSize0, int kernelSize1, int kernelSize2)
+{
+  vtkSmartPointer<vtkImageData> input = CreateSparseLabelImage();
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  int kernelSize[3] = { kernelSize0, kernelSize1, kernelSize2 };
+  dilate->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  dilate->Update();
+  return CheckDilation(input, dilate->GetOutput(), kernelSize, 0.0);
+}
+
+//----------------------------------------------------------------------------
+/// In-place dilation overwrites the input, therefore a copy of the input is used for checking the results.
+int TestInPlaceDilation(vtkImageData* input, int kernelSize0, int kernelSize1, int kernelSize2)
+{
+  vtkNew<vtkImageData> originalInput;
+  originalInput->DeepCopy(input);
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  int kernelSize[3] = { kernelSize0, kernelSize1, kernelSize2 };
+  dilate->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  dilate->InPlaceOn();
+  dilate->Update();
+  CHECK_POINTER(dilate->GetOutput()->GetPointData()->GetScalars(), input->GetPointData()->GetScalars());
+  return CheckDilation(originalInput, dilate->GetOutput(), kernelSize, 0.0);
+}
+
+//----------------------------------------------------------------------------
+/// Compare filter output to a direct search for the nearest labelled voxel of each background voxel.
+/// If multiple labelled voxels are at the same distance then any of their labels is accepted.
+/// Voxels outside the mask (if specified) must be unchanged.
+int CheckDistanceDilation(vtkImageData* input, vtkImageData* output, double maximumDistance, double backgroundValue,
+  vtkImageData* mask = nullptr)
+{
+  int* extent = input->GetExtent();
+  int* outputExtent = output->GetExtent();
+  double* spacing = input->GetSpacing();
+  int numberOfComponents = input->GetNumberOfScalarComponents();
+  CHECK_INT(output->GetNumberOfScalarComponents(), numberOfComponents);
+  CHECK_INT(output->GetScalarType(), input->GetScalarType());
+  // Position and label of labelled voxels, for each component
+  std::vector<std::vector<std::pair<std::array<double, 3>, double>>> labelledVoxels(numberOfComponents);
+  for (int k = extent[4]; k <= extent[5]; k++)
+    {
+    for (int j = extent[2]; j <= extent[3]; j++)
+      {
+      for (int i = extent[0]; i <= extent[1]; i++)
+        {
+        for (int c = 0; c < numberOfComponents; c++)
+          {
+          double label = input->GetScalarComponentAsDouble(i, j, k, c);
+          if (label != backgroundValue)
+            {
+            std::array<double, 3> position = { { i * spacing[0], j * spacing[1], k * spacing[2] } };
+            labelledVoxels[c].emplace_back(position, label);
+            }
+          }
+        }
+      }
+    }
+  int numberOfDilatedVoxels = 0;
+  int numberOfFarVoxels = 0;
+  for (int k = outputExtent[4]; k <= outputExtent[5]; k++)
+    {
+    for (int j = outputExtent[2]; j <= outputExtent[3]; j++)
+      {
+      for (int i = outputExtent[0]; i <= outputExtent[1]; i++)
+        {
+        for (int c = 0; c < numberOfComponents; c++)
+          {
+          double outputValue = output->GetScalarComponentAsDouble(i, j, k, c);
+          double inputValue = input->GetScalarComponentAsDouble(i, j, k, c);
+          if (inputValue != backgroundValue || !IsEditable(i, j, k, mask, nullptr))
+            {
+            CHECK_DOUBLE(outputValue, inputValue);
+            continue;
+            }
+          double nearestSquaredDistance = -1.0;
+          std::set<double> nearestLabels;
+          for (const auto& labelledVoxel : labelledVoxels[c])
+            {
+            double offset[3] = { labelledVoxel.first[0] - i * spacing[0], labelledVoxel.first[1] - j * spacing[1],
+              labelledVoxel.first[2] - k * spacing[2] };
+            double squaredDistance = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+            if (nearestSquaredDistance < 0 || squaredDistance < nearestSquaredDistance - 1e-9)
+              {
+              nearestSquaredDistance = squaredDistance;
+              nearestLabels.clear();
+              }
+            if (squaredDistance <= nearestSquaredDistance + 1e-9)
+              {
+              nearestLabels.insert(labelledVoxel.second);
+              }
+            }
+          if (nearestSquaredDistance < 0 || nearestSquaredDistance > maximumDistance * maximumDistance)
+            {
+            numberOfFarVoxels++;
+            CHECK_DOUBLE(outputValue, backgroundValue);
+            }
+          else
+            {
+            numberOfDilatedVoxels++;
+            if (nearestLabels.find(outputValue) == nearestLabels.end())
+              {
+              std::cerr << "Voxel (" << i << ", " << j << ", " << k << ") component " << c
+                << " is set to " << outputValue << ", which is not a nearest label" << std::endl;
+              return EXIT_FAILURE;
+              }
+            }
+          }
+        }
+      }
+    }
+  // Make sure the test is meaningful
+  CHECK_BOOL(numberOfDilatedVoxels > 0, true);
+  CHECK_BOOL(numberOfFarVoxels > 0, true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestDistanceDilation(int scalarType, int numberOfComponents, double spacing0, double spacing1, double spacing2,
+  double maximumDistance, int labelOffset = 1, double backgroundValue = 0.0)
+{
+  vtkSmartPointer<vtkImageData> input = CreateLabelImage(scalarType, numberOfComponents, labelOffset, 1, 1);
+  input->SetSpacing(spacing0, spacing1, spacing2);
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  dilate->SetDilationModeToDistance();
+  dilate->SetMaximumDistance(maximumDistance);
+  dilate->SetBackgroundValue(backgroundValue);
+  dilate->Update();
+  return CheckDistanceDilation(input, dilate->GetOutput(), maximumDistance, backgroundValue);
+}
+
+//----------------------------------------------------------------------------
+/// Dilation restricted to a mask and a processing extent.
+int TestRestrictedDilation(int dilationMode, bool inPlace, bool useMask, bool useProcessingExtent)
+{
+  vtkSmartPointer<vtkImageData> input = CreateLabelImage(VTK_UNSIGNED_SHORT, 1, 1, 1,
+    dilationMode == vtkImageLabelDilate3D::DILATION_MODE_DISTANCE ? 1 : 15);
+  input->SetSpacing(0.8, 1.0, 1.5);
+  vtkNew<vtkImageData> originalInput;
+  originalInput->DeepCopy(input);
+  vtkSmartPointer<vtkImageData> mask = CreateMask(2, 18, -3, 15, 3, 14);
+  mask->SetSpacing(input->GetSpacing());
+  int processingExtent[6] = { 4, 17, 0, 11, 5, 16 };
+  int kernelSize[3] = { 5, 3, 3 };
+  double maximumDistance = 3.1;
+
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  dilate->SetDilationMode(dilationMode);
+  dilate->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  dilate->SetMaximumDistance(maximumDistance);
+  dilate->SetInPlace(inPlace);
+  if (useMask)
+    {
+    dilate->SetMaskInputData(mask);
+    CHECK_POINTER(dilate->GetMaskInput(), mask.GetPointer());
+    }
+  if (useProcessingExtent)
+    {
+    dilate->SetProcessingExtent(processingExtent);
+    }
+  dilate->Update();
+
+  int* outputExtent = dilate->GetOutput()->GetExtent();
+  for (int i = 0; i < 6; i++)
+    {
+    CHECK_INT(outputExtent[i], (useProcessingExtent && !inPlace) ? processingExtent[i] : originalInput->GetExtent()[i]);
+    }
+  if (dilationMode == vtkImageLabelDilate3D::DILATION_MODE_DISTANCE)
+    {
+    return CheckDistanceDilation(originalInput, dilate->GetOutput(), maximumDistance, 0.0,
+      useMask ? mask.GetPointer() : nullptr);
+    }
+  return CheckDilation(originalInput, dilate->GetOutput(), kernelSize, 0.0, useMask ? mask.GetPointer() : nullptr,
+    useProcessingExtent ? processingExtent : nullptr);
+}
+
+//----------------------------------------------------------------------------
+/// Mask must have the same geometry as the input.
+int TestMaskGeometryMismatch(int dilationMode)
+{
+  vtkSmartPointer<vtkImageData> input = CreateLabelImage(VTK_UNSIGNED_CHAR, 1, 1, 1);
+  vtkSmartPointer<vtkImageData> mask = CreateMask(2, 18, -3, 15, 3, 14);
+  vtkNew<vtkImageLabelDilate3D> dilate;
+  dilate->SetInputData(input);
+  dilate->SetDilationMode(dilationMode);
+  dilate->SetMaskInputData(mask);
+
+  mask->SetSpacing(1.0, 1.0, 2.0);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  dilate->Update();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  mask->SetSpacing(1.0, 1.0, 1.0);
+  mask->SetOrigin(0.5, 0.0, 0.0);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  dilate->Update();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  mask->SetOrigin(0.0, 0.0, 0.0);
+  dilate->Update();
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelDilate3DTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  TESTING_OUTPUT_INIT();
+
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_CHAR, 1, 3, 3, 3));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_CHAR, 1, 5, 3, 1));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_SHORT, 1, 7, 7, 7));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_SHORT, 1, 4, 2, 6, 1000));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_SHORT, 1, 3, 5, 3, -2));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_INT, 2, 3, 3, 3, 100000));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_FLOAT, 1, 5, 5, 5, 1));
+  // Label values spread over a large range (too large for counting in a dense array for int)
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_INT, 1, 5, 5, 3, -150000, 0.0, 100000));
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_SHORT, 1, 3, 3, 3, 1, 0.0, 20000));
+  // Non-zero background value
+  CHECK_EXIT_SUCCESS(TestDilation(VTK_UNSIGNED_CHAR, 1, 3, 3, 3, 1, 2.0));
+  // Large image with regions that are not changed by dilation
+  CHECK_EXIT_SUCCESS(TestSparseDilation(3, 3, 3));
+  CHECK_EXIT_SUCCESS(TestSparseDilation(7, 2, 5));
+  CHECK_EXIT_SUCCESS(TestSparseDilation(1, 1, 21));
+  // In-place dilation
+  CHECK_EXIT_SUCCESS(TestInPlaceDilation(CreateLabelImage(VTK_UNSIGNED_CHAR, 1, 1, 1), 3, 3, 3));
+  CHECK_EXIT_SUCCESS(TestInPlaceDilation(CreateLabelImage(VTK_SHORT, 2, -2, 1), 5, 3, 4));
+  CHECK_EXIT_SUCCESS(TestInPlaceDilation(CreateLabelImage(VTK_FLOAT, 1, 1, 1), 3, 5, 1));
+  CHECK_EXIT_SUCCESS(TestInPlaceDilation(CreateSparseLabelImage(), 5, 5, 7));
+  // Dilation restricted to a mask and processing extent
+  const int kernel = vtkImageLabelDilate3D::DILATION_MODE_KERNEL;
+  const int distance = vtkImageLabelDilate3D::DILATION_MODE_DISTANCE;
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(kernel, false, true, false));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(kernel, false, false, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(kernel, false, true, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(kernel, true, true, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(kernel, true, false, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(distance, false, true, false));
+  CHECK_EXIT_SUCCESS(TestRestrictedDilation(distance, false, true, true));
+  CHECK_EXIT_SUCCESS(TestMaskGeometryMismatch(kernel));
+  CHECK_EXIT_SUCCESS(TestMaskGeometryMismatch(distance));
+
+  // Distance dilation
+  CHECK_INT(vtkImageLabelDilate3D::GetDilationModeFromString(
+    vtkImageLabelDilate3D::GetDilationModeAsString(vtkImageLabelDilate3D::DILATION_MODE_DISTANCE)),
+    vtkImageLabelDilate3D::DILATION_MODE_DISTANCE);
+  CHECK_EXIT_SUCCESS(TestDistanceDilation(VTK_UNSIGNED_CHAR, 1, 1.0, 1.0, 1.0, 2.5));
+  CHECK_EXIT_SUCCESS(TestDistanceDilation(VTK_SHORT, 2, 0.7, 1.3, 2.1, 3.05, -2));
+  CHECK_EXIT_SUCCESS(TestDistanceDilation(VTK_FLOAT, 1, 0.5, 0.5, 3.0, 2.2));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkImageLabelMajorityVote3D.h>
+#include "vtkImageLabelTestingUtilities.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+
+using namespace vtkImageLabelTestingUtilities;
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a label image with a few large regions. Voxels in the left part of the image
+/// are replaced by random labels, the right part is left clean (so that it contains uniform regions).
+vtkSmartPointer<vtkImageData> CreateNoisyLabelImage(int scalarType, int numberOfComponents, int labelOffset)
+{
+  RandomSequence random(12345);
+  int extent[6] = { -3, 52, 0, 37, 0, 34 };
+  return CreateImage(extent, scalarType, numberOfComponents, [&](int i, int j, int k, int c)
+    {
+    int label = 0;
+    if (k > 4 && k < 30 && j > 3 && j < 33)
+      {
+      label = (i < 12 + c ? labelOffset : labelOffset + 2);
+      }
+    unsigned int randomValue = random.Next(100);
+    if (i < 20 && randomValue < 30)
+      {
+      label = (randomValue % 3 == 0 ? 0 : labelOffset + static_cast<int>(randomValue % 4));
+      }
+    return label;
+    });
+}
+
+//----------------------------------------------------------------------------
+/// Compare filter output to a direct computation of the most frequent value (including background)
+/// in the neighborhood of each voxel. Ties are resolved by choosing the smallest value.
+/// Voxels outside the mask or processing extent (if specified) must be unchanged.
+int CheckMajorityVote(vtkImageData* input, vtkImageData* output, int kernelSize[3],
+  vtkImageData* mask = nullptr, const int* processingExtent = nullptr)
+{
+  int* outputExtent = output->GetExtent();
+  int numberOfComponents = input->GetNumberOfScalarComponents();
+  CHECK_INT(output->GetNumberOfScalarComponents(), numberOfComponents);
+  CHECK_INT(output->GetScalarType(), input->GetScalarType());
+  int numberOfChangedLabelledVoxels = 0;
+  int numberOfChangedBackgroundVoxels = 0;
+  for (int k = outputExtent[4]; k <= outputExtent[5]; k++)
+    {
+    for (int j = outputExtent[2]; j <= outputExtent[3]; j++)
+      {
+      for (int i = outputExtent[0]; i <= outputExtent[1]; i++)
+        {
+        for (int c = 0; c < numberOfComponents; c++)
+          {
+          double inputValue = input->GetScalarComponentAsDouble(i, j, k, c);
+          double expectedValue = inputValue;
+          if (IsEditable(i, j, k, mask, processingExtent))
+            {
+            GetMostFrequentValue(input, i, j, k, c, kernelSize, nullptr, expectedValue);
+            if (expectedValue != inputValue)
+              {
+              (inputValue == 0 ? numberOfChangedBackgroundVoxels : numberOfChangedLabelledVoxels)++;
+              }
+            }
+          CHECK_DOUBLE(output->GetScalarComponentAsDouble(i, j, k, c), expectedValue);
+          }
+        }
+      }
+    }
+  // Make sure the test is meaningful: both labelled and background voxels are changed
+  CHECK_BOOL(numberOfChangedLabelledVoxels > 0, true);
+  CHECK_BOOL(numberOfChangedBackgroundVoxels > 0, true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMajorityVote(int scalarType, int numberOfComponents, int kernelSize0, int kernelSize1, int kernelSize2,
+  int labelOffset = 1)
+{
+  vtkSmartPointer<vtkImageData> input = CreateNoisyLabelImage(scalarType, numberOfComponents, labelOffset);
+  vtkNew<vtkImageLabelMajorityVote3D> smooth;
+  smooth->SetInputData(input);
+  int kernelSize[3] = { kernelSize0, kernelSize1, kernelSize2 };
+  smooth->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  smooth->Update();
+  return CheckMajorityVote(input, smooth->GetOutput(), kernelSize);
+}
+
+//----------------------------------------------------------------------------
+/// Smoothing restricted to a mask and/or processing extent, optionally in place.
+int TestRestrictedMajorityVote(bool inPlace, bool useMask, bool useProcessingExtent)
+{
+  vtkSmartPointer<vtkImageData> input = CreateNoisyLabelImage(VTK_UNSIGNED_SHORT, 1, 3);
+  vtkNew<vtkImageData> originalInput;
+  originalInput->DeepCopy(input);
+  vtkSmartPointer<vtkImageData> mask = (useMask ? CreateMask(2, 60, -3, 26, 3, 25) : nullptr);
+  int processingExtent[6] = { 5, 48, 2, 33, 4, 27 };
+
+  vtkNew<vtkImageLabelMajorityVote3D> smooth;
+  smooth->SetInputData(input);
+  int kernelSize[3] = { 3, 5, 3 };
+  smooth->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  smooth->SetInPlace(inPlace);
+  if (mask)
+    {
+    smooth->SetMaskInputData(mask);
+    }
+  if (useProcessingExtent)
+    {
+    smooth->SetProcessingExtent(processingExtent);
+    }
+  smooth->Update();
+  if (inPlace)
+    {
+    CHECK_POINTER(smooth->GetOutput()->GetPointData()->GetScalars(), input->GetPointData()->GetScalars());
+    }
+  return CheckMajorityVote(originalInput, smooth->GetOutput(), kernelSize, mask,
+    useProcessingExtent ? processingExtent : nullptr);
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelMajorityVote3DTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  TESTING_OUTPUT_INIT();
+
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_UNSIGNED_CHAR, 1, 3, 3, 3));
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_UNSIGNED_CHAR, 1, 5, 3, 1));
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_UNSIGNED_SHORT, 1, 4, 2, 6, 1000));
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_SHORT, 2, 3, 3, 3, -2));
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_INT, 1, 5, 5, 5, 100000));
+  CHECK_EXIT_SUCCESS(TestMajorityVote(VTK_FLOAT, 1, 3, 5, 3));
+
+  // Restricted and in-place smoothing
+  CHECK_EXIT_SUCCESS(TestRestrictedMajorityVote(false, true, false));
+  CHECK_EXIT_SUCCESS(TestRestrictedMajorityVote(false, false, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedMajorityVote(false, true, true));
+  CHECK_EXIT_SUCCESS(TestRestrictedMajorityVote(true, false, false));
+  CHECK_EXIT_SUCCESS(TestRestrictedMajorityVote(true, true, true));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkImageLabelStatistics.h>
+#include "vtkImageLabelTestingUtilities.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix3x3.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+
+using namespace vtkImageLabelTestingUtilities;
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create an image with random values. Along the x axis the value changes with the specified probability
+/// (in percent), so that the image contains runs of voxels with the same value.
+vtkSmartPointer<vtkImageData> CreateRandomImage(int extent[6], int scalarType, int numberOfComponents,
+  double minimumValue, int numberOfValues, unsigned int changePercentage, unsigned int randomSeed)
+{
+  RandomSequence random(randomSeed);
+  double value = minimumValue;
+  return CreateImage(extent, scalarType, numberOfComponents, [&](int i, int, int, int c)
+    {
+    if (c == 0)
+      {
+      if (i == extent[0])
+        {
+        // Runs do not continue in the next row
+        value = minimumValue;
+        }
+      if (random.Next(100) < changePercentage)
+        {
+        value = minimumValue + static_cast<int>(random.Next(static_cast<unsigned int>(numberOfValues)));
+        }
+      }
+    return value + c;
+    });
+}
+
+//----------------------------------------------------------------------------
+/// Statistics of a label, computed directly
+struct LabelStatistics
+{
+  int VoxelCount = 0;
+  double IndexSum[3] = { 0.0, 0.0, 0.0 };
+  int Extent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  double IntensityMinimum = std::numeric_limits<double>::infinity();
+  double IntensityMaximum = -std::numeric_limits<double>::infinity();
+  double IntensitySum = 0.0;
+  double IntensitySquaredDeviationSum = 0.0;
+};
+
+//----------------------------------------------------------------------------
+/// Compare filter output to statistics computed voxel by voxel.
+/// Intensity mean and standard deviation are computed in two passes (mean first, then deviations from the mean).
+int CheckStatistics(vtkImageData* labelImage, vtkImageData* intensityImage, double backgroundValue, vtkTable* table,
+  int minimumNumberOfLabels)
+{
+  std::map<double, LabelStatistics> expectedStatistics;
+  int* extent = labelImage->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; k++)
+    {
+    for (int j = extent[2]; j <= extent[3]; j++)
+      {
+      for (int i = extent[0]; i <= extent[1]; i++)
+        {
+        double label = labelImage->GetScalarComponentAsDouble(i, j, k, 0);
+        if (label == backgroundValue)
+          {
+          continue;
+          }
+        LabelStatistics& statistics = expectedStatistics[label];
+        statistics.VoxelCount++;
+        int ijk[3] = { i, j, k };
+        for (int axis = 0; axis < 3; axis++)
+          {
+          statistics.IndexSum[axis] += ijk[axis];
+          statistics.Extent[axis * 2] = std::min(statistics.Extent[axis * 2], ijk[axis]);
+          statistics.Extent[axis * 2 + 1] = std::max(statistics.Extent[axis * 2 + 1], ijk[axis]);
+          }
+        if (intensityImage)
+          {
+          double intensity = intensityImage->GetScalarComponentAsDouble(i, j, k, 0);
+          statistics.IntensityMinimum = std::min(statistics.IntensityMinimum, intensity);
+          statistics.IntensityMaximum = std::max(statistics.IntensityMaximum, intensity);
+          statistics.IntensitySum += intensity;
+          }
+        }
+      }
+    }
+  if (intensityImage)
+    {
+    for (int k = extent[4]; k <= extent[5]; k++)
+      {
+      for (int j = extent[2]; j <= extent[3]; j++)
+        {
+        for (int i = extent[0]; i <= extent[1]; i++)
+          {
+          double label = labelImage->GetScalarComponentAsDouble(i, j, k, 0);
+          if (label == backgroundValue)
+            {
+            continue;
+            }
+          LabelStatistics& statistics = expectedStatistics[label];
+          double deviation = intensityImage->GetScalarComponentAsDouble(i, j, k, 0)
+            - statistics.IntensitySum / statistics.VoxelCount;
+          statistics.IntensitySquaredDeviationSum += deviation * deviation;
+          }
+        }
+      }
+    }
+
+  // Make sure the test is meaningful
+  CHECK_BOOL(static_cast<int>(expectedStatistics.size()) >= minimumNumberOfLabels, true);
+
+  CHECK_INT(table->GetNumberOfRows(), static_cast<int>(expectedStatistics.size()));
+  CHECK_INT(table->GetNumberOfColumns(), intensityImage ? 9 : 5);
+  vtkDataArray* labelValues = vtkDataArray::SafeDownCast(table->GetColumnByName("LabelValue"));
+  vtkDataArray* voxelCounts = vtkDataArray::SafeDownCast(table->GetColumnByName("VoxelCount"));
+  vtkDataArray* volumes = vtkDataArray::SafeDownCast(table->GetColumnByName("Volume"));
+  vtkDataArray* centroids = vtkDataArray::SafeDownCast(table->GetColumnByName("Centroid"));
+  vtkDataArray* extents = vtkDataArray::SafeDownCast(table->GetColumnByName("Extent"));
+  CHECK_NOT_NULL(labelValues);
+  CHECK_NOT_NULL(voxelCounts);
+  CHECK_NOT_NULL(volumes);
+  CHECK_NOT_NULL(centroids);
+  CHECK_NOT_NULL(extents);
+  double* spacing = labelImage->GetSpacing();
+  double voxelVolume = std::fabs(spacing[0] * spacing[1] * spacing[2]);
+  vtkIdType row = 0;
+  for (const auto& labelStatistics : expectedStatistics)
+    {
+    const LabelStatistics& expected = labelStatistics.second;
+    CHECK_DOUBLE(labelValues->GetTuple1(row), labelStatistics.first);
+    CHECK_INT(static_cast<int>(voxelCounts->GetTuple1(row)), expected.VoxelCount);
+    CHECK_DOUBLE_TOLERANCE(volumes->GetTuple1(row), expected.VoxelCount * voxelVolume, 1e-9);
+    double centroidIndex[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; axis++)
+      {
+      centroidIndex[axis] = expected.IndexSum[axis] / expected.VoxelCount;
+      }
+    double expectedCentroid[3] = { 0.0, 0.0, 0.0 };
+    labelImage->TransformContinuousIndexToPhysicalPoint(centroidIndex, expectedCentroid);
+    for (int axis = 0; axis < 3; axis++)
+      {
+      CHECK_DOUBLE_TOLERANCE(centroids->GetComponent(row, axis), expectedCentroid[axis], 1e-9);
+      }
+    for (int i = 0; i < 6; i++)
+      {
+      CHECK_INT(static_cast<int>(extents->GetComponent(row, i)), expected.Extent[i]);
+      }
+    if (intensityImage)
+      {
+      double mean = expected.IntensitySum / expected.VoxelCount;
+      double standardDeviation = std::sqrt(expected.IntensitySquaredDeviationSum / expected.VoxelCount);
+      CHECK_DOUBLE(vtkDataArray::SafeDownCast(table->GetColumnByName("IntensityMinimum"))->GetTuple1(row),
+        expected.IntensityMinimum);
+      CHECK_DOUBLE(vtkDataArray::SafeDownCast(table->GetColumnByName("IntensityMaximum"))->GetTuple1(row),
+        expected.IntensityMaximum);
+      CHECK_DOUBLE_TOLERANCE(vtkDataArray::SafeDownCast(table->GetColumnByName("IntensityMean"))->GetTuple1(row),
+        mean, 1e-6 + 1e-12 * std::fabs(mean));
+      CHECK_DOUBLE_TOLERANCE(
+        vtkDataArray::SafeDownCast(table->GetColumnByName("IntensityStandardDeviation"))->GetTuple1(row),
+        standardDeviation, 1e-6 * (1.0 + standardDeviation));
+      }
+    row++;
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestStatistics(int labelScalarType, int labelNumberOfComponents, int minimumLabel, int numberOfLabels,
+  unsigned int changePercentage, int intensityScalarType, double backgroundValue = 0.0,
+  double intensityMinimumValue = -100.0)
+{
+  int labelExtent[6] = { -4, 45, 2, 38, 0, 27 };
+  vtkSmartPointer<vtkImageData> labelImage = CreateRandomImage(labelExtent, labelScalarType, labelNumberOfComponents,
+    minimumLabel, numberOfLabels, changePercentage, 12345);
+  labelImage->SetSpacing(0.5, 1.2, 2.0);
+  labelImage->SetOrigin(10.0, -20.0, 30.0);
+  vtkNew<vtkMatrix3x3> direction;
+  direction->SetElement(0, 0, 0.0);
+  direction->SetElement(0, 1, -1.0);
+  direction->SetElement(1, 0, 1.0);
+  direction->SetElement(1, 1, 0.0);
+  labelImage->SetDirectionMatrix(direction);
+
+  vtkSmartPointer<vtkImageData> intensityImage;
+  if (intensityScalarType != VTK_VOID)
+    {
+    // Intensity image is larger than the labelmap
+    int intensityExtent[6] = { -6, 50, 0, 38, 0, 30 };
+    intensityImage = CreateRandomImage(intensityExtent, intensityScalarType, 1, intensityMinimumValue, 1000, 90, 6789);
+    intensityImage->SetSpacing(labelImage->GetSpacing());
+    intensityImage->SetOrigin(labelImage->GetOrigin());
+    intensityImage->SetDirectionMatrix(labelImage->GetDirectionMatrix());
+    }
+
+  vtkNew<vtkImageLabelStatistics> statistics;
+  statistics->SetInputData(labelImage);
+  if (intensityImage)
+    {
+    statistics->SetIntensityInputData(intensityImage);
+    }
+  statistics->SetBackgroundValue(backgroundValue);
+  statistics->Update();
+  return CheckStatistics(labelImage, intensityImage, backgroundValue, statistics->GetOutput(),
+    std::min(numberOfLabels - 1, 200));
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  TESTING_OUTPUT_INIT();
+
+  // Many labels
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_UNSIGNED_SHORT, 1, 0, 260, 20, VTK_FLOAT));
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_INT, 1, -50000, 300, 100, VTK_SHORT));
+  // Few labels in long runs
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_UNSIGNED_CHAR, 1, 0, 5, 3, VTK_UNSIGNED_CHAR));
+  // Labels are read from the first component, non-zero background value, no intensity image
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_SHORT, 2, -3, 8, 10, VTK_VOID, 1.0));
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_FLOAT, 1, 1, 10, 30, VTK_DOUBLE));
+  // Background value that is not representable in the label scalar type excludes no labels
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_UNSIGNED_CHAR, 1, 250, 6, 20, VTK_FLOAT, -1.0));
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_SHORT, 1, -3, 8, 10, VTK_VOID, 1.5));
+  // Intensity mean is much larger than the standard deviation
+  CHECK_EXIT_SUCCESS(TestStatistics(VTK_UNSIGNED_SHORT, 1, 0, 50, 20, VTK_DOUBLE, 0.0, 1e12));
+
+  // Intensity image must contain the labelmap
+  {
+    int labelExtent[6] = { 0, 10, 0, 10, 0, 10 };
+    int intensityExtent[6] = { 0, 10, 1, 10, 0, 10 };
+    vtkNew<vtkImageLabelStatistics> statistics;
+    statistics->SetInputData(CreateRandomImage(labelExtent, VTK_UNSIGNED_CHAR, 1, 0, 3, 10, 1));
+    statistics->SetIntensityInputData(CreateRandomImage(intensityExtent, VTK_FLOAT, 1, 0, 3, 10, 1));
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    statistics->Update();
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(statistics->GetOutput()->GetNumberOfRows(), 0);
+  }
+
+  // Intensity image must have the same geometry as the labelmap
+  {
+    int extent[6] = { 0, 10, 0, 10, 0, 10 };
+    vtkSmartPointer<vtkImageData> labelImage = CreateRandomImage(extent, VTK_UNSIGNED_CHAR, 1, 0, 3, 10, 1);
+    vtkSmartPointer<vtkImageData> intensityImage = CreateRandomImage(extent, VTK_FLOAT, 1, 0, 3, 10, 1);
+    vtkNew<vtkImageLabelStatistics> statistics;
+    statistics->SetInputData(labelImage);
+    statistics->SetIntensityInputData(intensityImage);
+
+    intensityImage->SetSpacing(1.0, 1.0, 1.5);
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    statistics->Update();
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(statistics->GetOutput()->GetNumberOfRows(), 0);
+
+    intensityImage->SetSpacing(1.0, 1.0, 1.0);
+    intensityImage->SetOrigin(0.0, 2.0, 0.0);
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    statistics->Update();
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(statistics->GetOutput()->GetNumberOfRows(), 0);
+
+    intensityImage->SetOrigin(0.0, 0.0, 0.0);
+    vtkNew<vtkMatrix3x3> direction;
+    direction->SetElement(0, 0, -1.0);
+    direction->SetElement(1, 1, -1.0);
+    intensityImage->SetDirectionMatrix(direction);
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    statistics->Update();
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(statistics->GetOutput()->GetNumberOfRows(), 0);
+
+    // Same geometry
+    intensityImage->SetDirectionMatrix(labelImage->GetDirectionMatrix());
+    statistics->Update();
+    CHECK_EXIT_SUCCESS(CheckStatistics(labelImage, intensityImage, 0.0, statistics->GetOutput(), 2));
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Helper functions for testing label image filters
+// (vtkImageLabelDilate3D, vtkImageLabelMajorityVote3D, vtkImageLabelStatistics).
+
+#ifndef vtkImageLabelTestingUtilities_h
+#define vtkImageLabelTestingUtilities_h
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <map>
+
+namespace vtkImageLabelTestingUtilities
+{
+
+//----------------------------------------------------------------------------
+/// Pseudo-random number generator (linear congruential), so that test images are the same on all platforms.
+class RandomSequence
+{
+public:
+  explicit RandomSequence(unsigned int seed) : State(seed) {}
+
+  /// Returns the next pseudo-random number in the range [0, numberOfValues - 1].
+  unsigned int Next(unsigned int numberOfValues)
+    {
+    this->State = this->State * 1103515245 + 12345;
+    return (this->State >> 16) % numberOfValues;
+    }
+
+private:
+  unsigned int State;
+};
+
+//----------------------------------------------------------------------------
+/// Create an image of the specified extent and scalar type. Each voxel component is set to
+/// voxelValue(i, j, k, component). Voxels are visited in memory order (component, i, j, k).
+template <typename VoxelValueFunction>
+vtkSmartPointer<vtkImageData> CreateImage(const int extent[6], int scalarType, int numberOfComponents,
+  VoxelValueFunction voxelValue)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(extent[0], extent[1], extent[2], extent[3], extent[4], extent[5]);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  for (int k = extent[4]; k <= extent[5]; k++)
+    {
+    for (int j = extent[2]; j <= extent[3]; j++)
+      {
+      for (int i = extent[0]; i <= extent[1]; i++)
+        {
+        for (int c = 0; c < numberOfComponents; c++)
+          {
+          image->SetScalarComponentFromDouble(i, j, k, c, voxelValue(i, j, k, c));
+          }
+        }
+      }
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+/// Create a mask in the specified extent with a pattern of holes.
+inline vtkSmartPointer<vtkImageData> CreateMask(int extent0, int extent1, int extent2, int extent3,
+  int extent4, int extent5)
+{
+  vtkSmartPointer<vtkImageData> mask = vtkSmartPointer<vtkImageData>::New();
+  mask->SetExtent(extent0, extent1, extent2, extent3, extent4, extent5);
+  mask->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  for (int k = extent4; k <= extent5; k++)
+    {
+    for (int j = extent2; j <= extent3; j++)
+      {
+      for (int i = extent0; i <= extent1; i++)
+        {
+        mask->SetScalarComponentFromDouble(i, j, k, 0, (i + 2 * j + k) % 5 == 0 ? 0 : 255);
+        }
+      }
+    }
+  return mask;
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the voxel may be changed by the filter: it is inside the mask and the processing extent.
+inline bool IsEditable(int i, int j, int k, vtkImageData* mask, const int* processingExtent)
+{
+  int ijk[3] = { i, j, k };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    if (processingExtent && (ijk[axis] < processingExtent[axis * 2] || ijk[axis] > processingExtent[axis * 2 + 1]))
+      {
+      return false;
+      }
+    if (mask && (ijk[axis] < mask->GetExtent()[axis * 2] || ijk[axis] > mask->GetExtent()[axis * 2 + 1]))
+      {
+      return false;
+      }
+    }
+  return !mask || mask->GetScalarComponentAsDouble(i, j, k, 0) != 0;
+}
+
+//----------------------------------------------------------------------------
+/// Find the most frequent value of a component in the kernel neighborhood of a voxel, by counting all voxels.
+/// Voxels of ignoredValue (if specified) are not counted. Ties are resolved by choosing the smallest value.
+/// Returns the number of occurrences of the most frequent value (0 if no voxels are counted).
+inline int GetMostFrequentValue(vtkImageData* input, int i, int j, int k, int component, const int kernelSize[3],
+  const double* ignoredValue, double& mostFrequentValue)
+{
+  int* extent = input->GetExtent();
+  std::map<double, int> valueCounts;
+  int ijk[3] = { i, j, k };
+  int hoodMin[3] = { 0, 0, 0 };
+  int hoodMax[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    hoodMin[axis] = std::max(ijk[axis] - kernelSize[axis] / 2, extent[axis * 2]);
+    hoodMax[axis] = std::min(ijk[axis] - kernelSize[axis] / 2 + kernelSize[axis] - 1, extent[axis * 2 + 1]);
+    }
+  for (int hoodK = hoodMin[2]; hoodK <= hoodMax[2]; hoodK++)
+    {
+    for (int hoodJ = hoodMin[1]; hoodJ <= hoodMax[1]; hoodJ++)
+      {
+      for (int hoodI = hoodMin[0]; hoodI <= hoodMax[0]; hoodI++)
+        {
+        double value = input->GetScalarComponentAsDouble(hoodI, hoodJ, hoodK, component);
+        if (!ignoredValue || value != *ignoredValue)
+          {
+          valueCounts[value]++;
+          }
+        }
+      }
+    }
+  int maxCount = 0;
+  for (const auto& valueCount : valueCounts)
+    {
+    // map is ordered by value, so the smallest value is kept for equal counts
+    if (valueCount.second > maxCount)
+      {
+      mostFrequentValue = valueCount.first;
+      maxCount = valueCount.second;
+      }
+    }
+  return maxCount;
+}
+
+} // end namespace vtkImageLabelTestingUtilities
+
+#endif
@@ -0,0 +1,218 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkParallelTransportFrame.h>
+#include <vtkParallelTransportFrameQuery.h>
+
+// VTK includes
+#include <vtkArcSource.h>
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+//----------------------------------------------------------------------------
+int vtkParallelTransportFrameQueryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  TESTING_OUTPUT_INIT();
+
+  // Quarter circle arc, sampled coarsely so that
+  // interpolation between the curve points is actually exercised.
+  vtkNew<vtkArcSource> arc;
+  double arcCenter[3] = { 40, 50, 60 };
+  arc->SetAngle(90);
+  arc->SetCenter(arcCenter);
+  arc->SetPolarVector(5, 15, -3);
+  arc->UseNormalAndAngleOn();
+  arc->SetResolution(30);
+  arc->Update();
+  double arcFirstPoint[3] = { 0,0,0 };
+  arc->GetOutput()->GetPoint(0, arcFirstPoint);
+  double radius = sqrt(vtkMath::Distance2BetweenPoints(arcCenter, arcFirstPoint));
+
+  vtkNew<vtkParallelTransportFrame> parallelTransportFrame;
+  double preferredNormalDirection[3] = { arcCenter[0] - arcFirstPoint[0], arcCenter[1] - arcFirstPoint[1], arcCenter[2] - arcFirstPoint[2] };
+  parallelTransportFrame->SetPreferredInitialNormalVector(preferredNormalDirection);
+  parallelTransportFrame->SetInputConnection(arc->GetOutputPort());
+  parallelTransportFrame->Update();
+
+  vtkNew<vtkParallelTransportFrameQuery> query;
+
+  // Query must be built before use
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  double dummy[3] = { 0.0, 0.0, 0.0 };
+  CHECK_BOOL(query->GetFrame(0.0, dummy, nullptr, nullptr, nullptr), false);
+  CHECK_BOOL(query->Build(parallelTransportFrame->GetOutput(), 1), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  CHECK_BOOL(query->Build(parallelTransportFrame->GetOutput()), true);
+  CHECK_INT(query->GetNumberOfCurvePoints(), 31);
+  // Length of the polyline is slightly shorter than the length of the arc
+  double curveLength = query->GetCurveLength();
+  CHECK_DOUBLE_TOLERANCE(curveLength, radius * vtkMath::Pi() / 2.0, 1e-3 * radius);
+
+  // Interpolated frames are orthonormal and follow the arc.
+  // Binormal is the normal of the arc's plane, which is constant.
+  double planeNormal[3] = { 0.0, 0.0, 0.0 };
+  query->GetFrame(0.0, nullptr, nullptr, planeNormal, nullptr);
+  const int numberOfSamples = 500;
+  vtkNew<vtkDoubleArray> arcLengths;
+  arcLengths->SetNumberOfTuples(numberOfSamples);
+  for (int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++)
+    {
+    double arcLength = curveLength * sampleIndex / (numberOfSamples - 1);
+    arcLengths->SetValue(sampleIndex, arcLength);
+
+    double position[3] = { 0.0, 0.0, 0.0 };
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    double binormal[3] = { 0.0, 0.0, 0.0 };
+    double tangent[3] = { 0.0, 0.0, 0.0 };
+    CHECK_BOOL(query->GetFrame(arcLength, position, normal, binormal, tangent), true);
+
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(normal), 1.0, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(binormal), 1.0, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(tangent), 1.0, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(normal, binormal), 0.0, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(normal, tangent), 0.0, 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(binormal, tangent), 0.0, 1e-9);
+
+    // Position is on the polyline, so it is within the chord height from the arc
+    double distanceFromCenter = sqrt(vtkMath::Distance2BetweenPoints(position, arcCenter));
+    CHECK_DOUBLE_TOLERANCE(distanceFromCenter, radius, 2e-3 * radius);
+
+    // Normal points towards the center
+    double radialDirection[3] = { arcCenter[0] - position[0], arcCenter[1] - position[1], arcCenter[2] - position[2] };
+    vtkMath::Normalize(radialDirection);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(normal, radialDirection), 1.0, 5e-3);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(binormal, planeNormal), 1.0, 1e-9);
+    }
+
+  // Matrix output has the same axes
+  {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    double binormal[3] = { 0.0, 0.0, 0.0 };
+    double tangent[3] = { 0.0, 0.0, 0.0 };
+    double arcLength = curveLength * 0.37;
+    query->GetFrame(arcLength, position, normal, binormal, tangent);
+    vtkNew<vtkMatrix4x4> frame;
+    CHECK_BOOL(query->GetFrame(arcLength, frame), true);
+    for (int i = 0; i < 3; i++)
+      {
+      CHECK_DOUBLE_TOLERANCE(frame->GetElement(i, 0), normal[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(frame->GetElement(i, 1), binormal[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(frame->GetElement(i, 2), tangent[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(frame->GetElement(i, 3), position[i], 1e-12);
+      }
+  }
+
+  // Arc length is clamped to the curve
+  {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    query->GetFrame(-10.0, position, nullptr, nullptr, nullptr);
+    for (int i = 0; i < 3; i++)
+      {
+      CHECK_DOUBLE_TOLERANCE(position[i], arcFirstPoint[i], 1e-9);
+      }
+    double lastPoint[3] = { 0.0, 0.0, 0.0 };
+    arc->GetOutput()->GetPoint(arc->GetOutput()->GetNumberOfPoints() - 1, lastPoint);
+    query->GetFrame(curveLength + 10.0, position, nullptr, nullptr, nullptr);
+    for (int i = 0; i < 3; i++)
+      {
+      CHECK_DOUBLE_TOLERANCE(position[i], lastPoint[i], 1e-9);
+      }
+  }
+
+  // Batch query gives the same result as individual queries
+  vtkNew<vtkDoubleArray> positions;
+  vtkNew<vtkDoubleArray> normals;
+  vtkNew<vtkDoubleArray> binormals;
+  vtkNew<vtkDoubleArray> tangents;
+  CHECK_BOOL(query->GetFrames(arcLengths, positions, normals, binormals, tangents), true);
+  CHECK_INT(positions->GetNumberOfTuples(), numberOfSamples);
+  CHECK_INT(tangents->GetNumberOfComponents(), 3);
+  for (int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    double binormal[3] = { 0.0, 0.0, 0.0 };
+    double tangent[3] = { 0.0, 0.0, 0.0 };
+    query->GetFrame(arcLengths->GetValue(sampleIndex), position, normal, binormal, tangent);
+    for (int i = 0; i < 3; i++)
+      {
+      CHECK_DOUBLE_TOLERANCE(positions->GetComponent(sampleIndex, i), position[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(normals->GetComponent(sampleIndex, i), normal[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(binormals->GetComponent(sampleIndex, i), binormal[i], 1e-12);
+      CHECK_DOUBLE_TOLERANCE(tangents->GetComponent(sampleIndex, i), tangent[i], 1e-12);
+      }
+    }
+
+  // Query built from compact frame formats gives the same frames (within float precision)
+  int outputFormats[2] = { vtkParallelTransportFrame::OUTPUT_FORMAT_QUATERNION, vtkParallelTransportFrame::OUTPUT_FORMAT_PACKED_FRAME };
+  for (int outputFormat : outputFormats)
+    {
+    parallelTransportFrame->SetOutputFormat(outputFormat);
+    parallelTransportFrame->Update();
+    vtkNew<vtkParallelTransportFrameQuery> compactQuery;
+    CHECK_BOOL(compactQuery->Build(parallelTransportFrame->GetOutput()), true);
+    vtkNew<vtkDoubleArray> compactNormals;
+    vtkNew<vtkDoubleArray> compactTangents;
+    CHECK_BOOL(compactQuery->GetFrames(arcLengths, nullptr, compactNormals, nullptr, compactTangents), true);
+    for (int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++)
+      {
+      for (int i = 0; i < 3; i++)
+        {
+        CHECK_DOUBLE_TOLERANCE(compactNormals->GetComponent(sampleIndex, i), normals->GetComponent(sampleIndex, i), 1e-5);
+        CHECK_DOUBLE_TOLERANCE(compactTangents->GetComponent(sampleIndex, i), tangents->GetComponent(sampleIndex, i), 1e-5);
+        }
+      }
+    }
+
+  // Frames are not computed for a cell with less than 3 points, therefore the query cannot be built from it
+  vtkNew<vtkPolyData> shortCurve;
+  vtkNew<vtkPoints> shortCurvePoints;
+  shortCurvePoints->InsertNextPoint(0.0, 0.0, 0.0);
+  shortCurvePoints->InsertNextPoint(10.0, 0.0, 0.0);
+  vtkNew<vtkCellArray> shortCurveLines;
+  vtkIdType shortCurvePointIds[2] = { 0, 1 };
+  shortCurveLines->InsertNextCell(2, shortCurvePointIds);
+  shortCurve->SetPoints(shortCurvePoints);
+  shortCurve->SetLines(shortCurveLines);
+  parallelTransportFrame->SetInputData(shortCurve);
+  int shortCurveOutputFormats[3] = { vtkParallelTransportFrame::OUTPUT_FORMAT_AXIS_VECTORS,
+    vtkParallelTransportFrame::OUTPUT_FORMAT_QUATERNION, vtkParallelTransportFrame::OUTPUT_FORMAT_PACKED_FRAME };
+  for (int outputFormat : shortCurveOutputFormats)
+    {
+    parallelTransportFrame->SetOutputFormat(outputFormat);
+    parallelTransportFrame->Update();
+    vtkNew<vtkParallelTransportFrameQuery> shortCurveQuery;
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_BOOL(shortCurveQuery->Build(parallelTransportFrame->GetOutput()), false);
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(shortCurveQuery->GetNumberOfCurvePoints(), 0);
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
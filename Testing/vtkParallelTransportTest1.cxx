@@ -21,13 +21,21 @@
 
 // VTK includes
 #include <vtkArcSource.h>
+#include <vtkCellArray.h>
 #include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
 #include <vtkLineSource.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 
 // STD includes
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 //----------------------------------------------------------------------------
 int vtkParallelTransportTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -137,6 +145,340 @@ int vtkParallelTransportTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
       }
   }
 
+  // Test double reflection algorithm.
+  // For uniformly sampled curves the frames must be the same as the ones computed by the rotation algorithm.
+
+  {
+    vtkNew<vtkParallelTransportFrame> doubleReflectionFrame;
+    doubleReflectionFrame->SetAlgorithm(vtkParallelTransportFrame::GetAlgorithmFromString("doubleReflection"));
+    CHECK_INT(doubleReflectionFrame->GetAlgorithm(), vtkParallelTransportFrame::ALGORITHM_DOUBLE_REFLECTION);
+    CHECK_STRING(vtkParallelTransportFrame::GetAlgorithmAsString(vtkParallelTransportFrame::ALGORITHM_ROTATION), "rotation");
+    doubleReflectionFrame->SetPreferredInitialNormalVector(preferredNormalDirection);
+    doubleReflectionFrame->SetInputConnection(arc->GetOutputPort());
+    doubleReflectionFrame->Update();
+    vtkPointData* pointData = doubleReflectionFrame->GetOutput()->GetPointData();
+    vtkPointData* expectedPointData = parallelTransportFrame->GetOutput()->GetPointData();
+    const char* arrayNames[3] = { "Normals", "Binormals", "Tangents" };
+    for (int arrayIndex = 0; arrayIndex < 3; arrayIndex++)
+      {
+      vtkDataArray* array = pointData->GetArray(arrayNames[arrayIndex]);
+      vtkDataArray* expectedArray = expectedPointData->GetArray(arrayNames[arrayIndex]);
+      CHECK_NOT_NULL(array);
+      for (vtkIdType tupleIndex = 0; tupleIndex < array->GetNumberOfTuples(); tupleIndex++)
+        {
+        double expected[3] = { 0.0, 0.0, 0.0 };
+        expectedArray->GetTuple(tupleIndex, expected);
+        double actual[3] = { 0.0, 0.0, 0.0 };
+        array->GetTuple(tupleIndex, actual);
+        CHECK_DOUBLE_TOLERANCE(actual[0], expected[0], 1e-6);
+        CHECK_DOUBLE_TOLERANCE(actual[1], expected[1], 1e-6);
+        CHECK_DOUBLE_TOLERANCE(actual[2], expected[2], 1e-6);
+        }
+      }
+  }
+
+  // Test with multiple cells, which are processed in parallel.
+  // Frames must be the same as if each cell was processed separately.
+  // The first point is shared by all cells, its frame must be computed from the last cell.
+
+  {
+    const int numberOfCells = 50;
+    const int numberOfPointsPerCell = 100;
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> lines;
+    points->InsertNextPoint(0.0, 0.0, 0.0);
+    for (int cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+      {
+      lines->InsertNextCell(numberOfPointsPerCell);
+      lines->InsertCellPoint(0);
+      for (int i = 1; i < numberOfPointsPerCell; i++)
+        {
+        lines->InsertCellPoint(points->InsertNextPoint(i,
+          3.0 * sin(0.1 * i + cellIndex), 3.0 * cos(0.15 * i + 0.5 * cellIndex)));
+        }
+      }
+    vtkNew<vtkPolyData> curves;
+    curves->SetPoints(points);
+    curves->SetLines(lines);
+    vtkNew<vtkParallelTransportFrame> curvesFrame;
+    curvesFrame->SetInputData(curves);
+    curvesFrame->Update();
+    vtkPointData* pointData = curvesFrame->GetOutput()->GetPointData();
+    vtkDoubleArray* normalsArray = vtkDoubleArray::SafeDownCast(pointData->GetArray("Normals"));
+    vtkDoubleArray* binormalsArray = vtkDoubleArray::SafeDownCast(pointData->GetArray("Binormals"));
+    vtkDoubleArray* tangentsArray = vtkDoubleArray::SafeDownCast(pointData->GetArray("Tangents"));
+
+    for (int cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+      {
+      vtkNew<vtkPoints> cellPoints;
+      vtkNew<vtkCellArray> cellLines;
+      cellLines->InsertNextCell(numberOfPointsPerCell);
+      for (int i = 0; i < numberOfPointsPerCell; i++)
+        {
+        vtkIdType pointId = (i == 0 ? 0 : 1 + cellIndex * (numberOfPointsPerCell - 1) + i - 1);
+        cellLines->InsertCellPoint(cellPoints->InsertNextPoint(points->GetPoint(pointId)));
+        }
+      vtkNew<vtkPolyData> curve;
+      curve->SetPoints(cellPoints);
+      curve->SetLines(cellLines);
+      vtkNew<vtkParallelTransportFrame> curveFrame;
+      curveFrame->SetInputData(curve);
+      curveFrame->Update();
+      vtkPointData* curvePointData = curveFrame->GetOutput()->GetPointData();
+      vtkDataArray* curveArrays[3] = { curvePointData->GetArray("Normals"), curvePointData->GetArray("Binormals"), curvePointData->GetArray("Tangents") };
+      vtkDataArray* curvesArrays[3] = { normalsArray, binormalsArray, tangentsArray };
+      // The shared first point is compared for the last cell only
+      for (int i = (cellIndex == numberOfCells - 1 ? 0 : 1); i < numberOfPointsPerCell; i++)
+        {
+        vtkIdType pointId = (i == 0 ? 0 : 1 + cellIndex * (numberOfPointsPerCell - 1) + i - 1);
+        for (int arrayIndex = 0; arrayIndex < 3; arrayIndex++)
+          {
+          double expected[3] = { 0.0, 0.0, 0.0 };
+          curveArrays[arrayIndex]->GetTuple(i, expected);
+          double actual[3] = { 0.0, 0.0, 0.0 };
+          curvesArrays[arrayIndex]->GetTuple(pointId, actual);
+          CHECK_DOUBLE_TOLERANCE(actual[0], expected[0], 1e-9);
+          CHECK_DOUBLE_TOLERANCE(actual[1], expected[1], 1e-9);
+          CHECK_DOUBLE_TOLERANCE(actual[2], expected[2], 1e-9);
+          }
+        }
+      }
+
+    // Output geometry must be shared with the input
+    CHECK_POINTER(curvesFrame->GetOutput()->GetPoints(), curves->GetPoints());
+
+    // Compact output formats must contain the same frames
+    vtkNew<vtkParallelTransportFrame> quaternionFrame;
+    quaternionFrame->SetOutputFormat(vtkParallelTransportFrame::GetOutputFormatFromString("quaternion"));
+    CHECK_INT(quaternionFrame->GetOutputFormat(), vtkParallelTransportFrame::OUTPUT_FORMAT_QUATERNION);
+    quaternionFrame->SetInputData(curves);
+    quaternionFrame->Update();
+    CHECK_NULL(quaternionFrame->GetOutput()->GetPointData()->GetArray("Normals"));
+    vtkFloatArray* quaternionsArray = vtkFloatArray::SafeDownCast(quaternionFrame->GetOutput()->GetPointData()->GetArray("Frames"));
+    CHECK_NOT_NULL(quaternionsArray);
+    CHECK_INT(quaternionsArray->GetNumberOfComponents(), 4);
+
+    vtkNew<vtkParallelTransportFrame> packedFrame;
+    packedFrame->SetOutputFormat(vtkParallelTransportFrame::OUTPUT_FORMAT_PACKED_FRAME);
+    packedFrame->SetFramesArrayName("PackedFrames");
+    packedFrame->SetInputData(curves);
+    packedFrame->Update();
+    vtkFloatArray* packedFramesArray = vtkFloatArray::SafeDownCast(packedFrame->GetOutput()->GetPointData()->GetArray("PackedFrames"));
+    CHECK_NOT_NULL(packedFramesArray);
+    CHECK_INT(packedFramesArray->GetNumberOfComponents(), 9);
+
+    for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); pointId++)
+      {
+      double quaternion[4] = { 0.0, 0.0, 0.0, 0.0 };
+      quaternionsArray->GetTuple(pointId, quaternion);
+      double rotation[3][3] = { { 0.0 } };
+      vtkMath::QuaternionToMatrix3x3(quaternion, rotation);
+      double packedFrameAxes[9] = { 0.0 };
+      packedFramesArray->GetTuple(pointId, packedFrameAxes);
+      vtkDataArray* expectedArrays[3] = { normalsArray, binormalsArray, tangentsArray };
+      for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+        {
+        double expected[3] = { 0.0, 0.0, 0.0 };
+        expectedArrays[axisIndex]->GetTuple(pointId, expected);
+        for (int i = 0; i < 3; i++)
+          {
+          CHECK_DOUBLE_TOLERANCE(rotation[i][axisIndex], expected[i], 1e-5);
+          CHECK_DOUBLE_TOLERANCE(packedFrameAxes[axisIndex * 3 + i], expected[i], 1e-6);
+          }
+        }
+      }
+
+    // Double reflection algorithm must give orthonormal frames that are close to the ones computed by rotation.
+    // Points are not sampled uniformly, therefore the frames are not exactly the same, but the difference
+    // is within the discretization error of the curve (which is about 0.1 for these curves).
+    vtkNew<vtkParallelTransportFrame> doubleReflectionFrame;
+    doubleReflectionFrame->SetAlgorithm(vtkParallelTransportFrame::ALGORITHM_DOUBLE_REFLECTION);
+    doubleReflectionFrame->SetInputData(curves);
+    doubleReflectionFrame->Update();
+    vtkPointData* doubleReflectionPointData = doubleReflectionFrame->GetOutput()->GetPointData();
+    vtkDataArray* doubleReflectionNormalsArray = doubleReflectionPointData->GetArray("Normals");
+    vtkDataArray* doubleReflectionBinormalsArray = doubleReflectionPointData->GetArray("Binormals");
+    vtkDataArray* doubleReflectionTangentsArray = doubleReflectionPointData->GetArray("Tangents");
+    double maximumNormalDifference = 0.0;
+    for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); pointId++)
+      {
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      doubleReflectionNormalsArray->GetTuple(pointId, normal);
+      double binormal[3] = { 0.0, 0.0, 0.0 };
+      doubleReflectionBinormalsArray->GetTuple(pointId, binormal);
+      double tangent[3] = { 0.0, 0.0, 0.0 };
+      doubleReflectionTangentsArray->GetTuple(pointId, tangent);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(normal), 1.0, 1e-9);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(binormal), 1.0, 1e-9);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(normal, tangent), 0.0, 1e-9);
+      double expectedTangent[3] = { 0.0, 0.0, 0.0 };
+      tangentsArray->GetTuple(pointId, expectedTangent);
+      CHECK_DOUBLE_TOLERANCE(tangent[0], expectedTangent[0], 1e-9);
+      CHECK_DOUBLE_TOLERANCE(tangent[1], expectedTangent[1], 1e-9);
+      CHECK_DOUBLE_TOLERANCE(tangent[2], expectedTangent[2], 1e-9);
+      double expectedNormal[3] = { 0.0, 0.0, 0.0 };
+      normalsArray->GetTuple(pointId, expectedNormal);
+      maximumNormalDifference = std::max(maximumNormalDifference,
+        sqrt(vtkMath::Distance2BetweenPoints(normal, expectedNormal)));
+      }
+    if (verbose)
+      {
+      std::cout << "Maximum normal difference between double reflection and rotation: " << maximumNormalDifference << std::endl;
+      }
+    CHECK_BOOL(maximumNormalDifference < 0.05, true);
+
+    // Points that are stored in double precision must give the same frames
+    vtkSmartPointer<vtkDataArray> floatNormalsArray = normalsArray;
+    vtkNew<vtkPoints> doublePoints;
+    doublePoints->SetDataTypeToDouble();
+    for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); pointId++)
+      {
+      doublePoints->InsertNextPoint(points->GetPoint(pointId));
+      }
+    curves->SetPoints(doublePoints);
+    curvesFrame->Update();
+    vtkDataArray* doubleNormalsArray = curvesFrame->GetOutput()->GetPointData()->GetArray("Normals");
+    CHECK_NOT_NULL(doubleNormalsArray);
+    for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); pointId++)
+      {
+      double expected[3] = { 0.0, 0.0, 0.0 };
+      floatNormalsArray->GetTuple(pointId, expected);
+      double actual[3] = { 0.0, 0.0, 0.0 };
+      doubleNormalsArray->GetTuple(pointId, actual);
+      CHECK_DOUBLE_TOLERANCE(actual[0], expected[0], 1e-9);
+      CHECK_DOUBLE_TOLERANCE(actual[1], expected[1], 1e-9);
+      CHECK_DOUBLE_TOLERANCE(actual[2], expected[2], 1e-9);
+      }
+  }
+
+  // Test incremental computation with two polylines that are extended by appending points.
+  // Frames must be the same as the ones computed from scratch, but frames of existing points must not be recomputed.
+
+  int algorithms[2] = { vtkParallelTransportFrame::ALGORITHM_ROTATION, vtkParallelTransportFrame::ALGORITHM_DOUBLE_REFLECTION };
+  for (int algorithm : algorithms)
+  {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkPolyData> curves;
+    std::vector<std::vector<vtkIdType>> curvePointIds(2);
+    auto appendPoints = [&](int numberOfPointsToAppend)
+      {
+      for (int i = 0; i < numberOfPointsToAppend; i++)
+        {
+        for (int curveIndex = 0; curveIndex < 2; curveIndex++)
+          {
+          double t = 0.1 * curvePointIds[curveIndex].size();
+          curvePointIds[curveIndex].push_back(points->InsertNextPoint(
+            5.0 * cos(t) + 20.0 * curveIndex, 5.0 * sin(t), 2.0 * t));
+          }
+        }
+      vtkNew<vtkCellArray> lines;
+      for (int curveIndex = 0; curveIndex < 2; curveIndex++)
+        {
+        lines->InsertNextCell(static_cast<vtkIdType>(curvePointIds[curveIndex].size()), curvePointIds[curveIndex].data());
+        }
+      points->Modified();
+      curves->SetPoints(points);
+      curves->SetLines(lines);
+      };
+
+    vtkNew<vtkParallelTransportFrame> incrementalFrame;
+    incrementalFrame->IncrementalOn();
+    incrementalFrame->SetAlgorithm(algorithm);
+    incrementalFrame->SetInputData(curves);
+    vtkNew<vtkParallelTransportFrame> referenceFrame;
+    referenceFrame->SetAlgorithm(algorithm);
+    referenceFrame->SetInputData(curves);
+
+    auto checkFrames = [&]()
+      {
+      incrementalFrame->Update();
+      referenceFrame->Update();
+      const char* arrayNames[3] = { "Normals", "Binormals", "Tangents" };
+      for (int arrayIndex = 0; arrayIndex < 3; arrayIndex++)
+        {
+        vtkDataArray* array = incrementalFrame->GetOutput()->GetPointData()->GetArray(arrayNames[arrayIndex]);
+        vtkDataArray* expectedArray = referenceFrame->GetOutput()->GetPointData()->GetArray(arrayNames[arrayIndex]);
+        CHECK_NOT_NULL(array);
+        CHECK_INT(array->GetNumberOfTuples(), points->GetNumberOfPoints());
+        for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); pointId++)
+          {
+          double expected[3] = { 0.0, 0.0, 0.0 };
+          expectedArray->GetTuple(pointId, expected);
+          double actual[3] = { 0.0, 0.0, 0.0 };
+          array->GetTuple(pointId, actual);
+          CHECK_DOUBLE_TOLERANCE(actual[0], expected[0], 1e-12);
+          CHECK_DOUBLE_TOLERANCE(actual[1], expected[1], 1e-12);
+          CHECK_DOUBLE_TOLERANCE(actual[2], expected[2], 1e-12);
+          }
+        }
+      return EXIT_SUCCESS;
+      };
+
+    // Polylines start with two points (not processed), then grow by a few points at a time
+    appendPoints(2);
+    CHECK_EXIT_SUCCESS(checkFrames());
+    // Reference is kept so that a recreated array cannot get the same address
+    vtkSmartPointer<vtkDataArray> incrementalNormals;
+    auto getNormals = [&]() { return incrementalFrame->GetOutput()->GetPointData()->GetArray("Normals"); };
+    for (int step = 0; step < 10; step++)
+      {
+      appendPoints(1 + step % 3);
+      CHECK_EXIT_SUCCESS(checkFrames());
+      if (step > 0)
+        {
+        // Frame arrays are extended, not recreated
+        CHECK_POINTER(getNormals(), incrementalNormals.GetPointer());
+        }
+      incrementalNormals = getNormals();
+      }
+
+    // Only frames of the appended points (and the previous last point) are computed: a marker value
+    // written to the frame of an existing point is kept.
+    vtkIdType markedPointId = curvePointIds[1][3];
+    double markedNormal[3] = { 0.0, 0.0, 0.0 };
+    incrementalNormals->GetTuple(markedPointId, markedNormal);
+    incrementalNormals->SetTuple3(markedPointId, 7.0, 8.0, 9.0);
+    appendPoints(1);
+    incrementalFrame->Update();
+    CHECK_POINTER(getNormals(), incrementalNormals.GetPointer());
+    CHECK_DOUBLE(incrementalNormals->GetComponent(markedPointId, 0), 7.0);
+    CHECK_DOUBLE(incrementalNormals->GetComponent(markedPointId, 2), 9.0);
+    incrementalNormals->SetTuple(markedPointId, markedNormal);
+    CHECK_EXIT_SUCCESS(checkFrames());
+
+    // Update without changes
+    curves->Modified();
+    CHECK_EXIT_SUCCESS(checkFrames());
+    CHECK_POINTER(getNormals(), incrementalNormals.GetPointer());
+
+    // Moving the last point is detected and frames are recomputed
+    double lastPoint[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(curvePointIds[0].back(), lastPoint);
+    lastPoint[2] += 1.0;
+    points->SetPoint(curvePointIds[0].back(), lastPoint);
+    points->Modified();
+    appendPoints(2);
+    CHECK_EXIT_SUCCESS(checkFrames());
+    CHECK_POINTER_DIFFERENT(getNormals(), incrementalNormals.GetPointer());
+
+    // Moving an intermediate point is detected and all frames are recomputed
+    incrementalNormals = getNormals();
+    double previousNormal[3] = { 0.0, 0.0, 0.0 };
+    vtkIdType movedPointId = curvePointIds[0][5];
+    incrementalFrame->GetOutput()->GetPointData()->GetArray("Normals")->GetTuple(movedPointId, previousNormal);
+    double movedPoint[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(movedPointId, movedPoint);
+    movedPoint[0] += 1.0;
+    points->SetPoint(movedPointId, movedPoint);
+    points->Modified();
+    appendPoints(1);
+    CHECK_EXIT_SUCCESS(checkFrames());
+    CHECK_POINTER_DIFFERENT(getNormals(), incrementalNormals.GetPointer());
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    incrementalFrame->GetOutput()->GetPointData()->GetArray("Normals")->GetTuple(movedPointId, normal);
+    CHECK_BOOL(vtkMath::Distance2BetweenPoints(normal, previousNormal) > 1e-6, true);
+  }
+
   std::cout << "Test succeeded." << std::endl;
   return EXIT_SUCCESS;
 }
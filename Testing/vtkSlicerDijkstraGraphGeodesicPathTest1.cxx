@@ -0,0 +1,398 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkSlicerDijkstraGraph.h>
+#include <vtkSlicerDijkstraGraphGeodesicPath.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double GetCumulativeWeight(vtkSlicerDijkstraGraphGeodesicPath* pathFilter, vtkIdType vertex)
+{
+  vtkNew<vtkDoubleArray> weights;
+  pathFilter->GetCumulativeWeights(weights);
+  return weights->GetValue(vertex);
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerDijkstraGraphGeodesicPathTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  TESTING_OUTPUT_INIT();
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(sphere->GetOutput());
+  vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+
+  // Scalar weights that vary over the surface make the edge costs asymmetric
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Weights");
+  scalars->SetNumberOfValues(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    surface->GetPoint(pointIndex, point);
+    scalars->SetValue(pointIndex, static_cast<float>(1.0 + 0.5 * sin(point[0] * 0.2) * cos(point[2] * 0.1)));
+    }
+  surface->GetPointData()->SetScalars(scalars);
+
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> unidirectionalPath;
+  unidirectionalPath->SetInputData(surface);
+  unidirectionalPath->StopWhenEndReachedOn();
+  CHECK_INT(unidirectionalPath->GetSearchMode(), vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL);
+
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> bidirectionalPath;
+  bidirectionalPath->SetInputData(surface);
+  bidirectionalPath->StopWhenEndReachedOn();
+  bidirectionalPath->SetSearchMode(vtkSlicerDijkstraGraphGeodesicPath::GetSearchModeFromString("bidirectional"));
+  CHECK_INT(bidirectionalPath->GetSearchMode(), vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_BIDIRECTIONAL);
+
+  const int numberOfVertexPairs = 5;
+  vtkIdType vertexPairs[numberOfVertexPairs][2] =
+    {
+    { 0, 1 },
+    { 0, numberOfPoints - 1 },
+    { 5, numberOfPoints / 2 },
+    { 1500, 123 },
+    { 17, 17 },
+    };
+
+  for (int costFunctionType = 0; costFunctionType < vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_LAST; costFunctionType++)
+    {
+    unidirectionalPath->SetCostFunctionType(costFunctionType);
+    bidirectionalPath->SetCostFunctionType(costFunctionType);
+    for (int pairIndex = 0; pairIndex < numberOfVertexPairs; pairIndex++)
+      {
+      vtkIdType startVertex = vertexPairs[pairIndex][0];
+      vtkIdType endVertex = vertexPairs[pairIndex][1];
+      unidirectionalPath->SetStartVertex(startVertex);
+      unidirectionalPath->SetEndVertex(endVertex);
+      unidirectionalPath->Update();
+      bidirectionalPath->SetStartVertex(startVertex);
+      bidirectionalPath->SetEndVertex(endVertex);
+      bidirectionalPath->Update();
+
+      // Paths may differ where there are multiple shortest paths, but their cost must be the same
+      CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(bidirectionalPath, endVertex),
+        GetCumulativeWeight(unidirectionalPath, endVertex), 1e-6);
+
+      vtkIdList* pathIds = bidirectionalPath->GetIdList();
+      CHECK_INT(pathIds->GetId(0), endVertex);
+      CHECK_INT(pathIds->GetId(pathIds->GetNumberOfIds() - 1), startVertex);
+      CHECK_INT(bidirectionalPath->GetOutput()->GetNumberOfPoints(), pathIds->GetNumberOfIds());
+      }
+    }
+
+  // Bidirectional search cannot compute cumulative weights of all vertices, unidirectional search is used instead
+  bidirectionalPath->StopWhenEndReachedOff();
+  bidirectionalPath->SetStartVertex(0);
+  bidirectionalPath->SetEndVertex(1);
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  bidirectionalPath->Update();
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+  unidirectionalPath->StopWhenEndReachedOff();
+  unidirectionalPath->SetStartVertex(0);
+  unidirectionalPath->SetEndVertex(1);
+  unidirectionalPath->Update();
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(bidirectionalPath, numberOfPoints - 1),
+    GetCumulativeWeight(unidirectionalPath, numberOfPoints - 1), 1e-6);
+  unidirectionalPath->StopWhenEndReachedOn();
+
+  // Paths to multiple targets with a single search
+  vtkIdType startVertex = 5;
+  vtkNew<vtkIdList> targetVertices;
+  targetVertices->InsertNextId(numberOfPoints - 1);
+  targetVertices->InsertNextId(123);
+  targetVertices->InsertNextId(startVertex);
+  targetVertices->InsertNextId(numberOfPoints / 2);
+
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> multiTargetPath;
+  multiTargetPath->SetInputData(surface);
+  multiTargetPath->StopWhenEndReachedOn();
+  multiTargetPath->SetStartVertex(startVertex);
+  multiTargetPath->SetTargetVertices(targetVertices);
+  multiTargetPath->Update();
+
+  vtkPolyData* multiTargetOutput = multiTargetPath->GetOutput();
+  CHECK_INT(multiTargetOutput->GetNumberOfCells(), targetVertices->GetNumberOfIds());
+  CHECK_INT(multiTargetOutput->GetNumberOfPoints(), multiTargetPath->GetIdList()->GetNumberOfIds());
+  unidirectionalPath->SetCostFunctionType(multiTargetPath->GetCostFunctionType());
+  vtkIdType firstPathPointIndex = 0;
+  for (vtkIdType targetIndex = 0; targetIndex < targetVertices->GetNumberOfIds(); targetIndex++)
+    {
+    vtkIdType endVertex = targetVertices->GetId(targetIndex);
+    unidirectionalPath->SetStartVertex(startVertex);
+    unidirectionalPath->SetEndVertex(endVertex);
+    unidirectionalPath->Update();
+    CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(multiTargetPath, endVertex),
+      GetCumulativeWeight(unidirectionalPath, endVertex), 1e-6);
+
+    vtkIdType numberOfPathPoints = multiTargetOutput->GetLines()->GetCellSize(targetIndex);
+    CHECK_INT(numberOfPathPoints, unidirectionalPath->GetIdList()->GetNumberOfIds());
+    CHECK_INT(multiTargetPath->GetIdList()->GetId(firstPathPointIndex), endVertex);
+    CHECK_INT(multiTargetPath->GetIdList()->GetId(firstPathPointIndex + numberOfPathPoints - 1), startVertex);
+    firstPathPointIndex += numberOfPathPoints;
+    }
+
+  // Distance field
+  CHECK_INT(multiTargetPath->GetDistanceField()->GetNumberOfTuples(), 0);
+  multiTargetPath->ComputeDistanceFieldOn();
+  multiTargetPath->Update();
+  vtkDoubleArray* distanceField = multiTargetPath->GetDistanceField();
+  CHECK_STRING(distanceField->GetName(), "GeodesicDistance");
+  CHECK_INT(distanceField->GetNumberOfTuples(), numberOfPoints);
+  CHECK_DOUBLE(distanceField->GetValue(startVertex), 0.0);
+  unidirectionalPath->StopWhenEndReachedOff();
+  unidirectionalPath->Update();
+  vtkNew<vtkDoubleArray> expectedDistanceField;
+  unidirectionalPath->GetCumulativeWeights(expectedDistanceField);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(distanceField->GetValue(pointIndex), expectedDistanceField->GetValue(pointIndex), 1e-6);
+    CHECK_BOOL(distanceField->GetValue(pointIndex) > 0.0 || pointIndex == startVertex, true);
+    }
+
+  // Distance field limited to a maximum path cost only contains the vertices within that cost
+  const double maximumPathCost = 0.5 * distanceField->GetRange()[1];
+  multiTargetPath->SetMaximumPathCost(maximumPathCost);
+  multiTargetPath->Update();
+  vtkNew<vtkIdList> settledVertices;
+  multiTargetPath->GetSettledVertices(settledVertices);
+  vtkIdType numberOfVerticesWithinMaximumCost = 0;
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    if (expectedDistanceField->GetValue(pointIndex) <= maximumPathCost)
+      {
+      CHECK_DOUBLE_TOLERANCE(distanceField->GetValue(pointIndex), expectedDistanceField->GetValue(pointIndex), 1e-6);
+      numberOfVerticesWithinMaximumCost++;
+      }
+    else
+      {
+      CHECK_DOUBLE(distanceField->GetValue(pointIndex), -1.0);
+      }
+    }
+  CHECK_INT(settledVertices->GetNumberOfIds(), numberOfVerticesWithinMaximumCost);
+  CHECK_BOOL(numberOfVerticesWithinMaximumCost > 1 && numberOfVerticesWithinMaximumCost < numberOfPoints, true);
+  multiTargetPath->SetMaximumPathCost(VTK_DOUBLE_MAX);
+
+  // Parallel distance field computation gives the same distances and valid paths
+  multiTargetPath->ParallelDistanceFieldOn();
+  multiTargetPath->Update();
+  CHECK_INT(multiTargetPath->GetDistanceField()->GetNumberOfTuples(), numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(distanceField->GetValue(pointIndex), expectedDistanceField->GetValue(pointIndex), 1e-6);
+    }
+  CHECK_INT(multiTargetPath->GetOutput()->GetNumberOfLines(), targetVertices->GetNumberOfIds());
+  CHECK_INT(multiTargetPath->GetIdList()->GetId(multiTargetPath->GetIdList()->GetNumberOfIds() - 1), startVertex);
+  multiTargetPath->ParallelDistanceFieldOff();
+
+  // Scalars of any numeric type are used for computing edge costs
+  vtkNew<vtkPolyData> surfaceWithIntegerScalars;
+  surfaceWithIntegerScalars->DeepCopy(surface);
+  vtkNew<vtkUnsignedCharArray> integerScalars;
+  vtkNew<vtkFloatArray> floatScalars;
+  integerScalars->SetNumberOfValues(numberOfPoints);
+  floatScalars->SetNumberOfValues(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    integerScalars->SetValue(pointIndex, static_cast<unsigned char>(1 + pointIndex % 7));
+    floatScalars->SetValue(pointIndex, static_cast<float>(1 + pointIndex % 7));
+    }
+  surfaceWithIntegerScalars->GetPointData()->SetScalars(integerScalars);
+  surface->GetPointData()->SetScalars(floatScalars);
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> integerScalarsPath;
+  integerScalarsPath->SetInputData(surfaceWithIntegerScalars);
+  integerScalarsPath->StopWhenEndReachedOff();
+  integerScalarsPath->SetStartVertex(startVertex);
+  unidirectionalPath->SetStartVertex(startVertex);
+  for (int costFunctionType = 0; costFunctionType < vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_LAST; costFunctionType++)
+    {
+    unidirectionalPath->SetCostFunctionType(costFunctionType);
+    unidirectionalPath->Update();
+    integerScalarsPath->SetCostFunctionType(costFunctionType);
+    integerScalarsPath->Update();
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex += 97)
+      {
+      CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(integerScalarsPath, pointIndex),
+        GetCumulativeWeight(unidirectionalPath, pointIndex), 1e-6);
+      }
+    }
+
+  // Landmark-based (A*) search finds paths with the same cost as Dijkstra search
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> landmarkPath;
+  landmarkPath->SetInputData(surface);
+  landmarkPath->StopWhenEndReachedOn();
+  landmarkPath->SetNumberOfLandmarks(4);
+  unidirectionalPath->StopWhenEndReachedOn();
+  for (int costFunctionType = 0; costFunctionType < vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_LAST; costFunctionType++)
+    {
+    unidirectionalPath->SetCostFunctionType(costFunctionType);
+    landmarkPath->SetCostFunctionType(costFunctionType);
+    for (int pairIndex = 0; pairIndex < numberOfVertexPairs; pairIndex++)
+      {
+      vtkIdType endVertex = vertexPairs[pairIndex][1];
+      unidirectionalPath->SetStartVertex(vertexPairs[pairIndex][0]);
+      unidirectionalPath->SetEndVertex(endVertex);
+      unidirectionalPath->Update();
+      landmarkPath->SetStartVertex(vertexPairs[pairIndex][0]);
+      landmarkPath->SetEndVertex(endVertex);
+      landmarkPath->Update();
+      CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(landmarkPath, endVertex),
+        GetCumulativeWeight(unidirectionalPath, endVertex), 1e-6);
+      CHECK_INT(landmarkPath->GetIdList()->GetId(0), endVertex);
+      CHECK_INT(landmarkPath->GetIdList()->GetId(landmarkPath->GetIdList()->GetNumberOfIds() - 1), vertexPairs[pairIndex][0]);
+      }
+    }
+  vtkNew<vtkIdList> landmarkVertices;
+  landmarkPath->GetLandmarkVertices(landmarkVertices);
+  CHECK_INT(landmarkVertices->GetNumberOfIds(), 4);
+
+  // Landmark distances are updated when the mesh changes
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    floatScalars->SetValue(pointIndex, static_cast<float>(1 + pointIndex % 11));
+    }
+  floatScalars->Modified();
+  surface->Modified();
+  unidirectionalPath->SetStartVertex(0);
+  unidirectionalPath->SetEndVertex(numberOfPoints / 2);
+  unidirectionalPath->Update();
+  landmarkPath->SetStartVertex(0);
+  landmarkPath->SetEndVertex(numberOfPoints / 2);
+  landmarkPath->Update();
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(landmarkPath, numberOfPoints / 2),
+    GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2), 1e-6);
+
+  // Edge costs are updated only for the modified vertices, with the same result as a full rebuild
+  vtkNew<vtkIdList> modifiedVertices;
+  for (vtkIdType pointIndex = numberOfPoints / 4; pointIndex < numberOfPoints / 4 + 50; pointIndex++)
+    {
+    floatScalars->SetValue(pointIndex, 50.0f);
+    modifiedVertices->InsertNextId(pointIndex);
+    }
+  floatScalars->Modified();
+  unidirectionalPath->Update();
+  landmarkPath->SetModifiedVertices(modifiedVertices);
+  landmarkPath->Update();
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> rebuiltPath;
+  rebuiltPath->SetInputData(surface);
+  rebuiltPath->SetCostFunctionType(unidirectionalPath->GetCostFunctionType());
+  rebuiltPath->SetStartVertex(0);
+  rebuiltPath->SetEndVertex(numberOfPoints / 2);
+  rebuiltPath->Update();
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2),
+    GetCumulativeWeight(rebuiltPath, numberOfPoints / 2), 1e-6);
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(landmarkPath, numberOfPoints / 2),
+    GetCumulativeWeight(rebuiltPath, numberOfPoints / 2), 1e-6);
+
+  // Landmarks are kept if edge costs only increase. If edge costs decrease then landmarks are rebuilt,
+  // but only when a search uses them.
+  CHECK_INT(landmarkPath->GetGraph()->GetNumberOfLandmarks(), 4);
+  // Higher scalar weights decrease the edge costs with the inverse squared cost function
+  CHECK_INT(landmarkPath->GetCostFunctionType(), vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_INVERSE_SQUARED);
+  for (vtkIdType pointIndex = numberOfPoints / 4; pointIndex < numberOfPoints / 4 + 50; pointIndex++)
+    {
+    floatScalars->SetValue(pointIndex, 100.0f);
+    }
+  floatScalars->Modified();
+  landmarkPath->StopWhenEndReachedOff();
+  landmarkPath->Update();
+  CHECK_INT(landmarkPath->GetGraph()->GetNumberOfLandmarks(), 0);
+  landmarkPath->StopWhenEndReachedOn();
+  landmarkPath->Update();
+  CHECK_INT(landmarkPath->GetGraph()->GetNumberOfLandmarks(), 4);
+  unidirectionalPath->Update();
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(landmarkPath, numberOfPoints / 2),
+    GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2), 1e-6);
+
+  // Fast marching distances are not longer than the edge-based distances and paths are traced across the triangles
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> fastMarchingPath;
+  fastMarchingPath->SetInputData(surface);
+  fastMarchingPath->SetSearchMode(vtkSlicerDijkstraGraphGeodesicPath::GetSearchModeFromString("fastMarching"));
+  CHECK_INT(fastMarchingPath->GetSearchMode(), vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_FAST_MARCHING);
+  fastMarchingPath->UseScalarWeightsOff();
+  fastMarchingPath->StopWhenEndReachedOn();
+  fastMarchingPath->SetStartVertex(5);
+  fastMarchingPath->SetEndVertex(numberOfPoints / 2);
+  fastMarchingPath->Update();
+  vtkPolyData* fastMarchingOutput = fastMarchingPath->GetOutput();
+  CHECK_INT(fastMarchingOutput->GetNumberOfLines(), 1);
+  CHECK_BOOL(fastMarchingOutput->GetNumberOfPoints() > 2, true);
+  double fastMarchingPathLength = 0.0;
+  for (vtkIdType pointIndex = 1; pointIndex < fastMarchingOutput->GetNumberOfPoints(); pointIndex++)
+    {
+    double point0[3] = { 0.0, 0.0, 0.0 };
+    double point1[3] = { 0.0, 0.0, 0.0 };
+    fastMarchingOutput->GetPoint(pointIndex - 1, point0);
+    fastMarchingOutput->GetPoint(pointIndex, point1);
+    fastMarchingPathLength += sqrt(vtkMath::Distance2BetweenPoints(point0, point1));
+    }
+  double lastPathPoint[3] = { 0.0, 0.0, 0.0 };
+  double startPoint[3] = { 0.0, 0.0, 0.0 };
+  fastMarchingOutput->GetPoint(fastMarchingOutput->GetNumberOfPoints() - 1, lastPathPoint);
+  surface->GetPoint(5, startPoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(lastPathPoint, startPoint)), 0.0, 1e-9);
+  unidirectionalPath->UseScalarWeightsOff();
+  unidirectionalPath->SetStartVertex(5);
+  unidirectionalPath->SetEndVertex(numberOfPoints / 2);
+  unidirectionalPath->Update();
+  double fastMarchingDistance = GetCumulativeWeight(fastMarchingPath, numberOfPoints / 2);
+  CHECK_BOOL(fastMarchingDistance <= GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2), true);
+  CHECK_BOOL(fastMarchingPathLength < 1.05 * fastMarchingDistance, true);
+
+  // Graph is rebuilt if point coordinates are edited in place and only the mesh is marked as modified
+  double unscaledDistance = GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    surface->GetPoints()->GetPoint(pointIndex, point);
+    surface->GetPoints()->SetPoint(pointIndex, 2.0 * point[0], 2.0 * point[1], 2.0 * point[2]);
+    }
+  surface->Modified();
+  unidirectionalPath->Update();
+  CHECK_DOUBLE_TOLERANCE(GetCumulativeWeight(unidirectionalPath, numberOfPoints / 2), 2.0 * unscaledDistance, 1e-3);
+
+  std::cout << "Test succeeded." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,448 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include <vtkAddonTestingMacros.h>
+#include <vtkSlicerDijkstraGraph.h>
+#include <vtkSlicerDijkstraGraphGeodesicPath.h>
+#include <vtkSlicerDijkstraGraphQuery.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestLandmarksWithIsolatedFirstPoint()
+{
+  // Flat triangulated grid, with an additional point 0 that is not used by any triangle
+  const int gridSize = 11;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+  points->InsertNextPoint(-10.0, -10.0, 0.0);
+  for (int y = 0; y < gridSize; y++)
+    {
+    for (int x = 0; x < gridSize; x++)
+      {
+      points->InsertNextPoint(x, y, 0.0);
+      if (x > 0 && y > 0)
+        {
+        vtkIdType p11 = 1 + y * gridSize + x;
+        vtkIdType p00 = p11 - gridSize - 1;
+        vtkIdType triangle1[3] = { p00, p00 + 1, p11 };
+        vtkIdType triangle2[3] = { p00, p11, p11 - 1 };
+        polys->InsertNextCell(3, triangle1);
+        polys->InsertNextCell(3, triangle2);
+        }
+      }
+    }
+  vtkNew<vtkPolyData> grid;
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+  vtkIdType numberOfPoints = grid->GetNumberOfPoints();
+
+  vtkNew<vtkSlicerDijkstraGraph> graph;
+  graph->Build(grid, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  graph->BuildLandmarks(3);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 3);
+  vtkNew<vtkIdList> landmarks;
+  graph->GetLandmarkVertices(landmarks);
+  CHECK_INT(landmarks->GetNumberOfIds(), 3);
+  CHECK_INT(landmarks->IsId(0), -1);
+
+  vtkNew<vtkSlicerDijkstraGraphQuery> query;
+  query->SetGraph(graph);
+  CHECK_BOOL(query->FindShortestPath(1, numberOfPoints - 1,
+    vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL), true);
+  double lowerBound = graph->GetLandmarkLowerBound(1, numberOfPoints - 1);
+  CHECK_BOOL(lowerBound > 0.0 && lowerBound <= query->GetCumulativeWeight(numberOfPoints - 1) + 1e-6, true);
+
+  // No landmarks can be selected if there are no edges
+  vtkNew<vtkCellArray> noPolys;
+  vtkNew<vtkPolyData> pointsOnly;
+  pointsOnly->SetPoints(points);
+  pointsOnly->SetPolys(noPolys);
+  graph->Build(pointsOnly, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  graph->BuildLandmarks(3);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 0);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestFastMarching()
+{
+  // Flat triangulated grid, where the geodesic distance is the Euclidean distance
+  const int gridSize = 31;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+  for (int y = 0; y < gridSize; y++)
+    {
+    for (int x = 0; x < gridSize; x++)
+      {
+      points->InsertNextPoint(x, y, 0.0);
+      if (x > 0 && y > 0)
+        {
+        vtkIdType p11 = y * gridSize + x;
+        vtkIdType p00 = p11 - gridSize - 1;
+        vtkIdType triangle1[3] = { p00, p00 + 1, p11 };
+        vtkIdType triangle2[3] = { p00, p11, p11 - 1 };
+        polys->InsertNextCell(3, triangle1);
+        polys->InsertNextCell(3, triangle2);
+        }
+      }
+    }
+  vtkNew<vtkPolyData> grid;
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+
+  vtkNew<vtkSlicerDijkstraGraph> graph;
+  graph->Build(grid, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  vtkNew<vtkSlicerDijkstraGraphQuery> query;
+  query->SetGraph(graph);
+  // Triangles have to be built for fast marching
+  CHECK_INT(graph->GetNumberOfTriangles(), 0);
+  graph->BuildTriangles(grid);
+  CHECK_INT(graph->GetNumberOfTriangles(), 2 * (gridSize - 1) * (gridSize - 1));
+
+  const vtkIdType sourceVertex = (gridSize / 2) * gridSize + gridSize / 4;
+  double sourcePoint[3] = { 0.0, 0.0, 0.0 };
+  grid->GetPoint(sourceVertex, sourcePoint);
+  vtkNew<vtkSlicerDijkstraGraphQuery> dijkstraQuery;
+  dijkstraQuery->SetGraph(graph);
+  dijkstraQuery->ComputeDistanceField(sourceVertex);
+  query->ComputeFastMarchingDistanceField(sourceVertex);
+  double maximumFastMarchingError = 0.0;
+  double maximumDijkstraError = 0.0;
+  for (vtkIdType pointIndex = 0; pointIndex < grid->GetNumberOfPoints(); pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    grid->GetPoint(pointIndex, point);
+    double distance = sqrt(vtkMath::Distance2BetweenPoints(point, sourcePoint));
+    maximumFastMarchingError = std::max(maximumFastMarchingError, std::abs(query->GetCumulativeWeight(pointIndex) - distance));
+    maximumDijkstraError = std::max(maximumDijkstraError, std::abs(dijkstraQuery->GetCumulativeWeight(pointIndex) - distance));
+    }
+  CHECK_BOOL(maximumFastMarchingError < 0.1, true);
+  CHECK_BOOL(maximumFastMarchingError < 0.1 * maximumDijkstraError, true);
+
+  // Path traced along the gradient is a straight line to the source
+  const vtkIdType endVertex = (gridSize - 1) * gridSize + gridSize - 3;
+  double endPoint[3] = { 0.0, 0.0, 0.0 };
+  grid->GetPoint(endVertex, endPoint);
+  vtkNew<vtkPoints> pathPoints;
+  CHECK_BOOL(query->GetFastMarchingPath(endVertex, pathPoints), true);
+  CHECK_BOOL(pathPoints->GetNumberOfPoints() > 2, true);
+  double pathLength = 0.0;
+  double maximumDistanceFromLine = 0.0;
+  for (vtkIdType pointIndex = 0; pointIndex < pathPoints->GetNumberOfPoints(); pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    pathPoints->GetPoint(pointIndex, point);
+    if (pointIndex > 0)
+      {
+      double previousPoint[3] = { 0.0, 0.0, 0.0 };
+      pathPoints->GetPoint(pointIndex - 1, previousPoint);
+      pathLength += sqrt(vtkMath::Distance2BetweenPoints(point, previousPoint));
+      }
+    // distance from the line in the xy plane
+    double lineDirection[2] = { endPoint[0] - sourcePoint[0], endPoint[1] - sourcePoint[1] };
+    double lineLength = sqrt(lineDirection[0] * lineDirection[0] + lineDirection[1] * lineDirection[1]);
+    double distanceFromLine = std::abs(lineDirection[0] * (point[1] - sourcePoint[1])
+      - lineDirection[1] * (point[0] - sourcePoint[0])) / lineLength;
+    maximumDistanceFromLine = std::max(maximumDistanceFromLine, distanceFromLine);
+    }
+  double lastPoint[3] = { 0.0, 0.0, 0.0 };
+  pathPoints->GetPoint(pathPoints->GetNumberOfPoints() - 1, lastPoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(lastPoint, sourcePoint)), 0.0, 1e-9);
+  double straightDistance = sqrt(vtkMath::Distance2BetweenPoints(endPoint, sourcePoint));
+  CHECK_BOOL(pathLength < straightDistance * 1.01, true);
+  CHECK_BOOL(maximumDistanceFromLine < 0.5, true);
+
+  // Search stops after the end vertex is reached, but the path is still complete
+  vtkNew<vtkIdList> endVertices;
+  endVertices->InsertNextId(endVertex);
+  vtkNew<vtkSlicerDijkstraGraphQuery> stoppedQuery;
+  stoppedQuery->SetGraph(graph);
+  stoppedQuery->ComputeFastMarchingDistanceField(sourceVertex, endVertices);
+  vtkNew<vtkIdList> settledVertices;
+  stoppedQuery->GetSettledVertices(settledVertices);
+  CHECK_BOOL(settledVertices->GetNumberOfIds() < grid->GetNumberOfPoints(), true);
+  vtkNew<vtkPoints> stoppedPathPoints;
+  CHECK_BOOL(stoppedQuery->GetFastMarchingPath(endVertex, stoppedPathPoints), true);
+  CHECK_INT(stoppedPathPoints->GetNumberOfPoints(), pathPoints->GetNumberOfPoints());
+
+  // On a curved surface fast marching is more accurate than Dijkstra and paths can be traced to all vertices
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(10.0);
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(24);
+  sphere->Update();
+  vtkPolyData* surface = sphere->GetOutput();
+  vtkNew<vtkSlicerDijkstraGraph> sphereGraph;
+  sphereGraph->Build(surface, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  sphereGraph->BuildTriangles(surface);
+  vtkNew<vtkSlicerDijkstraGraphQuery> sphereQuery;
+  sphereQuery->SetGraph(sphereGraph);
+  vtkNew<vtkSlicerDijkstraGraphQuery> sphereDijkstraQuery;
+  sphereDijkstraQuery->SetGraph(sphereGraph);
+  const vtkIdType sphereSourceVertex = 100;
+  double sphereSourcePoint[3] = { 0.0, 0.0, 0.0 };
+  surface->GetPoint(sphereSourceVertex, sphereSourcePoint);
+  sphereQuery->ComputeFastMarchingDistanceField(sphereSourceVertex);
+  sphereDijkstraQuery->ComputeDistanceField(sphereSourceVertex);
+  double sumFastMarchingError = 0.0;
+  double sumDijkstraError = 0.0;
+  for (vtkIdType pointIndex = 0; pointIndex < surface->GetNumberOfPoints(); pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    surface->GetPoint(pointIndex, point);
+    double cosAngle = vtkMath::Dot(point, sphereSourcePoint) / 100.0;
+    double geodesicDistance = 10.0 * acos(std::max(-1.0, std::min(1.0, cosAngle)));
+    sumFastMarchingError += std::abs(sphereQuery->GetCumulativeWeight(pointIndex) - geodesicDistance);
+    sumDijkstraError += std::abs(sphereDijkstraQuery->GetCumulativeWeight(pointIndex) - geodesicDistance);
+    vtkNew<vtkPoints> spherePathPoints;
+    CHECK_BOOL(sphereQuery->GetFastMarchingPath(pointIndex, spherePathPoints), true);
+    }
+  CHECK_BOOL(sumFastMarchingError < 0.5 * sumDijkstraError, true);
+
+  // Dijkstra search results cannot be used for tracing fast marching paths
+  vtkNew<vtkPoints> invalidPathPoints;
+  CHECK_BOOL(dijkstraQuery->GetFastMarchingPath(endVertex, invalidPathPoints), false);
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerDijkstraGraphQueryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+  vtkPolyData* surface = sphere->GetOutput();
+  vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+
+  vtkNew<vtkSlicerDijkstraGraph> graph;
+  graph->Build(surface, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  CHECK_INT(graph->GetNumberOfVertices(), numberOfPoints);
+  // Each triangle edge is shared by two triangles and stored in both directions
+  CHECK_INT(graph->GetNumberOfEdges(), 3 * surface->GetNumberOfPolys());
+
+  // Results of queries that run concurrently on the same graph must match the serial results
+  const vtkIdType numberOfQueries = 200;
+  std::vector<double> expectedPathCosts(numberOfQueries);
+  vtkNew<vtkSlicerDijkstraGraphQuery> query;
+  query->SetGraph(graph);
+  for (vtkIdType queryIndex = 0; queryIndex < numberOfQueries; queryIndex++)
+    {
+    vtkIdType endVertex = (queryIndex * 37) % numberOfPoints;
+    CHECK_BOOL(query->FindShortestPath(queryIndex, endVertex,
+      vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL), true);
+    expectedPathCosts[queryIndex] = query->GetCumulativeWeight(endVertex);
+    vtkNew<vtkIdList> path;
+    CHECK_BOOL(query->GetPath(endVertex, path), true);
+    CHECK_INT(path->GetId(0), endVertex);
+    CHECK_INT(path->GetId(path->GetNumberOfIds() - 1), queryIndex);
+    }
+
+  std::vector<double> pathCosts(numberOfQueries, -1.0);
+  vtkSMPThreadLocalObject<vtkSlicerDijkstraGraphQuery> localQuery;
+  vtkSMPTools::For(0, numberOfQueries, [&](vtkIdType beginQuery, vtkIdType endQuery)
+    {
+    vtkSlicerDijkstraGraphQuery* threadQuery = localQuery.Local();
+    threadQuery->SetGraph(graph);
+    for (vtkIdType queryIndex = beginQuery; queryIndex < endQuery; queryIndex++)
+      {
+      vtkIdType endVertex = (queryIndex * 37) % numberOfPoints;
+      threadQuery->FindShortestPath(queryIndex, endVertex, vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_BIDIRECTIONAL);
+      pathCosts[queryIndex] = threadQuery->GetCumulativeWeight(endVertex);
+      }
+    });
+  for (vtkIdType queryIndex = 0; queryIndex < numberOfQueries; queryIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(pathCosts[queryIndex], expectedPathCosts[queryIndex], 1e-6);
+    }
+
+  // Distance from each vertex to the source is the same as the distance from the source, because costs are symmetric
+  query->ComputeDistanceField(10);
+  vtkNew<vtkSlicerDijkstraGraphQuery> reverseQuery;
+  reverseQuery->SetGraph(graph);
+  reverseQuery->ComputeDistanceField(10, true);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(reverseQuery->GetCumulativeWeight(pointIndex), query->GetCumulativeWeight(pointIndex), 1e-6);
+    }
+
+  // Searches limited to a maximum path cost only settle the vertices within that cost
+  const double maximumPathCost = 0.25 * expectedPathCosts[numberOfQueries - 1];
+  query->SetMaximumPathCost(maximumPathCost);
+  query->ComputeDistanceField(10);
+  vtkNew<vtkIdList> settledVertices;
+  query->GetSettledVertices(settledVertices);
+  vtkIdType numberOfVerticesWithinMaximumCost = 0;
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    double expectedWeight = reverseQuery->GetCumulativeWeight(pointIndex);
+    if (expectedWeight <= maximumPathCost)
+      {
+      CHECK_DOUBLE_TOLERANCE(query->GetCumulativeWeight(pointIndex), expectedWeight, 1e-6);
+      numberOfVerticesWithinMaximumCost++;
+      }
+    else
+      {
+      CHECK_DOUBLE(query->GetCumulativeWeight(pointIndex), -1.0);
+      }
+    }
+  CHECK_INT(settledVertices->GetNumberOfIds(), numberOfVerticesWithinMaximumCost);
+  CHECK_BOOL(numberOfVerticesWithinMaximumCost < numberOfPoints / 2, true);
+  vtkIdType farVertex = ((numberOfQueries - 1) * 37) % numberOfPoints;
+  CHECK_BOOL(query->FindShortestPath(numberOfQueries - 1, farVertex,
+    vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL), false);
+  CHECK_BOOL(query->FindShortestPath(numberOfQueries - 1, farVertex,
+    vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_BIDIRECTIONAL), false);
+  // Search state of the previous searches is reset
+  query->SetMaximumPathCost(VTK_DOUBLE_MAX);
+  CHECK_BOOL(query->FindShortestPath(numberOfQueries - 1, farVertex,
+    vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL), true);
+  CHECK_DOUBLE_TOLERANCE(query->GetCumulativeWeight(farVertex), expectedPathCosts[numberOfQueries - 1], 1e-6);
+  query->ComputeDistanceField(10);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(query->GetCumulativeWeight(pointIndex), reverseQuery->GetCumulativeWeight(pointIndex), 1e-6);
+    }
+
+  // Landmarks are removed when edge costs are updated
+  graph->BuildLandmarks(3);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 3);
+  CHECK_INT(graph->GetRequestedNumberOfLandmarks(), 3);
+  query->FindShortestPath(0, numberOfPoints - 1, vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL);
+  double lowerBound = graph->GetLandmarkLowerBound(0, numberOfPoints - 1);
+  CHECK_BOOL(lowerBound > 0.0 && lowerBound <= query->GetCumulativeWeight(numberOfPoints - 1) + 1e-6, true);
+  graph->UpdateEdgeCosts(surface, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE, false);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 0);
+  CHECK_INT(graph->GetRequestedNumberOfLandmarks(), 0);
+
+  // Incremental update of edge costs after modifying scalars gives the same result as rebuilding the graph
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetNumberOfValues(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    scalars->SetValue(pointIndex, static_cast<float>(1 + pointIndex % 5));
+    }
+  surface->GetPointData()->SetScalars(scalars);
+  graph->Build(surface, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_MULTIPLICATIVE, true);
+  graph->BuildLandmarks(2);
+  CHECK_INT(graph->UpdateModifiedEdgeCosts(surface), 0);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 2);
+  for (vtkIdType pointIndex = 100; pointIndex < 120; pointIndex++)
+    {
+    scalars->SetValue(pointIndex, 20.0f);
+    }
+  scalars->Modified();
+  // Landmarks are kept if edge costs only increase and the search with landmarks still finds the shortest path
+  CHECK_INT(graph->UpdateModifiedEdgeCosts(surface), 20);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 2);
+  for (vtkIdType endVertex : { vtkIdType(115), numberOfPoints / 2, numberOfPoints - 1 })
+    {
+    CHECK_BOOL(query->FindShortestPath(105, endVertex,
+      vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_UNIDIRECTIONAL), true);
+    double landmarkPathCost = query->GetCumulativeWeight(endVertex);
+    query->ComputeDistanceField(105);
+    CHECK_DOUBLE_TOLERANCE(landmarkPathCost, query->GetCumulativeWeight(endVertex), 1e-6);
+    }
+  // Landmarks are removed if any edge cost decreases
+  vtkNew<vtkIdList> modifiedVertices;
+  for (vtkIdType pointIndex = 300; pointIndex < 310; pointIndex++)
+    {
+    scalars->SetValue(pointIndex, 0.5f);
+    modifiedVertices->InsertNextId(pointIndex);
+    }
+  scalars->Modified();
+  CHECK_INT(graph->UpdateModifiedEdgeCosts(surface, modifiedVertices), 10);
+  CHECK_INT(graph->GetNumberOfLandmarks(), 0);
+  CHECK_INT(graph->UpdateModifiedEdgeCosts(surface), 0);
+
+  vtkNew<vtkSlicerDijkstraGraph> rebuiltGraph;
+  rebuiltGraph->Build(surface, vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_MULTIPLICATIVE, true);
+  vtkNew<vtkSlicerDijkstraGraphQuery> rebuiltQuery;
+  rebuiltQuery->SetGraph(rebuiltGraph);
+  for (vtkIdType sourceVertex : { vtkIdType(0), vtkIdType(110), vtkIdType(305) })
+    {
+    query->ComputeDistanceField(sourceVertex);
+    rebuiltQuery->ComputeDistanceField(sourceVertex);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+      {
+      CHECK_DOUBLE_TOLERANCE(query->GetCumulativeWeight(pointIndex), rebuiltQuery->GetCumulativeWeight(pointIndex), 1e-6);
+      }
+    }
+
+  // Parallel (delta-stepping) distance field computation gives the same result as the serial one
+  vtkNew<vtkSlicerDijkstraGraphQuery> parallelQuery;
+  parallelQuery->SetGraph(graph);
+  for (double bucketWidth : { 0.0, 0.5, 1.0e9 })
+    {
+    for (vtkIdType sourceVertex : { vtkIdType(0), vtkIdType(305) })
+      {
+      query->ComputeDistanceField(sourceVertex);
+      parallelQuery->ComputeDistanceFieldParallel(sourceVertex, bucketWidth);
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+        {
+        CHECK_DOUBLE_TOLERANCE(parallelQuery->GetCumulativeWeight(pointIndex), query->GetCumulativeWeight(pointIndex), 1e-6);
+        }
+      vtkNew<vtkIdList> parallelPath;
+      CHECK_BOOL(parallelQuery->GetPath(numberOfPoints / 2, parallelPath), true);
+      CHECK_INT(parallelPath->GetId(parallelPath->GetNumberOfIds() - 1), sourceVertex);
+      }
+    }
+  parallelQuery->SetMaximumPathCost(maximumPathCost);
+  parallelQuery->ComputeDistanceFieldParallel(10);
+  query->SetMaximumPathCost(maximumPathCost);
+  query->ComputeDistanceField(10);
+  parallelQuery->GetSettledVertices(settledVertices);
+  vtkNew<vtkIdList> expectedSettledVertices;
+  query->GetSettledVertices(expectedSettledVertices);
+  CHECK_INT(settledVertices->GetNumberOfIds(), expectedSettledVertices->GetNumberOfIds());
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    CHECK_DOUBLE_TOLERANCE(parallelQuery->GetCumulativeWeight(pointIndex), query->GetCumulativeWeight(pointIndex), 1e-6);
+    }
+
+  CHECK_EXIT_SUCCESS(TestFastMarching());
+  CHECK_EXIT_SUCCESS(TestLandmarksWithIsolatedFirstPoint());
+
+  std::cout << "Test succeeded." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@
 // VTK includes
 #include "vtk_eigen.h"
 #include VTK_EIGEN(Dense)
+#include <vtkImageData.h>
 #include <vtkMath.h>
 #include <vtkMatrix3x3.h>
 #include <vtkMatrix4x4.h>
@@ -129,6 +130,32 @@ bool vtkAddonMathUtilities::MatrixAreEqual(const vtkMatrix3x3 *m1,
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkAddonMathUtilities::ImageGeometryAreEqual(vtkImageData* image1,
+                                                  vtkImageData* image2,
+                                                  double tolerance)
+{
+  if (!image1 || !image2)
+    {
+    vtkGenericWarningMacro("vtkAddonMathUtilities::ImageGeometryAreEqual: invalid input image");
+    return false;
+    }
+  double* origin1 = image1->GetOrigin();
+  double* origin2 = image2->GetOrigin();
+  double* spacing1 = image1->GetSpacing();
+  double* spacing2 = image2->GetSpacing();
+  for (int axis = 0; axis < 3; axis++)
+    {
+    double spacingTolerance = tolerance * fabs(spacing1[axis]);
+    if (fabs(spacing1[axis] - spacing2[axis]) > spacingTolerance
+      || fabs(origin1[axis] - origin2[axis]) > spacingTolerance)
+      {
+      return false;
+      }
+    }
+  return MatrixAreEqual(image1->GetDirectionMatrix(), image2->GetDirectionMatrix(), tolerance);
+}
+
 //----------------------------------------------------------------------------
 void vtkAddonMathUtilities::GetOrientationMatrixColumn(vtkMatrix4x4* m, int columnIndex,
                                       double columnVector[3])
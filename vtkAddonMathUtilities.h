@@ -23,6 +23,7 @@
 #include <vtkAddon.h>
 #include <vtkObject.h>
 
+class vtkImageData;
 class vtkMatrix4x4;
 class vtkMatrix3x3;
 class vtkPlane;
@@ -54,6 +55,13 @@ public:
                              const vtkMatrix3x3 *m2,
                              double tolerance = 1e-3);
 
+  /// Returns true if the two images have the same origin, spacing, and axis directions,
+  /// i.e., voxels of the same index are at the same physical position.
+  /// Origin and spacing tolerance is relative to the spacing of image1.
+  static bool ImageGeometryAreEqual(vtkImageData* image1,
+                                    vtkImageData* image2,
+                                    double tolerance = 1e-6);
+
   /// Get matrix column as a vector
   static void GetOrientationMatrixColumn(vtkMatrix4x4* m, int columnIndex, double columnVector[4]);
 
@@ -0,0 +1,637 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include <algorithm> // VTK 8.2.0 has bug for C++17 "clamp" function (algorithm must be included before vtMath.h)
+
+#include "vtkImageCurvedPlanarReformat.h"
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkMatrix3x3.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkParallelTransportFrameQuery.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimeStamp.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageCurvedPlanarReformat);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Voxels within this distance (in voxels) from the input extent boundary are considered to be inside.
+const double BOUNDARY_TOLERANCE = 0.5;
+
+//----------------------------------------------------------------------------
+/// Transforms physical coordinates to continuous voxel index.
+struct ImageGeometry
+{
+  double Origin[3] = { 0.0, 0.0, 0.0 };
+  double PhysicalToIndex[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+
+  bool Initialize(const double origin[3], const double spacing[3], const double* direction)
+    {
+    if (spacing[0] == 0.0 || spacing[1] == 0.0 || spacing[2] == 0.0)
+      {
+      return false;
+      }
+    double indexToPhysical[9] = { 0.0 };
+    for (int row = 0; row < 3; row++)
+      {
+      this->Origin[row] = origin[row];
+      for (int column = 0; column < 3; column++)
+        {
+        double directionElement = (direction ? direction[row * 3 + column] : (row == column ? 1.0 : 0.0));
+        indexToPhysical[row * 3 + column] = directionElement * spacing[column];
+        }
+      }
+    vtkMatrix3x3::Invert(indexToPhysical, this->PhysicalToIndex);
+    return true;
+    }
+
+  void TransformVector(const double vector[3], double index[3]) const
+    {
+    for (int row = 0; row < 3; row++)
+      {
+      index[row] = this->PhysicalToIndex[row * 3] * vector[0] + this->PhysicalToIndex[row * 3 + 1] * vector[1]
+        + this->PhysicalToIndex[row * 3 + 2] * vector[2];
+      }
+    }
+
+  void TransformPoint(const double point[3], double index[3]) const
+    {
+    double vector[3] = { point[0] - this->Origin[0], point[1] - this->Origin[1], point[2] - this->Origin[2] };
+    this->TransformVector(vector, index);
+    }
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+T CastValue(double value)
+{
+  if (std::numeric_limits<T>::is_integer)
+    {
+    value = std::floor(value + 0.5);
+    value = std::max(value, static_cast<double>(std::numeric_limits<T>::lowest()));
+    value = std::min(value, static_cast<double>(std::numeric_limits<T>::max()));
+    }
+  return static_cast<T>(value);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void InterpolateNearest(const T* inPtr, const int inExt[6], const vtkIdType inInc[3], int numberOfComponents,
+  const double index[3], T backgroundValue, T* outPtr)
+{
+  vtkIdType offset = 0;
+  for (int axis = 0; axis < 3; axis++)
+    {
+    int voxelIndex = vtkMath::Floor(index[axis] + 0.5);
+    if (voxelIndex < inExt[axis * 2] || voxelIndex > inExt[axis * 2 + 1])
+      {
+      std::fill(outPtr, outPtr + numberOfComponents, backgroundValue);
+      return;
+      }
+    offset += (voxelIndex - inExt[axis * 2]) * inInc[axis];
+    }
+  std::copy(inPtr + offset, inPtr + offset + numberOfComponents, outPtr);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void InterpolateLinear(const T* inPtr, const int inExt[6], const vtkIdType inInc[3], int numberOfComponents,
+  const double index[3], T backgroundValue, T* outPtr)
+{
+  vtkIdType offset = 0;
+  vtkIdType step[3] = { 0, 0, 0 };
+  double weight[3] = { 0.0, 0.0, 0.0 };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    double position = index[axis];
+    if (position < inExt[axis * 2] - BOUNDARY_TOLERANCE || position > inExt[axis * 2 + 1] + BOUNDARY_TOLERANCE)
+      {
+      std::fill(outPtr, outPtr + numberOfComponents, backgroundValue);
+      return;
+      }
+    position = std::max<double>(inExt[axis * 2], std::min<double>(position, inExt[axis * 2 + 1]));
+    int voxelIndex = vtkMath::Floor(position);
+    if (voxelIndex < inExt[axis * 2 + 1])
+      {
+      weight[axis] = position - voxelIndex;
+      step[axis] = inInc[axis];
+      }
+    else
+      {
+      // Last voxel along this axis, there is no next voxel to interpolate with
+      voxelIndex = inExt[axis * 2 + 1];
+      }
+    offset += (voxelIndex - inExt[axis * 2]) * inInc[axis];
+    }
+
+  const T* voxel = inPtr + offset;
+  for (int component = 0; component < numberOfComponents; component++, voxel++)
+    {
+    double value00 = voxel[0] + weight[0] * (voxel[step[0]] - static_cast<double>(voxel[0]));
+    double value10 = voxel[step[1]] + weight[0] * (voxel[step[1] + step[0]] - static_cast<double>(voxel[step[1]]));
+    double value01 = voxel[step[2]] + weight[0] * (voxel[step[2] + step[0]] - static_cast<double>(voxel[step[2]]));
+    double value11 = voxel[step[2] + step[1]]
+      + weight[0] * (voxel[step[2] + step[1] + step[0]] - static_cast<double>(voxel[step[2] + step[1]]));
+    double value0 = value00 + weight[1] * (value10 - value00);
+    double value1 = value01 + weight[1] * (value11 - value01);
+    outPtr[component] = CastValue<T>(value0 + weight[2] * (value1 - value0));
+    }
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkImageCurvedPlanarReformat::vtkInternal
+{
+public:
+  /// Compute sampling positions along the curve if the curve or any parameters that affect the slice geometry
+  /// (frame array names, slice size, output spacing) changed since last time.
+  /// Returns false if the curve cannot be sampled.
+  bool UpdateSlices(vtkImageCurvedPlanarReformat* self);
+
+  /// Returns true if the curve or parameters that the slices were computed from have changed.
+  bool IsSliceGeometryModified(vtkImageCurvedPlanarReformat* self);
+
+  /// Get physical position of output voxel (i, j) in slice k.
+  void GetSamplePosition(int i, int j, int k, double position[3]);
+
+  /// Compute sampling start position and steps in input voxel coordinates for each slice of the extent.
+  /// 9 values are stored for each slice: voxel index of the first sample in the slice (first row, first column),
+  /// index increment between columns, and index increment between rows.
+  void ComputeScanlineSampling(const ImageGeometry& geometry, const int outExt[6], std::vector<double>& sampling);
+
+  vtkSmartPointer<vtkPolyData> Curve;
+  vtkNew<vtkParallelTransportFrameQuery> FrameQuery;
+
+  /// Position, normal, and binormal of the curve at each output slice
+  vtkNew<vtkDoubleArray> SlicePositions;
+  vtkNew<vtkDoubleArray> SliceNormals;
+  vtkNew<vtkDoubleArray> SliceBinormals;
+
+  int Dimensions[3] = { 0, 0, 0 };
+  double Origin[3] = { 0.0, 0.0, 0.0 };
+  double Spacing[3] = { 1.0, 1.0, 1.0 };
+  bool SlicesValid = false;
+  vtkTimeStamp SlicesTime;
+
+  /// Curve and parameters that the slices were computed from
+  vtkPolyData* SlicesCurve = nullptr;
+  std::string SlicesArrayNames[4];
+  double SlicesSliceSize[2] = { 0.0, 0.0 };
+  double SlicesOutputSpacing[3] = { 0.0, 0.0, 0.0 };
+};
+
+//----------------------------------------------------------------------------
+bool vtkImageCurvedPlanarReformat::vtkInternal::IsSliceGeometryModified(vtkImageCurvedPlanarReformat* self)
+{
+  if (this->SlicesTime.GetMTime() == 0 || this->Curve != this->SlicesCurve
+    || (this->Curve && this->Curve->GetMTime() > this->SlicesTime.GetMTime()))
+    {
+    return true;
+    }
+  const char* arrayNames[4] = { self->GetTangentsArrayName(), self->GetNormalsArrayName(),
+    self->GetBinormalsArrayName(), self->GetFramesArrayName() };
+  for (int arrayIndex = 0; arrayIndex < 4; arrayIndex++)
+    {
+    if (this->SlicesArrayNames[arrayIndex] != (arrayNames[arrayIndex] ? arrayNames[arrayIndex] : ""))
+      {
+      return true;
+      }
+    }
+  double* sliceSize = self->GetSliceSize();
+  double* spacing = self->GetOutputSpacing();
+  return !std::equal(sliceSize, sliceSize + 2, this->SlicesSliceSize)
+    || !std::equal(spacing, spacing + 3, this->SlicesOutputSpacing);
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageCurvedPlanarReformat::vtkInternal::UpdateSlices(vtkImageCurvedPlanarReformat* self)
+{
+  // Interpolation mode, background value, and input image changes do not affect the slice geometry
+  if (!this->IsSliceGeometryModified(self))
+    {
+    // up-to-date
+    return this->SlicesValid;
+    }
+  this->SlicesValid = false;
+  this->SlicesTime.Modified();
+  this->SlicesCurve = this->Curve;
+  const char* arrayNames[4] = { self->GetTangentsArrayName(), self->GetNormalsArrayName(),
+    self->GetBinormalsArrayName(), self->GetFramesArrayName() };
+  for (int arrayIndex = 0; arrayIndex < 4; arrayIndex++)
+    {
+    this->SlicesArrayNames[arrayIndex] = (arrayNames[arrayIndex] ? arrayNames[arrayIndex] : "");
+    }
+  std::copy(self->GetSliceSize(), self->GetSliceSize() + 2, this->SlicesSliceSize);
+  std::copy(self->GetOutputSpacing(), self->GetOutputSpacing() + 3, this->SlicesOutputSpacing);
+
+  if (!this->Curve)
+    {
+    vtkErrorWithObjectMacro(self, "Curve is not set");
+    return false;
+    }
+  double* spacing = self->GetOutputSpacing();
+  if (spacing[0] <= 0.0 || spacing[1] <= 0.0 || spacing[2] <= 0.0)
+    {
+    vtkErrorWithObjectMacro(self, "Invalid output spacing: " << spacing[0] << ", " << spacing[1] << ", " << spacing[2]);
+    return false;
+    }
+
+  this->FrameQuery->SetTangentsArrayName(self->GetTangentsArrayName());
+  this->FrameQuery->SetNormalsArrayName(self->GetNormalsArrayName());
+  this->FrameQuery->SetBinormalsArrayName(self->GetBinormalsArrayName());
+  this->FrameQuery->SetFramesArrayName(self->GetFramesArrayName());
+  if (!this->FrameQuery->Build(this->Curve))
+    {
+    vtkErrorWithObjectMacro(self, "Failed to get coordinate frames from the curve");
+    return false;
+    }
+
+  double* sliceSize = self->GetSliceSize();
+  for (int axis = 0; axis < 2; axis++)
+    {
+    this->Dimensions[axis] = std::max(1, vtkMath::Floor(sliceSize[axis] / spacing[axis] + 0.5));
+    this->Origin[axis] = -0.5 * (this->Dimensions[axis] - 1) * spacing[axis];
+    }
+  // Small tolerance to include the last point if curve length is an integer multiple of the spacing
+  this->Dimensions[2] = vtkMath::Floor(this->FrameQuery->GetCurveLength() / spacing[2] + 1e-6) + 1;
+  this->Origin[2] = 0.0;
+  std::copy(spacing, spacing + 3, this->Spacing);
+
+  vtkNew<vtkDoubleArray> arcLengths;
+  arcLengths->SetNumberOfTuples(this->Dimensions[2]);
+  for (int sliceIndex = 0; sliceIndex < this->Dimensions[2]; sliceIndex++)
+    {
+    arcLengths->SetValue(sliceIndex, sliceIndex * spacing[2]);
+    }
+  if (!this->FrameQuery->GetFrames(arcLengths, this->SlicePositions, this->SliceNormals, this->SliceBinormals, nullptr))
+    {
+    return false;
+    }
+
+  this->SlicesValid = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCurvedPlanarReformat::vtkInternal::GetSamplePosition(int i, int j, int k, double position[3])
+{
+  double normalOffset = this->Origin[0] + i * this->Spacing[0];
+  double binormalOffset = this->Origin[1] + j * this->Spacing[1];
+  const double* curvePosition = this->SlicePositions->GetPointer(3 * k);
+  const double* normal = this->SliceNormals->GetPointer(3 * k);
+  const double* binormal = this->SliceBinormals->GetPointer(3 * k);
+  for (int axis = 0; axis < 3; axis++)
+    {
+    position[axis] = curvePosition[axis] + normalOffset * normal[axis] + binormalOffset * binormal[axis];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCurvedPlanarReformat::vtkInternal::ComputeScanlineSampling(
+  const ImageGeometry& geometry, const int outExt[6], std::vector<double>& sampling)
+{
+  int numberOfSlices = outExt[5] - outExt[4] + 1;
+  sampling.resize(9 * numberOfSlices);
+  for (int sliceIndex = 0; sliceIndex < numberOfSlices; sliceIndex++)
+    {
+    int k = outExt[4] + sliceIndex;
+    double* sliceSampling = &sampling[9 * sliceIndex];
+    double startPosition[3] = { 0.0, 0.0, 0.0 };
+    this->GetSamplePosition(outExt[0], outExt[2], k, startPosition);
+    geometry.TransformPoint(startPosition, sliceSampling);
+    double columnStep[3] = { 0.0, 0.0, 0.0 };
+    double rowStep[3] = { 0.0, 0.0, 0.0 };
+    const double* normal = this->SliceNormals->GetPointer(3 * k);
+    const double* binormal = this->SliceBinormals->GetPointer(3 * k);
+    for (int axis = 0; axis < 3; axis++)
+      {
+      columnStep[axis] = normal[axis] * this->Spacing[0];
+      rowStep[axis] = binormal[axis] * this->Spacing[1];
+      }
+    geometry.TransformVector(columnStep, sliceSampling + 3);
+    geometry.TransformVector(rowStep, sliceSampling + 6);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkImageCurvedPlanarReformat::vtkImageCurvedPlanarReformat()
+{
+  this->Internal = new vtkInternal;
+  this->SetTangentsArrayName("Tangents");
+  this->SetNormalsArrayName("Normals");
+  this->SetBinormalsArrayName("Binormals");
+  this->SetFramesArrayName("Frames");
+}
+
+//----------------------------------------------------------------------------
+vtkImageCurvedPlanarReformat::~vtkImageCurvedPlanarReformat()
+{
+  this->SetTangentsArrayName(nullptr);
+  this->SetNormalsArrayName(nullptr);
+  this->SetBinormalsArrayName(nullptr);
+  this->SetFramesArrayName(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCurvedPlanarReformat::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Curve: " << this->Internal->Curve.GetPointer() << "\n";
+  os << indent << "TangentsArrayName: " << (this->TangentsArrayName ? this->TangentsArrayName : "(none)") << "\n";
+  os << indent << "NormalsArrayName: " << (this->NormalsArrayName ? this->NormalsArrayName : "(none)") << "\n";
+  os << indent << "BinormalsArrayName: " << (this->BinormalsArrayName ? this->BinormalsArrayName : "(none)") << "\n";
+  os << indent << "FramesArrayName: " << (this->FramesArrayName ? this->FramesArrayName : "(none)") << "\n";
+  os << indent << "SliceSize: (" << this->SliceSize[0] << ", " << this->SliceSize[1] << ")\n";
+  os << indent << "OutputSpacing: ("
+    << this->OutputSpacing[0] << ", " << this->OutputSpacing[1] << ", " << this->OutputSpacing[2] << ")\n";
+  os << indent << "InterpolationMode: "
+    << vtkImageCurvedPlanarReformat::GetInterpolationModeAsString(this->InterpolationMode) << "\n";
+  os << indent << "BackgroundValue: " << this->BackgroundValue << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkImageCurvedPlanarReformat::GetInterpolationModeAsString(int interpolationMode)
+{
+  switch (interpolationMode)
+    {
+    case INTERPOLATION_NEAREST:
+      {
+      return "nearest";
+      }
+    case INTERPOLATION_LINEAR:
+      {
+      return "linear";
+      }
+    default:
+      {
+      return "";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCurvedPlanarReformat::GetInterpolationModeFromString(const char* interpolationMode)
+{
+  if (interpolationMode == nullptr)
+    {
+    // invalid name
+    vtkGenericWarningMacro("Invalid interpolation mode name");
+    return -1;
+    }
+  for (int i = 0; i < vtkImageCurvedPlanarReformat::INTERPOLATION_LAST; i++)
+    {
+    if (strcmp(interpolationMode, vtkImageCurvedPlanarReformat::GetInterpolationModeAsString(i)) == 0)
+      {
+      // found a matching name
+      return i;
+      }
+    }
+  // name not found
+  vtkGenericWarningMacro("Unknown interpolation mode: " << interpolationMode);
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCurvedPlanarReformat::SetCurve(vtkPolyData* curve)
+{
+  if (this->Internal->Curve == curve)
+    {
+    return;
+    }
+  this->Internal->Curve = curve;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkImageCurvedPlanarReformat::GetCurve()
+{
+  return this->Internal->Curve;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkImageCurvedPlanarReformat::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Internal->Curve)
+    {
+    mTime = std::max(mTime, this->Internal->Curve->GetMTime());
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCurvedPlanarReformat::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  if (!this->Internal->UpdateSlices(this))
+    {
+    return 0;
+    }
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  int* dimensions = this->Internal->Dimensions;
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+    0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1);
+  outInfo->Set(vtkDataObject::SPACING(), this->Internal->Spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), this->Internal->Origin, 3);
+  // Output axes are the normal, binormal, and tangent axes of the curve
+  double identityDirection[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+  outInfo->Set(vtkDataObject::DIRECTION(), identityDirection, 9);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCurvedPlanarReformat::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  int inWholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inWholeExtent);
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+
+  // Only request the region of the input that the requested output slices intersect
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  inInfo->Get(vtkDataObject::ORIGIN(), origin);
+  inInfo->Get(vtkDataObject::SPACING(), spacing);
+  double* direction = (inInfo->Has(vtkDataObject::DIRECTION()) ? inInfo->Get(vtkDataObject::DIRECTION()) : nullptr);
+  ImageGeometry geometry;
+  int inExt[6] = { 0, -1, 0, -1, 0, -1 };
+  if (this->Internal->SlicesValid && outExt[0] <= outExt[1] && outExt[2] <= outExt[3] && outExt[4] <= outExt[5]
+    && geometry.Initialize(origin, spacing, direction))
+    {
+    double indexBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (int k = outExt[4]; k <= outExt[5]; k++)
+      {
+      for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+        {
+        double position[3] = { 0.0, 0.0, 0.0 };
+        this->Internal->GetSamplePosition(outExt[cornerIndex % 2], outExt[2 + cornerIndex / 2], k, position);
+        double index[3] = { 0.0, 0.0, 0.0 };
+        geometry.TransformPoint(position, index);
+        for (int axis = 0; axis < 3; axis++)
+          {
+          indexBounds[axis * 2] = std::min(indexBounds[axis * 2], index[axis]);
+          indexBounds[axis * 2 + 1] = std::max(indexBounds[axis * 2 + 1], index[axis]);
+          }
+        }
+      }
+    for (int axis = 0; axis < 3; axis++)
+      {
+      inExt[axis * 2] = std::max(inWholeExtent[axis * 2], vtkMath::Floor(indexBounds[axis * 2]));
+      inExt[axis * 2 + 1] = std::min(inWholeExtent[axis * 2 + 1], vtkMath::Floor(indexBounds[axis * 2 + 1]) + 1);
+      }
+    }
+  if (inExt[0] > inExt[1] || inExt[2] > inExt[3] || inExt[4] > inExt[5])
+    {
+    // The output does not intersect the input, request a single voxel to get the scalar type
+    inExt[0] = inExt[1] = inWholeExtent[0];
+    inExt[2] = inExt[3] = inWholeExtent[2];
+    inExt[4] = inExt[5] = inWholeExtent[4];
+    }
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void vtkImageCurvedPlanarReformatExecute(vtkImageData* inData, T* inPtr, T* outPtr, int outExt[6],
+  const std::vector<double>& sampling, int interpolationMode, double backgroundValue)
+{
+  int* inExt = inData->GetExtent();
+  vtkIdType inInc[3] = { 0, 0, 0 };
+  inData->GetIncrements(inInc);
+  int numberOfComponents = inData->GetNumberOfScalarComponents();
+  T background = CastValue<T>(backgroundValue);
+
+  int numberOfColumns = outExt[1] - outExt[0] + 1;
+  int numberOfRows = outExt[3] - outExt[2] + 1;
+  vtkIdType outSliceSize = static_cast<vtkIdType>(numberOfColumns) * numberOfRows * numberOfComponents;
+  vtkIdType numberOfSlices = static_cast<vtkIdType>(sampling.size() / 9);
+
+  vtkSMPTools::For(0, numberOfSlices, [&](vtkIdType beginSliceIndex, vtkIdType endSliceIndex)
+    {
+    for (vtkIdType sliceIndex = beginSliceIndex; sliceIndex < endSliceIndex; sliceIndex++)
+      {
+      const double* sliceStart = &sampling[9 * sliceIndex];
+      const double* columnStep = sliceStart + 3;
+      const double* rowStep = sliceStart + 6;
+      T* outVoxelPtr = outPtr + sliceIndex * outSliceSize;
+      for (int row = 0; row < numberOfRows; row++)
+        {
+        // Sampling position is incremented along the scanline
+        double index[3] =
+          {
+          sliceStart[0] + row * rowStep[0],
+          sliceStart[1] + row * rowStep[1],
+          sliceStart[2] + row * rowStep[2]
+          };
+        for (int column = 0; column < numberOfColumns; column++)
+          {
+          if (interpolationMode == vtkImageCurvedPlanarReformat::INTERPOLATION_NEAREST)
+            {
+            InterpolateNearest(inPtr, inExt, inInc, numberOfComponents, index, background, outVoxelPtr);
+            }
+          else
+            {
+            InterpolateLinear(inPtr, inExt, inInc, numberOfComponents, index, background, outVoxelPtr);
+            }
+          outVoxelPtr += numberOfComponents;
+          index[0] += columnStep[0];
+          index[1] += columnStep[1];
+          index[2] += columnStep[2];
+          }
+        }
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCurvedPlanarReformat::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* input = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* output = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!input || !output)
+    {
+    vtkErrorMacro("Invalid input or output");
+    return 0;
+    }
+  vtkDataArray* inScalars = input->GetPointData()->GetScalars();
+  if (!inScalars)
+    {
+    vtkErrorMacro("Input image has no scalars");
+    return 0;
+    }
+  if (!this->Internal->SlicesValid)
+    {
+    vtkErrorMacro("Curve sampling positions are not available");
+    return 0;
+    }
+
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  output->SetExtent(outExt);
+  output->SetOrigin(this->Internal->Origin);
+  output->SetSpacing(this->Internal->Spacing);
+  output->AllocateScalars(inScalars->GetDataType(), inScalars->GetNumberOfComponents());
+  output->GetPointData()->GetScalars()->SetName(inScalars->GetName());
+  if (outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5])
+    {
+    // empty output
+    return 1;
+    }
+
+  ImageGeometry geometry;
+  if (!geometry.Initialize(input->GetOrigin(), input->GetSpacing(), input->GetDirectionMatrix()->GetData()))
+    {
+    vtkErrorMacro("Invalid input image geometry");
+    return 0;
+    }
+  std::vector<double> sampling;
+  this->Internal->ComputeScanlineSampling(geometry, outExt, sampling);
+
+  void* inPtr = input->GetScalarPointer();
+  void* outPtr = output->GetScalarPointer();
+  switch (inScalars->GetDataType())
+    {
+    vtkTemplateMacro(vtkImageCurvedPlanarReformatExecute(input, static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr),
+      outExt, sampling, this->InterpolationMode, this->BackgroundValue));
+    default:
+      vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+      return 0;
+    }
+  return 1;
+}
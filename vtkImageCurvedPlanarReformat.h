@@ -0,0 +1,138 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+/// \brief Resample a volume into a straightened volume along a curve (curved planar reformatting).
+///
+/// The curve is a polyline that has coordinate frames stored at its points, typically the output of
+/// vtkParallelTransportFrame. The curve is sampled at uniform arc length steps and at each sample position
+/// a cross-section of the input volume is resampled in the plane spanned by the normal and binormal axes.
+///
+/// Voxel (i, j, k) of the output is the cross-section point at normal offset x = origin[0] + i * spacing[0]
+/// and binormal offset y = origin[1] + j * spacing[1], centered on the curve point at arc length
+/// z = k * spacing[2]. Output origin is set so that the curve goes through the center of each slice.
+///
+/// Sampling positions along the curve are computed only when the curve or the reformat parameters change,
+/// so updating the filter after only the input voxels changed (for example, when browsing a time sequence)
+/// only performs the resampling. Slices are resampled in parallel.
+///
+/// Input image direction matrix is taken into account. Scalar type and number of components of the output
+/// are the same as the input. Sample positions within half voxel from the boundary of the input volume
+/// are considered to be inside, other positions outside the volume are set to the background value.
+///
+/// \sa vtkParallelTransportFrame, vtkParallelTransportFrameQuery
+
+#ifndef vtkImageCurvedPlanarReformat_h
+#define vtkImageCurvedPlanarReformat_h
+
+#include "vtkAddon.h"  // For export macro
+#include "vtkImageAlgorithm.h"
+
+class vtkPolyData;
+
+class VTK_ADDON_EXPORT vtkImageCurvedPlanarReformat : public vtkImageAlgorithm
+{
+public:
+  static vtkImageCurvedPlanarReformat* New();
+  vtkTypeMacro(vtkImageCurvedPlanarReformat, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum
+    {
+    INTERPOLATION_NEAREST,
+    INTERPOLATION_LINEAR,
+    INTERPOLATION_LAST // this must be the last
+    };
+
+  /// Curve along the volume is straightened. Frames are read from the first line cell of the curve.
+  /// The curve is not modified by the filter. Changing the curve content updates the filter output.
+  /// If the curve is the output of a filter then that filter must be updated before this filter.
+  void SetCurve(vtkPolyData* curve);
+  vtkPolyData* GetCurve();
+
+  ///@{
+  /// Get/set the point array names in the curve that contain the tangent (z), normal (x), and binormal (y) axes.
+  /// Default values are the same as in vtkParallelTransportFrame.
+  vtkSetStringMacro(TangentsArrayName);
+  vtkGetStringMacro(TangentsArrayName);
+  vtkSetStringMacro(NormalsArrayName);
+  vtkGetStringMacro(NormalsArrayName);
+  vtkSetStringMacro(BinormalsArrayName);
+  vtkGetStringMacro(BinormalsArrayName);
+  ///@}
+
+  ///@{
+  /// Get/set the point array name in the curve that contains the frames as quaternions or packed axes.
+  /// Only used if the axis arrays are not present. Default value is "Frames".
+  vtkSetStringMacro(FramesArrayName);
+  vtkGetStringMacro(FramesArrayName);
+  ///@}
+
+  ///@{
+  /// Size of the cross-sections along the normal and binormal axes, in physical units.
+  /// Default value is (50, 50).
+  vtkSetVector2Macro(SliceSize, double);
+  vtkGetVector2Macro(SliceSize, double);
+  ///@}
+
+  ///@{
+  /// Spacing of the output volume: sampling distance along the normal and binormal axes
+  /// and distance between slices along the curve. Default value is (1, 1, 1).
+  vtkSetVector3Macro(OutputSpacing, double);
+  vtkGetVector3Macro(OutputSpacing, double);
+  ///@}
+
+  ///@{
+  /// Interpolation method used for resampling the input volume.
+  /// Default is INTERPOLATION_LINEAR.
+  vtkSetClampMacro(InterpolationMode, int, INTERPOLATION_NEAREST, INTERPOLATION_LAST - 1);
+  vtkGetMacro(InterpolationMode, int);
+  void SetInterpolationModeToNearest() { this->SetInterpolationMode(INTERPOLATION_NEAREST); };
+  void SetInterpolationModeToLinear() { this->SetInterpolationMode(INTERPOLATION_LINEAR); };
+  static const char* GetInterpolationModeAsString(int interpolationMode);
+  static int GetInterpolationModeFromString(const char* interpolationModeStr);
+  ///@}
+
+  ///@{
+  /// Value of output voxels that are outside of the input volume. Default value is 0.
+  vtkSetMacro(BackgroundValue, double);
+  vtkGetMacro(BackgroundValue, double);
+  ///@}
+
+  /// Modified time includes the modified time of the curve.
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkImageCurvedPlanarReformat();
+  ~vtkImageCurvedPlanarReformat() override;
+
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  char* TangentsArrayName = nullptr;
+  char* NormalsArrayName = nullptr;
+  char* BinormalsArrayName = nullptr;
+  char* FramesArrayName = nullptr;
+  double SliceSize[2] = { 50.0, 50.0 };
+  double OutputSpacing[3] = { 1.0, 1.0, 1.0 };
+  int InterpolationMode = INTERPOLATION_LINEAR;
+  double BackgroundValue = 0.0;
+
+private:
+  vtkImageCurvedPlanarReformat(const vtkImageCurvedPlanarReformat&) = delete;
+  void operator=(const vtkImageCurvedPlanarReformat&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
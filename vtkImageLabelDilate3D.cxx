@@ -3,28 +3,26 @@
 
 #include "vtkImageLabelDilate3D.h"
 
-#include "vtkCellData.h"
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
-#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 vtkStandardNewMacro(vtkImageLabelDilate3D);
 
 //------------------------------------------------------------------------------
 // Construct an instance of vtkImageLabelDilate3D filter.
-vtkImageLabelDilate3D::vtkImageLabelDilate3D()
-{
-  this->BackgroundValue = 0;
-  this->SetKernelSize(1, 1, 1);
-  this->HandleBoundaries = 1;
-}
+vtkImageLabelDilate3D::vtkImageLabelDilate3D() = default;
 
 //------------------------------------------------------------------------------
 vtkImageLabelDilate3D::~vtkImageLabelDilate3D() = default;
@@ -35,252 +33,363 @@ void vtkImageLabelDilate3D::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "BackgroundValue: " << this->BackgroundValue << endl;
+  os << indent << "DilationMode: " << vtkImageLabelDilate3D::GetDilationModeAsString(this->DilationMode) << endl;
+  os << indent << "MaximumDistance: " << this->MaximumDistance << endl;
 }
 
 //------------------------------------------------------------------------------
-// This method sets the size of the neighborhood.  It also sets the
-// default middle of the neighborhood
-void vtkImageLabelDilate3D::SetKernelSize(int size0, int size1, int size2)
+const char* vtkImageLabelDilate3D::GetDilationModeAsString(int dilationMode)
 {
-  if (this->KernelSize[0] == size0 && this->KernelSize[1] == size1 && this->KernelSize[2] == size2)
+  switch (dilationMode)
     {
-    // no change
-    return;
+    case DILATION_MODE_KERNEL:
+      {
+      return "kernel";
+      }
+    case DILATION_MODE_DISTANCE:
+      {
+      return "distance";
+      }
+    default:
+      {
+      return "";
+      }
     }
-
-  // Set the kernel size and middle
-  this->KernelSize[0] = size0;
-  this->KernelMiddle[0] = size0 / 2;
-  this->KernelSize[1] = size1;
-  this->KernelMiddle[1] = size1 / 2;
-  this->KernelSize[2] = size2;
-  this->KernelMiddle[2] = size2 / 2;
-
-  this->Modified();
 }
 
-namespace
-{
-
 //------------------------------------------------------------------------------
-// Compute the most frequently occurring number in the vector
-template <typename T>
-T vtkComputeModeOfArray(const std::vector<T>& values) {
-  // A map to store the count of each value
-  std::map<T, int> valueCount;
-  T maxValue = 0; // the most frequent value found so far
-  std::size_t maxCount = 0; // how many of this value are found so far
-  typename std::vector<T>::size_type countForMajority = typename std::vector<T>::size_type(values.size() / 2); // more than this count means majority
-  for (T value : values)
+int vtkImageLabelDilate3D::GetDilationModeFromString(const char* dilationMode)
+{
+  if (dilationMode == nullptr)
     {
-    std::size_t count = ++valueCount[value];
-    if (count > maxCount)
+    // invalid name
+    vtkGenericWarningMacro("Invalid dilation mode name");
+    return -1;
+    }
+  for (int i = 0; i < vtkImageLabelDilate3D::DILATION_MODE_LAST; i++)
+    {
+    if (strcmp(dilationMode, vtkImageLabelDilate3D::GetDilationModeAsString(i)) == 0)
       {
-      maxValue = value;
-      maxCount = count;
-      if (count > countForMajority)
-        {
-        // already more than half of the values are this, so we don't need to continue the search
-        break;
-        }
+      // found a matching name
+      return i;
       }
     }
-  return maxValue;
+  // name not found
+  vtkGenericWarningMacro("Unknown dilation mode: " << dilationMode);
+  return -1;
 }
 
-} // end anonymous namespace
+//------------------------------------------------------------------------------
+namespace
+{
 
 //------------------------------------------------------------------------------
-// This method contains the second switch statement that calls the correct
-// templated function for the mask types.
+// Squared distance of voxels that have no labelled voxel within the maximum distance.
+const double NO_LABEL_SQUARED_DISTANCE = std::numeric_limits<double>::infinity();
+
+//------------------------------------------------------------------------------
+// One pass of the separable squared Euclidean distance transform (Felzenszwalb and Huttenlocher)
+// along an image line, which also propagates the label of the nearest labelled voxel.
+// Before the transform SquaredDistances and Labels contain the squared distance and label of the
+// nearest labelled voxel, considering only the axes that have been processed already.
+// After the transform they also take into account the axis of the line.
+// Buffers are allocated once and reused for all lines that are processed by a thread.
 template <typename T>
-void vtkImageLabelDilate3DExecute(vtkImageLabelDilate3D* self, vtkImageData* inData, T* inPtr,
-  vtkImageData* outData, T* outPtr, int outExt[6], int id, vtkDataArray* inArray)
+class vtkLabelDistanceTransformLine
 {
-  if (!inArray)
+public:
+  vtkLabelDistanceTransformLine(int numberOfVoxels)
+    : SquaredDistances(numberOfVoxels)
+    , Labels(numberOfVoxels)
+    , Roots(numberOfVoxels)
+    , RootSquaredDistances(numberOfVoxels)
+    , RootLabels(numberOfVoxels)
+    , Boundaries(numberOfVoxels)
     {
-    return;
     }
 
-  // The logic of iterating through a box neighborhood was adopted from vtkImageMedian3D filter.
+  // Returns false if there are no labelled voxels within the maximum distance (the line is unchanged).
+  bool Transform(double squaredSpacing, double maximumSquaredDistance)
+    {
+    int numberOfVoxels = static_cast<int>(this->SquaredDistances.size());
+
+    // Compute the lower envelope of the parabolas rooted at voxels that have a label within the maximum distance.
+    // Boundaries[k] is the position where the parabola of Roots[k] becomes the lowest.
+    int numberOfRoots = 0;
+    for (int position = 0; position < numberOfVoxels; position++)
+      {
+      double squaredDistance = this->SquaredDistances[position];
+      if (squaredDistance > maximumSquaredDistance)
+        {
+        continue;
+        }
+      double boundary = -std::numeric_limits<double>::infinity();
+      while (numberOfRoots > 0)
+        {
+        int root = this->Roots[numberOfRoots - 1];
+        boundary = ((squaredDistance + squaredSpacing * position * position)
+          - (this->RootSquaredDistances[numberOfRoots - 1] + squaredSpacing * root * root))
+          / (2.0 * squaredSpacing * (position - root));
+        if (boundary > this->Boundaries[numberOfRoots - 1])
+          {
+          break;
+          }
+        // The last parabola is not part of the lower envelope
+        numberOfRoots--;
+        boundary = -std::numeric_limits<double>::infinity();
+        }
+      this->Roots[numberOfRoots] = position;
+      this->RootSquaredDistances[numberOfRoots] = squaredDistance;
+      this->RootLabels[numberOfRoots] = this->Labels[position];
+      this->Boundaries[numberOfRoots] = boundary;
+      numberOfRoots++;
+      }
+    if (numberOfRoots == 0)
+      {
+      return false;
+      }
 
-  // Get information to march through data
-  vtkIdType inInc0, inInc1, inInc2;
-  inData->GetIncrements(inInc0, inInc1, inInc2);
-  vtkIdType outIncX, outIncY, outIncZ;
-  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
-  int* kernelMiddle = self->GetKernelMiddle();
-  int* kernelSize = self->GetKernelSize();
+    // Sample the lower envelope. Voxels that remain farther than the maximum distance keep their background label.
+    int rootIndex = 0;
+    for (int position = 0; position < numberOfVoxels; position++)
+      {
+      while (rootIndex + 1 < numberOfRoots && this->Boundaries[rootIndex + 1] < position)
+        {
+        rootIndex++;
+        }
+      double offset = position - this->Roots[rootIndex];
+      double squaredDistance = this->RootSquaredDistances[rootIndex] + squaredSpacing * offset * offset;
+      if (squaredDistance > maximumSquaredDistance)
+        {
+        this->SquaredDistances[position] = NO_LABEL_SQUARED_DISTANCE;
+        }
+      else
+        {
+        this->SquaredDistances[position] = squaredDistance;
+        this->Labels[position] = this->RootLabels[rootIndex];
+        }
+      }
+    return true;
+    }
 
-  int numComp = inArray->GetNumberOfComponents();
+  std::vector<double> SquaredDistances;
+  std::vector<T> Labels;
 
-  // For looping through hood pixels
-  int hoodMin0 = outExt[0] - kernelMiddle[0];
-  int hoodMin1 = outExt[2] - kernelMiddle[1];
-  int hoodMin2 = outExt[4] - kernelMiddle[2];
-  int hoodMax0 = kernelSize[0] + hoodMin0 - 1;
-  int hoodMax1 = kernelSize[1] + hoodMin1 - 1;
-  int hoodMax2 = kernelSize[2] + hoodMin2 - 1;
+private:
+  std::vector<int> Roots;
+  std::vector<double> RootSquaredDistances;
+  std::vector<T> RootLabels;
+  std::vector<double> Boundaries;
+};
 
-  // Clip by the input image extent
-  int* inExt = inData->GetExtent();
-  hoodMin0 = (hoodMin0 > inExt[0]) ? hoodMin0 : inExt[0];
-  hoodMin1 = (hoodMin1 > inExt[2]) ? hoodMin1 : inExt[2];
-  hoodMin2 = (hoodMin2 > inExt[4]) ? hoodMin2 : inExt[4];
-  hoodMax0 = (hoodMax0 < inExt[1]) ? hoodMax0 : inExt[1];
-  hoodMax1 = (hoodMax1 < inExt[3]) ? hoodMax1 : inExt[3];
-  hoodMax2 = (hoodMax2 < inExt[5]) ? hoodMax2 : inExt[5];
-
-  // Save the starting neighborhood dimensions (2 loops only once)
-  int hoodStartMin0 = hoodMin0;
-  int hoodStartMax0 = hoodMax0;
-  int hoodStartMin1 = hoodMin1;
-  int hoodStartMax1 = hoodMax1;
-
-  // The portion of the output that needs no boundary computation.
-  int middleMin0 = inExt[0] + kernelMiddle[0];
-  int middleMax0 = inExt[1] - (kernelSize[0] - 1) + kernelMiddle[0];
-  int middleMin1 = inExt[2] + kernelMiddle[1];
-  int middleMax1 = inExt[3] - (kernelSize[1] - 1) + kernelMiddle[1];
-  int middleMin2 = inExt[4] + kernelMiddle[2];
-  int middleMax2 = inExt[5] - (kernelSize[2] - 1) + kernelMiddle[2];
-
-  unsigned long target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1) * (outExt[3] - outExt[2] + 1) / 50.0) + 1;
-  unsigned long count = 0;
+} // end anonymous namespace
 
+//------------------------------------------------------------------------------
+// Compute distance dilation of the entire input extent: set each background voxel to the label of the
+// nearest labelled voxel within the maximum distance. Components are processed independently.
+// The distance transform is separable, therefore lines along each axis are processed in parallel.
+// Voxels outside the mask are restored to their input value.
+template <typename T>
+void vtkImageLabelDilate3DComputeNearestLabels(vtkImageLabelDilate3D* self, vtkImageData* inData,
+  vtkDataArray* inArray, vtkImageData* maskData, vtkImageData* labelData)
+{
+  T* inPtr = static_cast<T*>(inArray->GetVoidPointer(0));
+  T* labelPtr = static_cast<T*>(labelData->GetScalarPointer());
+  int numComp = inArray->GetNumberOfComponents();
   T backgroundValue = static_cast<T>(self->GetBackgroundValue());
+  double maximumSquaredDistance = self->GetMaximumDistance() * self->GetMaximumDistance();
+  double* spacing = inData->GetSpacing();
+  int* inExt = inData->GetExtent();
+  int dimensions[3] = { inExt[1] - inExt[0] + 1, inExt[3] - inExt[2] + 1, inExt[5] - inExt[4] + 1 };
+  vtkIdType voxelIncrements[3] = { 1, dimensions[0], static_cast<vtkIdType>(dimensions[0]) * dimensions[1] };
+  vtkIdType numberOfVoxels = voxelIncrements[2] * dimensions[2];
 
-  // loop through pixel of output
-  inPtr = static_cast<T*>(inArray->GetVoidPointer((hoodMin0 - inExt[0]) * inInc0 +
-    (hoodMin1 - inExt[2]) * inInc1 + (hoodMin2 - inExt[4]) * inInc2));
-  T* inPtr2 = inPtr;
-  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+  std::vector<double> squaredDistances(numberOfVoxels);
+  for (int component = 0; component < numComp && !self->AbortExecute; component++)
     {
-    T* inPtr1 = inPtr2;
-    hoodMin1 = hoodStartMin1;
-    hoodMax1 = hoodStartMax1;
-    vtkIdType hoodCenterOffset2 = (hoodMax2 - hoodMin2 ) / 2 * inInc2;
-    for (int outIdx1 = outExt[2]; !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+    // Labelled voxels are at zero distance from a label
+    vtkSMPTools::For(0, numberOfVoxels, [&](vtkIdType beginVoxel, vtkIdType endVoxel)
       {
-      if (!id)
+      for (vtkIdType voxel = beginVoxel; voxel < endVoxel; voxel++)
         {
-        if (!(count % target))
-          {
-          self->UpdateProgress(count / (50.0 * target));
-          }
-        count++;
+        T label = inPtr[voxel * numComp + component];
+        labelPtr[voxel * numComp + component] = label;
+        squaredDistances[voxel] = (label == backgroundValue ? NO_LABEL_SQUARED_DISTANCE : 0.0);
         }
-      T* inPtr0 = inPtr1;
-      hoodMin0 = hoodStartMin0;
-      hoodMax0 = hoodStartMax0;
-      vtkIdType hoodCenterOffset1 = (hoodMax1 - hoodMin1) / 2 * inInc1;
-      T *tmpPtr0, *tmpPtr1, *tmpPtr2;
-      std::vector<T> workArray;
-      for (int outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
-        {
-        vtkIdType hoodCenterOffset = hoodCenterOffset2 + hoodCenterOffset1 + (hoodMax0 - hoodMin0) / 2 * inInc0;
+      });
 
-        for (int outIdxC = 0; outIdxC < numComp; outIdxC++)
+    for (int axis = 0; axis < 3; axis++)
+      {
+      // Lines are indexed by the voxel indices along the other two axes
+      int lineAxis1 = (axis == 0 ? 1 : 0);
+      int lineAxis2 = (axis == 2 ? 1 : 2);
+      vtkIdType numberOfLines = numberOfVoxels / dimensions[axis];
+      double squaredSpacing = spacing[axis] * spacing[axis];
+      vtkSMPTools::For(0, numberOfLines, [&](vtkIdType beginLine, vtkIdType endLine)
+        {
+        vtkLabelDistanceTransformLine<T> line(dimensions[axis]);
+        for (vtkIdType lineIndex = beginLine; lineIndex < endLine; lineIndex++)
           {
-          T centerVoxelValue = *(inPtr0 + hoodCenterOffset + outIdxC);
-          if (centerVoxelValue != backgroundValue)
+          vtkIdType firstVoxel = (lineIndex % dimensions[lineAxis1]) * voxelIncrements[lineAxis1]
+            + (lineIndex / dimensions[lineAxis1]) * voxelIncrements[lineAxis2];
+          vtkIdType voxel = firstVoxel;
+          for (int position = 0; position < dimensions[axis]; position++, voxel += voxelIncrements[axis])
             {
-            // Center voxel is not background voxel, leave it unchanged
-            *outPtr++ = centerVoxelValue;
-            continue;
+            line.SquaredDistances[position] = squaredDistances[voxel];
+            line.Labels[position] = labelPtr[voxel * numComp + component];
             }
-
-          // Center voxel is a background voxel, replace it with the most frequent non-background value
-          // in the neighborhood.
-
-          workArray.clear();
-          tmpPtr2 = inPtr0 + outIdxC;
-          for (int hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+          if (!line.Transform(squaredSpacing, maximumSquaredDistance))
             {
-            tmpPtr1 = tmpPtr2;
-            for (int hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
-              {
-              tmpPtr0 = tmpPtr1;
-              for (int hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
-                {
-                if (*tmpPtr0 != backgroundValue)
-                  {
-                  workArray.push_back(*tmpPtr0);
-                  }
-                tmpPtr0 += inInc0;
-                }
-              tmpPtr1 += inInc1;
-              }
-            tmpPtr2 += inInc2;
-            }
-
-          // Replace this pixel with the mode of the neighborhood
-          if (workArray.empty())
-            {
-            *outPtr++ = backgroundValue;
+            continue;
             }
-          else
+          voxel = firstVoxel;
+          for (int position = 0; position < dimensions[axis]; position++, voxel += voxelIncrements[axis])
             {
-            *outPtr++ = vtkComputeModeOfArray(workArray);
+            squaredDistances[voxel] = line.SquaredDistances[position];
+            labelPtr[voxel * numComp + component] = line.Labels[position];
             }
-        }
+          }
+        });
+      }
+    self->UpdateProgress(0.9 * (component + 1) / numComp);
+    }
 
-        // shift neighborhood considering boundaries
-        if (outIdx0 >= middleMin0)
+  if (maskData)
+    {
+    int* maskExt = maskData->GetExtent();
+    vtkIdType maskInc0 = maskData->GetNumberOfScalarComponents();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(dimensions[1]) * dimensions[2], [&](vtkIdType beginRow, vtkIdType endRow)
+      {
+      for (vtkIdType row = beginRow; row < endRow; row++)
+        {
+        // Voxels outside the mask extent are not in the mask
+        int idx1 = inExt[2] + static_cast<int>(row % dimensions[1]);
+        int idx2 = inExt[4] + static_cast<int>(row / dimensions[1]);
+        const unsigned char* maskRowPtr = nullptr;
+        if (idx1 >= maskExt[2] && idx1 <= maskExt[3] && idx2 >= maskExt[4] && idx2 <= maskExt[5])
           {
-          inPtr0 += inInc0;
-          ++hoodMin0;
+          maskRowPtr = static_cast<unsigned char*>(maskData->GetScalarPointer(maskExt[0], idx1, idx2));
           }
-        if (outIdx0 < middleMax0)
+        vtkIdType voxel = row * dimensions[0];
+        for (int idx0 = inExt[0]; idx0 <= inExt[1]; ++idx0, ++voxel)
           {
-          ++hoodMax0;
+          if (!maskRowPtr || idx0 < maskExt[0] || idx0 > maskExt[1] || maskRowPtr[(idx0 - maskExt[0]) * maskInc0] == 0)
+            {
+            std::copy(inPtr + voxel * numComp, inPtr + (voxel + 1) * numComp, labelPtr + voxel * numComp);
+            }
           }
-      }
-      // shift neighborhood considering boundaries
-      if (outIdx1 >= middleMin1)
-        {
-        inPtr1 += inInc1;
-        ++hoodMin1;
         }
-      if (outIdx1 < middleMax1)
-        {
-        ++hoodMax1;
-        }
-      outPtr += outIncY;
-      }
-    // shift neighborhood considering boundaries
-    if (outIdx2 >= middleMin2)
-      {
-      inPtr2 += inInc2;
-      ++hoodMin2;
-      }
-    if (outIdx2 < middleMax2)
+      });
+    }
+}
+
+//------------------------------------------------------------------------------
+bool vtkImageLabelDilate3D::UseInPlaceProcessing()
+{
+  return this->DilationMode == DILATION_MODE_KERNEL && this->Superclass::UseInPlaceProcessing();
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelDilate3D::RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (this->DilationMode == DILATION_MODE_KERNEL)
+    {
+    return this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
+    }
+
+  // Labels are propagated from voxels within the maximum distance
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  if (inInfo->Has(vtkDataObject::SPACING()))
+    {
+    inInfo->Get(vtkDataObject::SPACING(), spacing);
+    }
+  int inExt[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    double margin = (spacing[axis] != 0.0 ? std::ceil(this->MaximumDistance / std::fabs(spacing[axis])) : 0.0);
+    inExt[axis * 2] = static_cast<int>(std::max<double>(outExt[axis * 2] - margin, wholeExtent[axis * 2]));
+    inExt[axis * 2 + 1] = static_cast<int>(std::min<double>(outExt[axis * 2 + 1] + margin, wholeExtent[axis * 2 + 1]));
+    }
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+
+  // Mask is only needed where voxels may be changed
+  this->RequestMaskUpdateExtent(inputVector, outExt);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelDilate3D::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (this->DilationMode == DILATION_MODE_KERNEL)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkDataArray* inArray = this->GetInputArrayToProcess(0, inputVector);
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkImageData* input = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* mask = nullptr;
+  if (!this->GetMaskInputData(inputVector, mask))
+    {
+    return 0;
+    }
+  if (inArray && input)
+    {
+    // The distance transform needs the entire input extent, therefore it is computed here
+    // (using all threads) and threads only copy the result to their output extent.
+    this->NearestLabelImage = vtkSmartPointer<vtkImageData>::New();
+    this->NearestLabelImage->SetExtent(input->GetExtent());
+    this->NearestLabelImage->AllocateScalars(inArray->GetDataType(), inArray->GetNumberOfComponents());
+    switch (inArray->GetDataType())
       {
-      ++hoodMax2;
+      vtkTemplateMacro(vtkImageLabelDilate3DComputeNearestLabels<VTK_TT>(this, input, inArray, mask,
+        this->NearestLabelImage));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+        this->NearestLabelImage = nullptr;
+        return 0;
       }
-    outPtr += outIncZ;
     }
+  // Kernel neighborhood processing is skipped, threads only copy the nearest labels
+  int result = this->vtkImageSpatialAlgorithm::RequestData(request, inputVector, outputVector);
+  this->NearestLabelImage = nullptr;
+  return result;
 }
 
 //------------------------------------------------------------------------------
-// This method contains the first switch statement that calls the correct
-// templated function for the input and output region types.
-void vtkImageLabelDilate3D::ThreadedRequestData(vtkInformation* vtkNotUsed(request),
-  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector),
+void vtkImageLabelDilate3D::ThreadedRequestData(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector,
   vtkImageData*** inData, vtkImageData** outData, int outExt[6], int id)
 {
-  void* inPtr;
-  void* outPtr = outData[0]->GetScalarPointerForExtent(outExt);
+  if (this->DilationMode == DILATION_MODE_KERNEL)
+    {
+    this->Superclass::ThreadedRequestData(request, inputVector, outputVector, inData, outData, outExt, id);
+    return;
+    }
 
   vtkDataArray* inArray = this->GetInputArrayToProcess(0, inputVector);
+  if (!inArray)
+    {
+    vtkErrorMacro(<< "Execute: No input array to process");
+    return;
+    }
   if (id == 0)
     {
     outData[0]->GetPointData()->GetScalars()->SetName(inArray->GetName());
     }
-
-  inPtr = inArray->GetVoidPointer(0);
-
-  // this filter expects that input is the same type as output.
+  if (!this->NearestLabelImage)
+    {
+    vtkErrorMacro(<< "Execute: Nearest labels are not computed");
+    return;
+    }
   if (inArray->GetDataType() != outData[0]->GetScalarType())
     {
     vtkErrorMacro(<< "Execute: input data type, " << inArray->GetDataType()
@@ -288,12 +397,15 @@ void vtkImageLabelDilate3D::ThreadedRequestData(vtkInformation* vtkNotUsed(reque
     return;
     }
 
-  switch (inArray->GetDataType())
+  // Copy the requested region of the precomputed nearest labels
+  std::size_t rowSize = static_cast<std::size_t>(outExt[1] - outExt[0] + 1) * inArray->GetNumberOfComponents()
+    * inArray->GetDataTypeSize();
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
     {
-    vtkTemplateMacro(vtkImageLabelDilate3DExecute(this, inData[0][0], static_cast<VTK_TT*>(inPtr),
-      outData[0], static_cast<VTK_TT*>(outPtr), outExt, id, inArray));
-    default:
-      vtkErrorMacro(<< "Execute: Unknown input ScalarType");
-      return;
+    for (int outIdx1 = outExt[2]; outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      memcpy(outData[0]->GetScalarPointer(outExt[0], outIdx1, outIdx2),
+        this->NearestLabelImage->GetScalarPointer(outExt[0], outIdx1, outIdx2), rowSize);
+      }
     }
 }
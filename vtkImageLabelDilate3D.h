@@ -5,7 +5,19 @@
  * @brief   Label image dilation filter
  *
  * vtkImageLabelDilate3D dilates a labelmap image by replacing each background voxel with the
- * most dominant label voxel in its neighborhood.
+ * most dominant label voxel in its neighborhood. If multiple labels occur the same number of times
+ * in the neighborhood then the smallest label value is used.
+ *
+ * Kernel neighborhood processing, masking, processing extent, and in-place processing are implemented
+ * in vtkImageLabelNeighborhoodFilter3D. Regions where dilation cannot change any voxels (regions inside
+ * a label or far from all labels) are copied to the output without processing.
+ *
+ * In distance dilation mode each background voxel gets the label of its nearest labelled voxel,
+ * if that voxel is within the maximum distance (in physical units, taking image spacing into account).
+ * Nearest labels are computed by a separable Euclidean distance transform, therefore computation time
+ * does not depend on the dilation distance. This mode is preferable for dilating by many voxels.
+ *
+ * @sa vtkImageLabelNeighborhoodFilter3D vtkImageLabelMajorityVote3D
  *
  * @par Acknowledgments:
  * This class was developed by Andras Lasso PerkLab, Queen's University
@@ -15,19 +27,49 @@
 #define vtkImageLabelDilate3D_h
 
 #include "vtkAddonExport.h" // For export macro
-#include "vtkImageSpatialAlgorithm.h"
+#include "vtkImageLabelNeighborhoodFilter3D.h"
+#include "vtkSmartPointer.h" // For NearestLabelImage
 
-class VTK_ADDON_EXPORT vtkImageLabelDilate3D : public vtkImageSpatialAlgorithm
+class VTK_ADDON_EXPORT vtkImageLabelDilate3D : public vtkImageLabelNeighborhoodFilter3D
 {
 public:
   static vtkImageLabelDilate3D* New();
-  vtkTypeMacro(vtkImageLabelDilate3D, vtkImageSpatialAlgorithm);
+  vtkTypeMacro(vtkImageLabelDilate3D, vtkImageLabelNeighborhoodFilter3D);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  enum
+    {
+    DILATION_MODE_KERNEL,
+    DILATION_MODE_DISTANCE,
+    DILATION_MODE_LAST // this must be the last
+    };
+
+  ///@{
   /**
-   * Size of the neighborhood where the most dominant label value will be searched for.
+   * Set/Get how background voxels are filled.
+   * DILATION_MODE_KERNEL: the most dominant label in the kernel neighborhood is used.
+   * DILATION_MODE_DISTANCE: the label of the nearest labelled voxel within MaximumDistance is used.
+   * If several labelled voxels are at the same distance then one of them is chosen consistently.
+   * Kernel size and in-place processing are only used in DILATION_MODE_KERNEL.
+   * Default is DILATION_MODE_KERNEL.
    */
-  void SetKernelSize(int size0, int size1, int size2);
+  vtkSetClampMacro(DilationMode, int, DILATION_MODE_KERNEL, DILATION_MODE_LAST - 1);
+  vtkGetMacro(DilationMode, int);
+  void SetDilationModeToKernel() { this->SetDilationMode(DILATION_MODE_KERNEL); }
+  void SetDilationModeToDistance() { this->SetDilationMode(DILATION_MODE_DISTANCE); }
+  static const char* GetDilationModeAsString(int dilationMode);
+  static int GetDilationModeFromString(const char* dilationModeStr);
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the maximum distance (in physical units) of dilation in DILATION_MODE_DISTANCE.
+   * Background voxels that are farther from all labelled voxels are left unchanged.
+   * Default value is 5.
+   */
+  vtkSetMacro(MaximumDistance, double);
+  vtkGetMacro(MaximumDistance, double);
+  ///@}
 
   ///@{
   /**
@@ -42,7 +84,19 @@ protected:
   vtkImageLabelDilate3D();
   ~vtkImageLabelDilate3D() override;
 
-  double BackgroundValue;
+  int DilationMode = DILATION_MODE_KERNEL;
+  double MaximumDistance = 5.0;
+
+  // Output of distance dilation for the entire input extent, computed before the processing is split between threads
+  vtkSmartPointer<vtkImageData> NearestLabelImage;
+
+  bool UseInPlaceProcessing() override;
+
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
 
   void ThreadedRequestData(vtkInformation* request, vtkInformationVector** inputVector,
     vtkInformationVector* outputVector, vtkImageData*** inData, vtkImageData** outData,
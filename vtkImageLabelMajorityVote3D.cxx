@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vtkImageLabelMajorityVote3D.h"
+
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkImageLabelMajorityVote3D);
+
+//------------------------------------------------------------------------------
+vtkImageLabelMajorityVote3D::vtkImageLabelMajorityVote3D()
+{
+  this->MajorityVote = true;
+}
+
+//------------------------------------------------------------------------------
+vtkImageLabelMajorityVote3D::~vtkImageLabelMajorityVote3D() = default;
+
+//------------------------------------------------------------------------------
+void vtkImageLabelMajorityVote3D::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+/**
+ * @class   vtkImageLabelMajorityVote3D
+ * @brief   Label image smoothing filter
+ *
+ * vtkImageLabelMajorityVote3D smooths a labelmap image by replacing each voxel with the most frequent value
+ * in its kernel neighborhood (majority vote, the label image equivalent of a median filter). Background voxels
+ * are counted as any other label, therefore jagged boundaries, small islands, and small holes are removed.
+ * If multiple values occur the same number of times in the neighborhood then the smallest value is used.
+ * All labels are processed in a single pass, therefore computation time does not grow with the number of labels.
+ *
+ * Kernel neighborhood processing, masking, processing extent, and in-place processing are implemented
+ * in vtkImageLabelNeighborhoodFilter3D. Regions where all voxels within kernel reach have the same value
+ * are copied to the output without processing.
+ *
+ * @sa vtkImageLabelNeighborhoodFilter3D vtkImageLabelDilate3D
+ */
+
+#ifndef vtkImageLabelMajorityVote3D_h
+#define vtkImageLabelMajorityVote3D_h
+
+#include "vtkAddonExport.h" // For export macro
+#include "vtkImageLabelNeighborhoodFilter3D.h"
+
+class VTK_ADDON_EXPORT vtkImageLabelMajorityVote3D : public vtkImageLabelNeighborhoodFilter3D
+{
+public:
+  static vtkImageLabelMajorityVote3D* New();
+  vtkTypeMacro(vtkImageLabelMajorityVote3D, vtkImageLabelNeighborhoodFilter3D);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+protected:
+  vtkImageLabelMajorityVote3D();
+  ~vtkImageLabelMajorityVote3D() override;
+
+private:
+  vtkImageLabelMajorityVote3D(const vtkImageLabelMajorityVote3D&) = delete;
+  void operator=(const vtkImageLabelMajorityVote3D&) = delete;
+};
+
+#endif
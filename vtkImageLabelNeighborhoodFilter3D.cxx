@@ -0,0 +1,1175 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vtkImageLabelNeighborhoodFilter3D.h"
+#include "vtkAddonMathUtilities.h"
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+vtkImageLabelNeighborhoodFilter3D::vtkImageLabelNeighborhoodFilter3D()
+{
+  this->SetKernelSize(1, 1, 1);
+  this->HandleBoundaries = 1;
+  this->SetNumberOfInputPorts(2);
+}
+
+//------------------------------------------------------------------------------
+vtkImageLabelNeighborhoodFilter3D::~vtkImageLabelNeighborhoodFilter3D() = default;
+
+//------------------------------------------------------------------------------
+void vtkImageLabelNeighborhoodFilter3D::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "InPlace: " << (this->InPlace ? "true" : "false") << endl;
+  os << indent << "ProcessingExtent: (" << this->ProcessingExtent[0] << ", " << this->ProcessingExtent[1] << ", "
+     << this->ProcessingExtent[2] << ", " << this->ProcessingExtent[3] << ", " << this->ProcessingExtent[4] << ", "
+     << this->ProcessingExtent[5] << ")" << endl;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelNeighborhoodFilter3D::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 0)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    }
+  else if (port == 1)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+    }
+  else
+    {
+    vtkErrorMacro("Cannot set input info for port " << port);
+    return 0;
+    }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkImageLabelNeighborhoodFilter3D::SetMaskInputData(vtkImageData* mask)
+{
+  this->SetInputData(1, mask);
+}
+
+//------------------------------------------------------------------------------
+void vtkImageLabelNeighborhoodFilter3D::SetMaskInputConnection(vtkAlgorithmOutput* maskConnection)
+{
+  this->SetInputConnection(1, maskConnection);
+}
+
+//------------------------------------------------------------------------------
+vtkImageData* vtkImageLabelNeighborhoodFilter3D::GetMaskInput()
+{
+  if (this->GetNumberOfInputConnections(1) < 1)
+    {
+    return nullptr;
+    }
+  return vtkImageData::SafeDownCast(this->GetInputDataObject(1, 0));
+}
+
+//------------------------------------------------------------------------------
+// This method sets the size of the neighborhood.  It also sets the
+// default middle of the neighborhood
+void vtkImageLabelNeighborhoodFilter3D::SetKernelSize(int size0, int size1, int size2)
+{
+  if (this->KernelSize[0] == size0 && this->KernelSize[1] == size1 && this->KernelSize[2] == size2)
+    {
+    // no change
+    return;
+    }
+
+  // Set the kernel size and middle
+  this->KernelSize[0] = size0;
+  this->KernelMiddle[0] = size0 / 2;
+  this->KernelSize[1] = size1;
+  this->KernelMiddle[1] = size1 / 2;
+  this->KernelSize[2] = size2;
+  this->KernelMiddle[2] = size2 / 2;
+
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+bool vtkImageLabelNeighborhoodFilter3D::UseInPlaceProcessing()
+{
+  return this->InPlace;
+}
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Number of occurrences of each label value in a neighborhood.
+// A neighborhood typically contains only a few different labels, therefore counts are stored
+// in a flat array and looked up by linear search. After the first few voxels no memory allocation
+// is needed when labels are added or removed.
+template <typename T>
+class vtkLabelHistogram
+{
+public:
+  void Clear()
+    {
+    this->Bins.clear();
+    this->ModeCount = 0;
+    this->ModeValid = true;
+    }
+
+  bool IsEmpty() const
+    {
+    return this->Bins.empty();
+    }
+
+  void Add(T label)
+    {
+    auto bin = this->FindBin(label);
+    int count = 1;
+    if (bin == this->Bins.end())
+      {
+      this->Bins.emplace_back(label, 1);
+      }
+    else
+      {
+      count = ++bin->second;
+      }
+    if (this->ModeValid && (count > this->ModeCount || (count == this->ModeCount && label < this->ModeLabel)))
+      {
+      this->ModeLabel = label;
+      this->ModeCount = count;
+      }
+    }
+
+  // The label must have been added before.
+  void Remove(T label)
+    {
+    auto bin = this->FindBin(label);
+    if (--bin->second == 0)
+      {
+      *bin = this->Bins.back();
+      this->Bins.pop_back();
+      }
+    if (label == this->ModeLabel)
+      {
+      // Another label may have become the most frequent, find it when it is needed
+      this->ModeValid = false;
+      }
+    }
+
+  // Returns the most frequent label. If multiple labels occur the same number of times
+  // then the smallest label value is returned. The histogram must not be empty.
+  T GetMode()
+    {
+    if (!this->ModeValid)
+      {
+      this->ModeCount = 0;
+      for (const auto& bin : this->Bins)
+        {
+        if (bin.second > this->ModeCount || (bin.second == this->ModeCount && bin.first < this->ModeLabel))
+          {
+          this->ModeLabel = bin.first;
+          this->ModeCount = bin.second;
+          }
+        }
+      this->ModeValid = true;
+      }
+    return this->ModeLabel;
+    }
+
+private:
+  typename std::vector<std::pair<T, int>>::iterator FindBin(T label)
+    {
+    return std::find_if(this->Bins.begin(), this->Bins.end(),
+      [label](const std::pair<T, int>& bin) { return bin.first == label; });
+    }
+
+  std::vector<std::pair<T, int>> Bins;
+  T ModeLabel = 0;
+  int ModeCount = 0;
+  bool ModeValid = true;
+};
+
+//------------------------------------------------------------------------------
+// Maximum number of bins in a dense label histogram (for each component in each thread).
+const long long DENSE_LABEL_HISTOGRAM_MAX_BINS = 65536;
+
+//------------------------------------------------------------------------------
+// Number of occurrences of each label value in a neighborhood, for integer labels in a small range.
+// Counts are stored in an array indexed by label value. Labels that are present in the neighborhood
+// are kept in a list, so that clearing the histogram and finding the most frequent label
+// only touch the bins that are actually used.
+template <typename T>
+class vtkDenseLabelHistogram
+{
+public:
+  void Initialize(long long minimumLabel, long long maximumLabel)
+    {
+    this->MinimumLabel = minimumLabel;
+    this->Counts.assign(maximumLabel - minimumLabel + 1, 0);
+    this->UsedLabelPositions.assign(maximumLabel - minimumLabel + 1, 0);
+    this->UsedLabels.clear();
+    this->UsedLabels.reserve(this->Counts.size());
+    this->ModeCount = 0;
+    this->ModeValid = true;
+    }
+
+  void Clear()
+    {
+    for (T label : this->UsedLabels)
+      {
+      this->Counts[static_cast<long long>(label) - this->MinimumLabel] = 0;
+      }
+    this->UsedLabels.clear();
+    this->ModeCount = 0;
+    this->ModeValid = true;
+    }
+
+  bool IsEmpty() const
+    {
+    return this->UsedLabels.empty();
+    }
+
+  void Add(T label)
+    {
+    long long binIndex = static_cast<long long>(label) - this->MinimumLabel;
+    int count = ++this->Counts[binIndex];
+    if (count == 1)
+      {
+      this->UsedLabelPositions[binIndex] = this->UsedLabels.size();
+      this->UsedLabels.push_back(label);
+      }
+    if (this->ModeValid && (count > this->ModeCount || (count == this->ModeCount && label < this->ModeLabel)))
+      {
+      this->ModeLabel = label;
+      this->ModeCount = count;
+      }
+    }
+
+  // The label must have been added before.
+  void Remove(T label)
+    {
+    long long binIndex = static_cast<long long>(label) - this->MinimumLabel;
+    if (--this->Counts[binIndex] == 0)
+      {
+      // Move the last used label to the position of the removed label
+      std::size_t position = this->UsedLabelPositions[binIndex];
+      T lastLabel = this->UsedLabels.back();
+      this->UsedLabels[position] = lastLabel;
+      this->UsedLabelPositions[static_cast<long long>(lastLabel) - this->MinimumLabel] = position;
+      this->UsedLabels.pop_back();
+      }
+    if (label == this->ModeLabel)
+      {
+      // Another label may have become the most frequent, find it when it is needed
+      this->ModeValid = false;
+      }
+    }
+
+  // Returns the most frequent label. If multiple labels occur the same number of times
+  // then the smallest label value is returned. The histogram must not be empty.
+  T GetMode()
+    {
+    if (!this->ModeValid)
+      {
+      this->ModeCount = 0;
+      for (T label : this->UsedLabels)
+        {
+        int count = this->Counts[static_cast<long long>(label) - this->MinimumLabel];
+        if (count > this->ModeCount || (count == this->ModeCount && label < this->ModeLabel))
+          {
+          this->ModeLabel = label;
+          this->ModeCount = count;
+          }
+        }
+      this->ModeValid = true;
+      }
+    return this->ModeLabel;
+    }
+
+private:
+  long long MinimumLabel = 0;
+  std::vector<int> Counts;
+  std::vector<std::size_t> UsedLabelPositions;
+  std::vector<T> UsedLabels;
+  T ModeLabel = 0;
+  int ModeCount = 0;
+  bool ModeValid = true;
+};
+
+//------------------------------------------------------------------------------
+// Size of blocks (along each axis) in the block map that is used for skipping regions
+// where the filter cannot change any voxels.
+const int LABEL_BLOCK_SIZE = 16;
+const unsigned char LABEL_BLOCK_HAS_LABEL = 1;
+const unsigned char LABEL_BLOCK_HAS_BACKGROUND = 2;
+// Block contents in majority vote mode
+const unsigned char LABEL_BLOCK_HAS_EDITABLE = 4;
+const unsigned char LABEL_BLOCK_NOT_UNIFORM = 8;
+
+//------------------------------------------------------------------------------
+// Get the region of the extent that is processed. If the processing extent is empty then the entire extent is processed.
+// Returns false if no voxels are processed.
+bool vtkImageLabelNeighborhoodFilter3DClipExtent(const int processingExtent[6], const int extent[6],
+  int clippedExtent[6])
+{
+  bool processingExtentValid = (processingExtent[0] <= processingExtent[1] && processingExtent[2] <= processingExtent[3]
+    && processingExtent[4] <= processingExtent[5]);
+  bool empty = false;
+  for (int axis = 0; axis < 3; axis++)
+    {
+    clippedExtent[axis * 2] = extent[axis * 2];
+    clippedExtent[axis * 2 + 1] = extent[axis * 2 + 1];
+    if (processingExtentValid)
+      {
+      clippedExtent[axis * 2] = std::max(clippedExtent[axis * 2], processingExtent[axis * 2]);
+      clippedExtent[axis * 2 + 1] = std::min(clippedExtent[axis * 2 + 1], processingExtent[axis * 2 + 1]);
+      }
+    empty = empty || (clippedExtent[axis * 2] > clippedExtent[axis * 2 + 1]);
+    }
+  return !empty;
+}
+
+//------------------------------------------------------------------------------
+// Access to the mask values along image rows. Voxels outside the mask extent are not in the mask.
+// If there is no mask then all voxels are in the mask.
+class vtkLabelMaskRow
+{
+public:
+  vtkLabelMaskRow(vtkImageData* maskData)
+    : MaskData(maskData)
+    {
+    if (this->MaskData)
+      {
+      this->MaskData->GetExtent(this->MaskExtent);
+      vtkIdType maskInc1, maskInc2;
+      this->MaskData->GetIncrements(this->MaskInc0, maskInc1, maskInc2);
+      }
+    }
+
+  void SetRow(int idx1, int idx2)
+    {
+    if (!this->MaskData)
+      {
+      return;
+      }
+    if (idx1 < this->MaskExtent[2] || idx1 > this->MaskExtent[3] || idx2 < this->MaskExtent[4] || idx2 > this->MaskExtent[5])
+      {
+      this->RowPtr = nullptr;
+      return;
+      }
+    this->RowPtr = static_cast<unsigned char*>(this->MaskData->GetScalarPointer(this->MaskExtent[0], idx1, idx2));
+    }
+
+  bool IsInside(int idx0) const
+    {
+    if (!this->MaskData)
+      {
+      return true;
+      }
+    return this->RowPtr && idx0 >= this->MaskExtent[0] && idx0 <= this->MaskExtent[1]
+      && this->RowPtr[(idx0 - this->MaskExtent[0]) * this->MaskInc0] != 0;
+    }
+
+private:
+  vtkImageData* MaskData;
+  int MaskExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkIdType MaskInc0 = 1;
+  const unsigned char* RowPtr = nullptr;
+};
+
+} // end anonymous namespace
+
+//------------------------------------------------------------------------------
+bool vtkImageLabelNeighborhoodFilter3D::GetMaskInputData(vtkInformationVector** inputVector, vtkImageData*& mask)
+{
+  mask = nullptr;
+  if (inputVector[1]->GetNumberOfInformationObjects() < 1)
+    {
+    return true;
+    }
+  mask = vtkImageData::SafeDownCast(inputVector[1]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+  if (mask && mask->GetScalarType() != VTK_UNSIGNED_CHAR)
+    {
+    vtkErrorMacro(<< "Execute: mask scalar type must be unsigned char, got " << mask->GetScalarType());
+    return false;
+    }
+  // Mask is applied voxel by voxel, therefore it must be aligned with the input
+  vtkImageData* input = vtkImageData::SafeDownCast(
+    inputVector[0]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+  if (mask && input && !vtkAddonMathUtilities::ImageGeometryAreEqual(input, mask))
+    {
+    vtkErrorMacro(<< "Execute: mask origin, spacing, or axis directions differ from the input");
+    return false;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkImageLabelNeighborhoodFilter3D::RequestMaskUpdateExtent(vtkInformationVector** inputVector, const int extent[6])
+{
+  if (inputVector[1]->GetNumberOfInformationObjects() < 1)
+    {
+    return;
+    }
+  vtkInformation* maskInfo = inputVector[1]->GetInformationObject(0);
+  int maskWholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  maskInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), maskWholeExtent);
+  int maskExt[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkImageLabelNeighborhoodFilter3DClipExtent(extent, maskWholeExtent, maskExt))
+    {
+    // mask does not overlap with the output, do not request any mask voxels
+    for (int axis = 0; axis < 3; axis++)
+      {
+      maskExt[axis * 2] = maskWholeExtent[axis * 2];
+      maskExt[axis * 2 + 1] = maskWholeExtent[axis * 2] - 1;
+      }
+    }
+  maskInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), maskExt, 6);
+}
+
+//------------------------------------------------------------------------------
+// Find blocks of the input where the filter may change voxels. In dilation mode these are blocks that contain
+// background voxels inside the mask and have labelled voxels within kernel reach. All other blocks are the same
+// in the output as in the input (they contain only labelled voxels or only background voxels far from any label).
+// In majority vote mode a block is active if it contains voxels inside the mask and the voxels within
+// kernel reach are not all the same. All components are considered together.
+template <typename T>
+void vtkImageLabelNeighborhoodFilter3DFindActiveBlocks(vtkImageLabelNeighborhoodFilter3D* self, vtkImageData* inData,
+  vtkDataArray* inArray, vtkImageData* maskData, vtkImageData* activeBlocks, double backgroundValueDouble,
+  bool majorityVote)
+{
+  T* inPtr = static_cast<T*>(inArray->GetVoidPointer(0));
+  int numComp = inArray->GetNumberOfComponents();
+  T backgroundValue = static_cast<T>(backgroundValueDouble);
+  int* kernelMiddle = self->GetKernelMiddle();
+  int* kernelSize = self->GetKernelSize();
+  int* inExt = inData->GetExtent();
+  vtkIdType inInc0, inInc1, inInc2;
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+
+  int numberOfBlocks[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    numberOfBlocks[axis] = (inExt[axis * 2 + 1] - inExt[axis * 2] + LABEL_BLOCK_SIZE) / LABEL_BLOCK_SIZE;
+    }
+  // Block map geometry is defined in the voxel index space of the input
+  activeBlocks->SetExtent(0, numberOfBlocks[0] - 1, 0, numberOfBlocks[1] - 1, 0, numberOfBlocks[2] - 1);
+  activeBlocks->SetOrigin(inExt[0], inExt[2], inExt[4]);
+  activeBlocks->SetSpacing(LABEL_BLOCK_SIZE, LABEL_BLOCK_SIZE, LABEL_BLOCK_SIZE);
+  activeBlocks->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* activeBlocksPtr = static_cast<unsigned char*>(activeBlocks->GetScalarPointer());
+  vtkIdType totalNumberOfBlocks = static_cast<vtkIdType>(numberOfBlocks[0]) * numberOfBlocks[1] * numberOfBlocks[2];
+
+  // Range of voxel indices along an axis in a block
+  auto getBlockVoxelRange = [&](int axis, int blockIdx, int& minIdx, int& maxIdx)
+    {
+    minIdx = inExt[axis * 2] + blockIdx * LABEL_BLOCK_SIZE;
+    maxIdx = std::min(minIdx + LABEL_BLOCK_SIZE - 1, inExt[axis * 2 + 1]);
+    };
+  auto getBlockIndex = [&](vtkIdType block, int blockIdx[3])
+    {
+    blockIdx[0] = static_cast<int>(block % numberOfBlocks[0]);
+    blockIdx[1] = static_cast<int>((block / numberOfBlocks[0]) % numberOfBlocks[1]);
+    blockIdx[2] = static_cast<int>(block / (static_cast<vtkIdType>(numberOfBlocks[0]) * numberOfBlocks[1]));
+    };
+  // First voxel of a block, used as reference value for checking if a block is uniform
+  auto getBlockFirstVoxel = [&](vtkIdType block)
+    {
+    int blockIdx[3] = { 0, 0, 0 };
+    getBlockIndex(block, blockIdx);
+    return inPtr + blockIdx[0] * LABEL_BLOCK_SIZE * inInc0 + blockIdx[1] * LABEL_BLOCK_SIZE * inInc1
+      + blockIdx[2] * LABEL_BLOCK_SIZE * inInc2;
+    };
+  auto isSameVoxelValue = [numComp](const T* voxel1, const T* voxel2)
+    {
+    for (int idxC = 0; idxC < numComp; idxC++)
+      {
+      if (voxel1[idxC] != voxel2[idxC])
+        {
+        return false;
+        }
+      }
+    return true;
+    };
+  const unsigned char allContents = (majorityVote ? (LABEL_BLOCK_HAS_EDITABLE | LABEL_BLOCK_NOT_UNIFORM)
+                                                  : (LABEL_BLOCK_HAS_LABEL | LABEL_BLOCK_HAS_BACKGROUND));
+
+  // Find which blocks contain labelled and background voxels (or editable and differing voxels)
+  std::vector<unsigned char> blockContents(totalNumberOfBlocks, 0);
+  vtkSMPTools::For(0, totalNumberOfBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+    {
+    for (vtkIdType block = beginBlock; block < endBlock; block++)
+      {
+      int blockIdx[3] = { 0, 0, 0 };
+      getBlockIndex(block, blockIdx);
+      const T* firstVoxelPtr = getBlockFirstVoxel(block);
+      int blockExt[6] = { 0, -1, 0, -1, 0, -1 };
+      for (int axis = 0; axis < 3; axis++)
+        {
+        getBlockVoxelRange(axis, blockIdx[axis], blockExt[axis * 2], blockExt[axis * 2 + 1]);
+        }
+      unsigned char contents = 0;
+      vtkLabelMaskRow maskRow(maskData);
+      for (int idx2 = blockExt[4]; idx2 <= blockExt[5]; ++idx2)
+        {
+        for (int idx1 = blockExt[2]; idx1 <= blockExt[3]; ++idx1)
+          {
+          maskRow.SetRow(idx1, idx2);
+          T* rowPtr = inPtr + (blockExt[0] - inExt[0]) * inInc0 + (idx1 - inExt[2]) * inInc1 + (idx2 - inExt[4]) * inInc2;
+          for (int idx0 = blockExt[0]; idx0 <= blockExt[1]; ++idx0, rowPtr += inInc0)
+            {
+            if (majorityVote)
+              {
+              contents |= (maskRow.IsInside(idx0) ? LABEL_BLOCK_HAS_EDITABLE : 0);
+              contents |= (isSameVoxelValue(rowPtr, firstVoxelPtr) ? 0 : LABEL_BLOCK_NOT_UNIFORM);
+              continue;
+              }
+            // Background voxels outside the mask are not changed, therefore they are ignored
+            unsigned char backgroundContents = (maskRow.IsInside(idx0) ? LABEL_BLOCK_HAS_BACKGROUND : 0);
+            for (int idxC = 0; idxC < numComp; idxC++)
+              {
+              contents |= (rowPtr[idxC] == backgroundValue ? backgroundContents : LABEL_BLOCK_HAS_LABEL);
+              }
+            }
+          }
+        if (contents == allContents)
+          {
+          // no need to check the rest of the block
+          break;
+          }
+        }
+      blockContents[block] = contents;
+      }
+    });
+
+  // A block is active if it contains background voxels and there are labelled voxels
+  // in the neighborhood of any of its voxels. In majority vote mode a block is active if it contains
+  // editable voxels and the neighborhood contains a non-uniform block or a block with a different value.
+  vtkSMPTools::For(0, totalNumberOfBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+    {
+    for (vtkIdType block = beginBlock; block < endBlock; block++)
+      {
+      activeBlocksPtr[block] = 0;
+      if (!(blockContents[block] & (majorityVote ? LABEL_BLOCK_HAS_EDITABLE : LABEL_BLOCK_HAS_BACKGROUND)))
+        {
+        continue;
+        }
+      int blockIdx[3] = { 0, 0, 0 };
+      getBlockIndex(block, blockIdx);
+      const T* firstVoxelPtr = getBlockFirstVoxel(block);
+      int hoodBlockMin[3] = { 0, 0, 0 };
+      int hoodBlockMax[3] = { 0, 0, 0 };
+      for (int axis = 0; axis < 3; axis++)
+        {
+        int minIdx = 0;
+        int maxIdx = 0;
+        getBlockVoxelRange(axis, blockIdx[axis], minIdx, maxIdx);
+        int hoodMinIdx = std::max(minIdx - kernelMiddle[axis], inExt[axis * 2]);
+        int hoodMaxIdx = std::min(maxIdx - kernelMiddle[axis] + kernelSize[axis] - 1, inExt[axis * 2 + 1]);
+        hoodBlockMin[axis] = (hoodMinIdx - inExt[axis * 2]) / LABEL_BLOCK_SIZE;
+        hoodBlockMax[axis] = (hoodMaxIdx - inExt[axis * 2]) / LABEL_BLOCK_SIZE;
+        }
+      for (int hoodBlock2 = hoodBlockMin[2]; hoodBlock2 <= hoodBlockMax[2] && !activeBlocksPtr[block]; ++hoodBlock2)
+        {
+        for (int hoodBlock1 = hoodBlockMin[1]; hoodBlock1 <= hoodBlockMax[1] && !activeBlocksPtr[block]; ++hoodBlock1)
+          {
+          for (int hoodBlock0 = hoodBlockMin[0]; hoodBlock0 <= hoodBlockMax[0]; ++hoodBlock0)
+            {
+            vtkIdType hoodBlock =
+              hoodBlock0 + (hoodBlock1 + static_cast<vtkIdType>(hoodBlock2) * numberOfBlocks[1]) * numberOfBlocks[0];
+            bool canChange = false;
+            if (majorityVote)
+              {
+              canChange = (blockContents[hoodBlock] & LABEL_BLOCK_NOT_UNIFORM)
+                || !isSameVoxelValue(getBlockFirstVoxel(hoodBlock), firstVoxelPtr);
+              }
+            else
+              {
+              canChange = (blockContents[hoodBlock] & LABEL_BLOCK_HAS_LABEL) != 0;
+              }
+            if (canChange)
+              {
+              activeBlocksPtr[block] = 1;
+              break;
+              }
+            }
+          }
+        }
+      }
+    });
+}
+
+//------------------------------------------------------------------------------
+// Replace voxels with the most frequent value in their neighborhood, using the specified histograms
+// (one for each component) for counting values in the neighborhood. Histograms are provided by the caller,
+// so that memory that is needed for counting is allocated only once for each thread.
+// In dilation mode only background voxels inside the mask are changed. In majority vote mode all voxels
+// inside the mask are replaced by the most frequent value in their neighborhood, background voxels are counted
+// as well.
+// If active blocks are specified then voxels in inactive blocks are copied from the input.
+template <typename T, typename HistogramType>
+void vtkImageLabelNeighborhoodFilter3DExecute(vtkImageLabelNeighborhoodFilter3D* self, vtkImageData* inData, T* inPtr,
+  vtkImageData* outData, T* outPtr, int outExt[6], int id, vtkDataArray* inArray, vtkImageData* maskData,
+  vtkImageData* activeBlocks, double backgroundValueDouble, bool majorityVote, std::vector<HistogramType>& histograms)
+{
+
+  // Get information to march through data
+  vtkIdType inInc0, inInc1, inInc2;
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  vtkIdType outIncX, outIncY, outIncZ;
+  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
+  int* kernelMiddle = self->GetKernelMiddle();
+  int* kernelSize = self->GetKernelSize();
+  int* inExt = inData->GetExtent();
+
+  int numComp = inArray->GetNumberOfComponents();
+
+  unsigned long target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1) * (outExt[3] - outExt[2] + 1) / 50.0) + 1;
+  unsigned long count = 0;
+
+  T backgroundValue = static_cast<T>(backgroundValueDouble);
+
+  // Pointer to the first voxel of the input extent
+  inPtr = static_cast<T*>(inArray->GetVoidPointer(0));
+
+  // Label counts in the current neighborhood are stored in the histograms, for each component.
+  // The neighborhood is a box that slides along the x axis: when moving to the next voxel,
+  // the column of voxels entering the box is added and the column leaving the box is removed.
+  vtkLabelMaskRow maskRow(maskData);
+  int hoodMin1 = 0;
+  int hoodMax1 = 0;
+  int hoodMin2 = 0;
+  int hoodMax2 = 0;
+  auto addColumn = [&](int hoodIdx0)
+    {
+    T* tmpPtr2 = inPtr + (hoodIdx0 - inExt[0]) * inInc0 + (hoodMin1 - inExt[2]) * inInc1 + (hoodMin2 - inExt[4]) * inInc2;
+    for (int hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2, tmpPtr2 += inInc2)
+      {
+      T* tmpPtr1 = tmpPtr2;
+      for (int hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1, tmpPtr1 += inInc1)
+        {
+        for (int outIdxC = 0; outIdxC < numComp; outIdxC++)
+          {
+          if (majorityVote || tmpPtr1[outIdxC] != backgroundValue)
+            {
+            histograms[outIdxC].Add(tmpPtr1[outIdxC]);
+            }
+          }
+        }
+      }
+    };
+  auto removeColumn = [&](int hoodIdx0)
+    {
+    T* tmpPtr2 = inPtr + (hoodIdx0 - inExt[0]) * inInc0 + (hoodMin1 - inExt[2]) * inInc1 + (hoodMin2 - inExt[4]) * inInc2;
+    for (int hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2, tmpPtr2 += inInc2)
+      {
+      T* tmpPtr1 = tmpPtr2;
+      for (int hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1, tmpPtr1 += inInc1)
+        {
+        for (int outIdxC = 0; outIdxC < numComp; outIdxC++)
+          {
+          if (majorityVote || tmpPtr1[outIdxC] != backgroundValue)
+            {
+            histograms[outIdxC].Remove(tmpPtr1[outIdxC]);
+            }
+          }
+        }
+      }
+    };
+
+  // Process voxels begin0..end0 of a row, writing output to segmentOutPtr
+  auto processSegment = [&](int outIdx1, int outIdx2, int begin0, int end0, T* segmentOutPtr)
+    {
+    // Fill the neighborhood of the first voxel of the segment, except its last column,
+    // which is added at the beginning of the voxel iteration.
+    for (auto& histogram : histograms)
+      {
+      histogram.Clear();
+      }
+    int hoodStartMin0 = std::max(begin0 - kernelMiddle[0], inExt[0]);
+    int hoodStartMax0 = std::min(begin0 - kernelMiddle[0] + kernelSize[0] - 2, inExt[1]);
+    for (int hoodIdx0 = hoodStartMin0; hoodIdx0 <= hoodStartMax0; ++hoodIdx0)
+      {
+      addColumn(hoodIdx0);
+      }
+
+    T* centerPtr = inPtr + (begin0 - inExt[0]) * inInc0 + (outIdx1 - inExt[2]) * inInc1 + (outIdx2 - inExt[4]) * inInc2;
+    for (int outIdx0 = begin0; outIdx0 <= end0; ++outIdx0, centerPtr += inInc0)
+      {
+      // Slide the neighborhood
+      int enteringIdx0 = outIdx0 - kernelMiddle[0] + kernelSize[0] - 1;
+      if (enteringIdx0 >= inExt[0] && enteringIdx0 <= inExt[1])
+        {
+        addColumn(enteringIdx0);
+        }
+      int leavingIdx0 = outIdx0 - kernelMiddle[0] - 1;
+      if (outIdx0 > begin0 && leavingIdx0 >= inExt[0] && leavingIdx0 <= inExt[1])
+        {
+        removeColumn(leavingIdx0);
+        }
+
+      for (int outIdxC = 0; outIdxC < numComp; outIdxC++)
+        {
+        T centerVoxelValue = centerPtr[outIdxC];
+        if ((!majorityVote && centerVoxelValue != backgroundValue) || histograms[outIdxC].IsEmpty()
+          || !maskRow.IsInside(outIdx0))
+          {
+          // Center voxel is not background voxel, there are no labels in the neighborhood,
+          // or the voxel must not be changed: leave it unchanged
+          *segmentOutPtr++ = centerVoxelValue;
+          }
+        else
+          {
+          // Replace the voxel with the most frequent value in the neighborhood
+          // (in dilation mode background voxels are not counted).
+          *segmentOutPtr++ = histograms[outIdxC].GetMode();
+          }
+        }
+      }
+    };
+
+  // First voxel of the block map (it may be different from the first voxel of the input)
+  int blockOrigin[3] = { 0, 0, 0 };
+  if (activeBlocks)
+    {
+    for (int axis = 0; axis < 3; axis++)
+      {
+      blockOrigin[axis] = static_cast<int>(std::floor(activeBlocks->GetOrigin()[axis] + 0.5));
+      }
+    }
+
+  // loop through pixel of output
+  int rowLength = outExt[1] - outExt[0] + 1;
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+    {
+    // Neighborhood is clipped by the input image extent
+    hoodMin2 = std::max(outIdx2 - kernelMiddle[2], inExt[4]);
+    hoodMax2 = std::min(outIdx2 - kernelMiddle[2] + kernelSize[2] - 1, inExt[5]);
+    for (int outIdx1 = outExt[2]; !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count % target))
+          {
+          self->UpdateProgress(count / (50.0 * target));
+          }
+        count++;
+        }
+      hoodMin1 = std::max(outIdx1 - kernelMiddle[1], inExt[2]);
+      hoodMax1 = std::min(outIdx1 - kernelMiddle[1] + kernelSize[1] - 1, inExt[3]);
+      maskRow.SetRow(outIdx1, outIdx2);
+
+      if (!activeBlocks)
+        {
+        processSegment(outIdx1, outIdx2, outExt[0], outExt[1], outPtr);
+        }
+      else
+        {
+        // Only process segments of the row that are in active blocks, copy the rest
+        unsigned char* activeBlockRow = static_cast<unsigned char*>(activeBlocks->GetScalarPointer(
+          0, (outIdx1 - blockOrigin[1]) / LABEL_BLOCK_SIZE, (outIdx2 - blockOrigin[2]) / LABEL_BLOCK_SIZE));
+        int segmentBegin0 = outExt[0];
+        while (segmentBegin0 <= outExt[1])
+          {
+          int blockIdx0 = (segmentBegin0 - blockOrigin[0]) / LABEL_BLOCK_SIZE;
+          bool segmentActive = (activeBlockRow[blockIdx0] != 0);
+          // Merge the following blocks that are in the same state
+          int segmentEnd0 = std::min(blockOrigin[0] + (blockIdx0 + 1) * LABEL_BLOCK_SIZE - 1, outExt[1]);
+          while (segmentEnd0 < outExt[1]
+            && (activeBlockRow[(segmentEnd0 + 1 - blockOrigin[0]) / LABEL_BLOCK_SIZE] != 0) == segmentActive)
+            {
+            segmentEnd0 = std::min(segmentEnd0 + LABEL_BLOCK_SIZE, outExt[1]);
+            }
+          T* segmentOutPtr = outPtr + (segmentBegin0 - outExt[0]) * numComp;
+          if (segmentActive)
+            {
+            processSegment(outIdx1, outIdx2, segmentBegin0, segmentEnd0, segmentOutPtr);
+            }
+          else
+            {
+            T* segmentInPtr = inPtr + (segmentBegin0 - inExt[0]) * inInc0 + (outIdx1 - inExt[2]) * inInc1
+              + (outIdx2 - inExt[4]) * inInc2;
+            memcpy(segmentOutPtr, segmentInPtr, sizeof(T) * numComp * (segmentEnd0 - segmentBegin0 + 1));
+            }
+          segmentBegin0 = segmentEnd0 + 1;
+          }
+        }
+      outPtr += rowLength * numComp + outIncY;
+      }
+    outPtr += outIncZ;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Integer labels: call the worker with a dense histogram prototype if the range of label values is small enough.
+// The worker may move the prototype into its own histograms.
+template <typename T, typename WorkerType>
+void vtkImageLabelNeighborhoodFilter3DSelectHistogram(std::true_type vtkNotUsed(isInteger), const double labelRange[2],
+  WorkerType& worker)
+{
+  if (sizeof(T) <= 4 && labelRange[0] <= labelRange[1]
+    && static_cast<long long>(labelRange[1]) - static_cast<long long>(labelRange[0]) < DENSE_LABEL_HISTOGRAM_MAX_BINS)
+    {
+    vtkDenseLabelHistogram<T> histogram;
+    histogram.Initialize(static_cast<long long>(labelRange[0]), static_cast<long long>(labelRange[1]));
+    worker(histogram);
+    }
+  else
+    {
+    vtkLabelHistogram<T> histogram;
+    worker(histogram);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Floating-point labels: dense histogram cannot be used.
+template <typename T, typename WorkerType>
+void vtkImageLabelNeighborhoodFilter3DSelectHistogram(std::false_type vtkNotUsed(isInteger),
+  const double vtkNotUsed(labelRange)[2], WorkerType& worker)
+{
+  vtkLabelHistogram<T> histogram;
+  worker(histogram);
+}
+
+//------------------------------------------------------------------------------
+// Create a histogram for each component. The prototype is moved into the last histogram, so that
+// the (potentially large) dense histogram is not copied for single-component images.
+template <typename HistogramType>
+std::vector<HistogramType> vtkImageLabelNeighborhoodFilter3DCreateHistograms(HistogramType& histogramPrototype,
+  int numberOfComponents)
+{
+  std::vector<HistogramType> histograms;
+  histograms.reserve(numberOfComponents);
+  for (int component = 1; component < numberOfComponents; component++)
+    {
+    histograms.push_back(histogramPrototype);
+    }
+  histograms.push_back(std::move(histogramPrototype));
+  return histograms;
+}
+
+//------------------------------------------------------------------------------
+// Process a piece of the output. Histograms are created from the prototype once for the piece.
+template <typename T>
+class vtkImageLabelNeighborhoodFilter3DPieceWorker
+{
+public:
+  vtkImageLabelNeighborhoodFilter3D* Self;
+  vtkImageData* InData;
+  T* InPtr;
+  vtkImageData* OutData;
+  T* OutPtr;
+  int* OutExt;
+  int Id;
+  vtkDataArray* InArray;
+  vtkImageData* MaskData;
+  vtkImageData* ActiveBlocks;
+  double BackgroundValue;
+  bool MajorityVote;
+
+  template <typename HistogramType>
+  void operator()(HistogramType& histogramPrototype)
+    {
+    std::vector<HistogramType> histograms =
+      vtkImageLabelNeighborhoodFilter3DCreateHistograms(histogramPrototype, this->InArray->GetNumberOfComponents());
+    vtkImageLabelNeighborhoodFilter3DExecute(this->Self, this->InData, this->InPtr, this->OutData, this->OutPtr,
+      this->OutExt, this->Id, this->InArray, this->MaskData, this->ActiveBlocks, this->BackgroundValue,
+      this->MajorityVote, histograms);
+    }
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+void vtkImageLabelNeighborhoodFilter3DExecutePiece(vtkImageLabelNeighborhoodFilter3D* self, vtkImageData* inData,
+  T* inPtr, vtkImageData* outData, T* outPtr, int outExt[6], int id, vtkDataArray* inArray, vtkImageData* maskData,
+  vtkImageData* activeBlocks, double backgroundValue, bool majorityVote, const double labelRange[2])
+{
+  vtkImageLabelNeighborhoodFilter3DPieceWorker<T> worker = { self, inData, inPtr, outData, outPtr, outExt, id, inArray,
+    maskData, activeBlocks, backgroundValue, majorityVote };
+  vtkImageLabelNeighborhoodFilter3DSelectHistogram<T>(std::is_integral<T>(), labelRange, worker);
+}
+
+//------------------------------------------------------------------------------
+// Process labels in place, slab by slab. Each slab is kernel depth thick. Output labels of a slab are kept
+// in a buffer until the next slab is processed (which still needs the original labels of the last slices of
+// the slab), and only then written over the input. Later slabs do not need labels of the slab anymore.
+// Therefore only two slab buffers are needed, which are allocated once and used alternately.
+// Rows of a slab are processed in parallel. Histograms of each thread are allocated once and reused
+// for all slabs. Only voxels in the processing extent are changed.
+template <typename T>
+class vtkImageLabelNeighborhoodFilter3DInPlaceWorker
+{
+public:
+  vtkImageLabelNeighborhoodFilter3D* Self;
+  vtkImageData* Data;
+  vtkDataArray* Array;
+  const int* ProcessingExt;
+  vtkImageData* MaskData;
+  vtkImageData* ActiveBlocks;
+  double BackgroundValue;
+  bool MajorityVote;
+
+  template <typename HistogramType>
+  void operator()(HistogramType& histogramPrototype)
+    {
+    const int* processingExt = this->ProcessingExt;
+    int numComp = this->Array->GetNumberOfComponents();
+    T* dataPtr = static_cast<T*>(this->Array->GetVoidPointer(0));
+    int slabThickness = std::max(this->Self->GetKernelSize()[2], 1);
+    int rowLength = processingExt[1] - processingExt[0] + 1;
+
+    // Output labels of the current and the previous slab
+    vtkSmartPointer<vtkImageData> slabOutput = vtkSmartPointer<vtkImageData>::New();
+    vtkSmartPointer<vtkImageData> previousSlabOutput = vtkSmartPointer<vtkImageData>::New();
+    vtkImageData* slabBuffers[2] = { slabOutput.GetPointer(), previousSlabOutput.GetPointer() };
+    for (vtkImageData* slabBuffer : slabBuffers)
+      {
+      slabBuffer->SetExtent(processingExt[0], processingExt[1], processingExt[2], processingExt[3], 0,
+        slabThickness - 1);
+      slabBuffer->AllocateScalars(this->Array->GetDataType(), numComp);
+      }
+    bool previousSlabValid = false;
+    auto writePreviousSlab = [&]()
+      {
+      int* slabExt = previousSlabOutput->GetExtent();
+      for (int idx2 = slabExt[4]; idx2 <= slabExt[5]; ++idx2)
+        {
+        for (int idx1 = slabExt[2]; idx1 <= slabExt[3]; ++idx1)
+          {
+          memcpy(this->Data->GetScalarPointer(slabExt[0], idx1, idx2),
+            previousSlabOutput->GetScalarPointer(slabExt[0], idx1, idx2), rowLength * numComp * sizeof(T));
+          }
+        }
+      };
+
+    // The prototype is built once and copied into each thread
+    vtkSMPThreadLocal<std::vector<HistogramType>> threadHistograms(
+      vtkImageLabelNeighborhoodFilter3DCreateHistograms(histogramPrototype, numComp));
+    for (int slabBegin = processingExt[4]; slabBegin <= processingExt[5] && !this->Self->AbortExecute;
+      slabBegin += slabThickness)
+      {
+      int slabExt[6] = { processingExt[0], processingExt[1], processingExt[2], processingExt[3], slabBegin,
+        std::min(slabBegin + slabThickness - 1, processingExt[5]) };
+      // Only the extent changes, the buffer is large enough for any slab
+      slabOutput->SetExtent(slabExt);
+      vtkSMPTools::For(slabExt[2], slabExt[3] + 1, [&](vtkIdType beginRow, vtkIdType endRow)
+        {
+        int pieceExt[6] = { slabExt[0], slabExt[1], static_cast<int>(beginRow), static_cast<int>(endRow - 1),
+          slabExt[4], slabExt[5] };
+        // Progress is reported for entire slabs, therefore a non-zero thread id is used
+        vtkImageLabelNeighborhoodFilter3DExecute(this->Self, this->Data, dataPtr, slabOutput.GetPointer(),
+          static_cast<T*>(slabOutput->GetScalarPointerForExtent(pieceExt)), pieceExt, 1, this->Array,
+          this->MaskData, this->ActiveBlocks, this->BackgroundValue, this->MajorityVote, threadHistograms.Local());
+        });
+
+      if (previousSlabValid)
+        {
+        writePreviousSlab();
+        }
+      std::swap(slabOutput, previousSlabOutput);
+      previousSlabValid = true;
+      this->Self->UpdateProgress(
+        static_cast<double>(slabExt[5] - processingExt[4] + 1) / (processingExt[5] - processingExt[4] + 1));
+      }
+    if (previousSlabValid)
+      {
+      writePreviousSlab();
+      }
+    }
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+void vtkImageLabelNeighborhoodFilter3DExecuteInPlace(vtkImageLabelNeighborhoodFilter3D* self, vtkImageData* data,
+  vtkDataArray* array, const int processingExt[6], vtkImageData* maskData, vtkImageData* activeBlocks,
+  double backgroundValue, bool majorityVote, const double labelRange[2])
+{
+  vtkImageLabelNeighborhoodFilter3DInPlaceWorker<T> worker = { self, data, array, processingExt, maskData, activeBlocks,
+    backgroundValue, majorityVote };
+  vtkImageLabelNeighborhoodFilter3DSelectHistogram<T>(std::is_integral<T>(), labelRange, worker);
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelNeighborhoodFilter3D::RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+  if (this->UseInPlaceProcessing())
+    {
+    // In-place processing output is the entire input
+    return 1;
+    }
+
+  // Output is restricted to the processing extent
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  int outWholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkImageLabelNeighborhoodFilter3DClipExtent(this->ProcessingExtent, wholeExtent, outWholeExtent))
+    {
+    vtkWarningMacro("Processing extent does not overlap with the input image");
+    }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), outWholeExtent, 6);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelNeighborhoodFilter3D::RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+
+  if (this->UseInPlaceProcessing())
+    {
+    // In-place processing changes voxels anywhere in the entire input extent
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+    }
+  else if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  // Mask is only needed where voxels may be changed
+  this->RequestMaskUpdateExtent(inputVector, outExt);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelNeighborhoodFilter3D::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkDataArray* inArray = this->GetInputArrayToProcess(0, inputVector);
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkImageData* input = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* mask = nullptr;
+  if (!this->GetMaskInputData(inputVector, mask))
+    {
+    return 0;
+    }
+
+  // Get the range of label values before the processing is split between threads
+  this->LabelRange[0] = 0.0;
+  this->LabelRange[1] = -1.0;
+  if (inArray && inArray->GetNumberOfTuples() > 0)
+    {
+    for (int component = 0; component < inArray->GetNumberOfComponents(); component++)
+      {
+      double componentRange[2] = { 0.0, -1.0 };
+      inArray->GetRange(componentRange, component);
+      this->LabelRange[0] = (component == 0 ? componentRange[0] : std::min(this->LabelRange[0], componentRange[0]));
+      this->LabelRange[1] = (component == 0 ? componentRange[1] : std::max(this->LabelRange[1], componentRange[1]));
+      }
+    }
+
+  // Find regions where the filter may change voxels, before the processing is split between threads
+  if (inArray && input && inArray->GetNumberOfTuples() > 0)
+    {
+    this->ActiveBlocks = vtkSmartPointer<vtkImageData>::New();
+    switch (inArray->GetDataType())
+      {
+      vtkTemplateMacro(vtkImageLabelNeighborhoodFilter3DFindActiveBlocks<VTK_TT>(this, input, inArray, mask,
+        this->ActiveBlocks, this->BackgroundValue, this->MajorityVote));
+      default:
+        // error is reported when the data is processed
+        this->ActiveBlocks = nullptr;
+        break;
+      }
+    }
+
+  int result = 1;
+  if (this->UseInPlaceProcessing() && inArray && input)
+    {
+    // Output shares the voxel array with the input
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkImageData* output = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    output->ShallowCopy(input);
+    output->GetPointData()->SetScalars(inArray);
+    int processingExt[6] = { 0, -1, 0, -1, 0, -1 };
+    if (vtkImageLabelNeighborhoodFilter3DClipExtent(this->ProcessingExtent, input->GetExtent(), processingExt))
+      {
+      switch (inArray->GetDataType())
+        {
+        vtkTemplateMacro(vtkImageLabelNeighborhoodFilter3DExecuteInPlace<VTK_TT>(this, output, inArray, processingExt,
+          mask, this->ActiveBlocks, this->BackgroundValue, this->MajorityVote, this->LabelRange));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+          result = 0;
+          break;
+        }
+      }
+    }
+  else
+    {
+    result = this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+  this->ActiveBlocks = nullptr;
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// This method contains the first switch statement that calls the correct
+// templated function for the input and output region types.
+void vtkImageLabelNeighborhoodFilter3D::ThreadedRequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector),
+  vtkImageData*** inData, vtkImageData** outData, int outExt[6], int id)
+{
+  void* inPtr;
+  void* outPtr = outData[0]->GetScalarPointerForExtent(outExt);
+
+  vtkDataArray* inArray = this->GetInputArrayToProcess(0, inputVector);
+  if (!inArray)
+    {
+    vtkErrorMacro(<< "Execute: No input array to process");
+    return;
+    }
+  if (id == 0)
+    {
+    outData[0]->GetPointData()->GetScalars()->SetName(inArray->GetName());
+    }
+
+  inPtr = inArray->GetVoidPointer(0);
+
+  // this filter expects that input is the same type as output.
+  if (inArray->GetDataType() != outData[0]->GetScalarType())
+    {
+    vtkErrorMacro(<< "Execute: input data type, " << inArray->GetDataType()
+                  << ", must match out ScalarType " << outData[0]->GetScalarType());
+    return;
+    }
+
+  vtkImageData* mask = nullptr;
+  this->GetMaskInputData(inputVector, mask);
+  switch (inArray->GetDataType())
+    {
+    vtkTemplateMacro(vtkImageLabelNeighborhoodFilter3DExecutePiece(this, inData[0][0], static_cast<VTK_TT*>(inPtr),
+      outData[0], static_cast<VTK_TT*>(outPtr), outExt, id, inArray, mask, this->ActiveBlocks, this->BackgroundValue,
+      this->MajorityVote, this->LabelRange));
+    default:
+      vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+      return;
+    }
+}
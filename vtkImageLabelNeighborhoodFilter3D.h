@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+/**
+ * @class   vtkImageLabelNeighborhoodFilter3D
+ * @brief   Base class of label image filters that use the most frequent value in a kernel neighborhood
+ *
+ * vtkImageLabelNeighborhoodFilter3D replaces voxels of a labelmap image with the most frequent value
+ * in their kernel neighborhood. If multiple values occur the same number of times in the neighborhood
+ * then the smallest value is used. Subclasses define which voxels are changed and which values are counted:
+ * vtkImageLabelDilate3D only changes background voxels and does not count background voxels,
+ * vtkImageLabelMajorityVote3D changes all voxels and counts all values.
+ *
+ * Label counts are updated incrementally as the neighborhood slides along the x axis, therefore
+ * computation time grows with the kernel cross-section (size along y and z) and not with the kernel volume.
+ * For integer label types with a small range of label values (such as unsigned char and unsigned short
+ * labelmaps) labels are counted in a dense array, otherwise in a compact list of labels.
+ * Regions where the filter cannot change any voxels are found using a coarse block map
+ * and are copied to the output without processing.
+ *
+ * Processing can be restricted to a mask (optional second input) and to a processing extent.
+ * Only the input region that is needed for computing the processing extent is requested from the input.
+ *
+ * @sa vtkImageLabelDilate3D vtkImageLabelMajorityVote3D
+ */
+
+#ifndef vtkImageLabelNeighborhoodFilter3D_h
+#define vtkImageLabelNeighborhoodFilter3D_h
+
+#include "vtkAddonExport.h" // For export macro
+#include "vtkImageSpatialAlgorithm.h"
+#include "vtkSmartPointer.h" // For ActiveBlocks
+
+class VTK_ADDON_EXPORT vtkImageLabelNeighborhoodFilter3D : public vtkImageSpatialAlgorithm
+{
+public:
+  vtkTypeMacro(vtkImageLabelNeighborhoodFilter3D, vtkImageSpatialAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Set/Get in-place processing. If enabled then the output shares the voxel array with the input
+   * and the output labels are written over the input voxels, slab by slab. Only two slabs of output labels
+   * (each kernel depth thick) are buffered, therefore memory usage is much lower than with a
+   * separate output volume. The entire input extent is requested and the output has the same extent as the input.
+   * The input image is modified, therefore this mode should only be used if the input is not needed anymore.
+   * Default is off.
+   */
+  vtkSetMacro(InPlace, bool);
+  vtkGetMacro(InPlace, bool);
+  vtkBooleanMacro(InPlace, bool);
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the optional mask image. Only voxels where the mask is non-zero are changed,
+   * voxels outside the mask (or outside the extent of the mask image) are copied from the input.
+   * Voxels outside the mask are still counted in the neighborhood of voxels inside the mask.
+   * Mask scalar type must be unsigned char. The mask must have the same origin, spacing, and axis directions
+   * as the input.
+   */
+  void SetMaskInputData(vtkImageData* mask);
+  void SetMaskInputConnection(vtkAlgorithmOutput* maskConnection);
+  vtkImageData* GetMaskInput();
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the extent of the region that is processed. Output extent is limited to this region, except in in-place
+   * mode, where voxels outside the region are left unchanged. If the extent is empty (this is the default)
+   * then the entire input is processed.
+   */
+  vtkSetVector6Macro(ProcessingExtent, int);
+  vtkGetVector6Macro(ProcessingExtent, int);
+  ///@}
+
+  /**
+   * Size of the neighborhood where the most frequent value is searched for.
+   */
+  void SetKernelSize(int size0, int size1, int size2);
+
+protected:
+  vtkImageLabelNeighborhoodFilter3D();
+  ~vtkImageLabelNeighborhoodFilter3D() override;
+
+  /// Returns true if the input is processed in place.
+  /// Subclasses may override it to disable in-place processing in modes that do not support it.
+  virtual bool UseInPlaceProcessing();
+
+  /// Get the optional mask input. Returns false if the mask is invalid.
+  bool GetMaskInputData(vtkInformationVector** inputVector, vtkImageData*& mask);
+
+  /// Request the region of the mask (if set) that overlaps with the specified extent.
+  void RequestMaskUpdateExtent(vtkInformationVector** inputVector, const int extent[6]);
+
+  /// Voxels of this value are not counted and only voxels of this value are changed, unless MajorityVote is enabled.
+  double BackgroundValue = 0.0;
+
+  /// If enabled then all voxels are replaced by the most frequent value in their neighborhood,
+  /// and background voxels are counted as well.
+  bool MajorityVote = false;
+
+  bool InPlace = false;
+  int ProcessingExtent[6] = { 0, -1, 0, -1, 0, -1 };
+
+  // Range of label values in the input, computed before the processing is split between threads
+  double LabelRange[2] = { 0.0, -1.0 };
+
+  // Map of blocks where the filter may change voxels, computed before the processing is split between threads
+  vtkSmartPointer<vtkImageData> ActiveBlocks;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  void ThreadedRequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector, vtkImageData*** inData, vtkImageData** outData,
+    int outExt[6], int id) override;
+
+private:
+  vtkImageLabelNeighborhoodFilter3D(const vtkImageLabelNeighborhoodFilter3D&) = delete;
+  void operator=(const vtkImageLabelNeighborhoodFilter3D&) = delete;
+};
+
+#endif
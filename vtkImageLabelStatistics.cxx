@@ -0,0 +1,426 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vtkImageLabelStatistics.h"
+#include "vtkAddonMathUtilities.h"
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+vtkStandardNewMacro(vtkImageLabelStatistics);
+
+//------------------------------------------------------------------------------
+vtkImageLabelStatistics::vtkImageLabelStatistics()
+{
+  this->SetNumberOfInputPorts(2);
+}
+
+//------------------------------------------------------------------------------
+vtkImageLabelStatistics::~vtkImageLabelStatistics() = default;
+
+//------------------------------------------------------------------------------
+void vtkImageLabelStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: " << this->BackgroundValue << endl;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelStatistics::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 0)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    }
+  else if (port == 1)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+    }
+  else
+    {
+    vtkErrorMacro("Cannot set input info for port " << port);
+    return 0;
+    }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkImageLabelStatistics::SetIntensityInputData(vtkImageData* intensity)
+{
+  this->SetInputData(1, intensity);
+}
+
+//------------------------------------------------------------------------------
+void vtkImageLabelStatistics::SetIntensityInputConnection(vtkAlgorithmOutput* intensityConnection)
+{
+  this->SetInputConnection(1, intensityConnection);
+}
+
+//------------------------------------------------------------------------------
+vtkImageData* vtkImageLabelStatistics::GetIntensityInput()
+{
+  if (this->GetNumberOfInputConnections(1) < 1)
+    {
+    return nullptr;
+    }
+  return vtkImageData::SafeDownCast(this->GetInputDataObject(1, 0));
+}
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Statistics of a single label. Each thread accumulates statistics in its own instance
+// and the instances are merged at the end.
+struct vtkLabelStatisticsAccumulator
+{
+  vtkIdType VoxelCount = 0;
+  // Sum of voxel indices, for computing the centroid
+  double IndexSum[3] = { 0.0, 0.0, 0.0 };
+  int Extent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  double IntensityMinimum = std::numeric_limits<double>::infinity();
+  double IntensityMaximum = -std::numeric_limits<double>::infinity();
+  // Running mean and sum of squared differences from the mean (Welford's algorithm),
+  // which does not lose precision when the mean is large compared to the standard deviation
+  vtkIdType IntensityCount = 0;
+  double IntensityMean = 0.0;
+  double IntensitySquaredDeviationSum = 0.0;
+
+  // Add voxels begin0..end0 of a row
+  void AddRun(int begin0, int end0, int idx1, int idx2)
+    {
+    vtkIdType runLength = end0 - begin0 + 1;
+    this->VoxelCount += runLength;
+    this->IndexSum[0] += 0.5 * (static_cast<double>(begin0) + end0) * runLength;
+    this->IndexSum[1] += static_cast<double>(idx1) * runLength;
+    this->IndexSum[2] += static_cast<double>(idx2) * runLength;
+    this->Extent[0] = std::min(this->Extent[0], begin0);
+    this->Extent[1] = std::max(this->Extent[1], end0);
+    this->Extent[2] = std::min(this->Extent[2], idx1);
+    this->Extent[3] = std::max(this->Extent[3], idx1);
+    this->Extent[4] = std::min(this->Extent[4], idx2);
+    this->Extent[5] = std::max(this->Extent[5], idx2);
+    }
+
+  void AddIntensity(double intensity)
+    {
+    this->IntensityMinimum = std::min(this->IntensityMinimum, intensity);
+    this->IntensityMaximum = std::max(this->IntensityMaximum, intensity);
+    this->IntensityCount++;
+    double delta = intensity - this->IntensityMean;
+    this->IntensityMean += delta / this->IntensityCount;
+    this->IntensitySquaredDeviationSum += delta * (intensity - this->IntensityMean);
+    }
+
+  double GetIntensityVariance() const
+    {
+    return (this->IntensityCount > 0 ? this->IntensitySquaredDeviationSum / this->IntensityCount : 0.0);
+    }
+
+  void Merge(const vtkLabelStatisticsAccumulator& other)
+    {
+    this->VoxelCount += other.VoxelCount;
+    for (int axis = 0; axis < 3; axis++)
+      {
+      this->IndexSum[axis] += other.IndexSum[axis];
+      this->Extent[axis * 2] = std::min(this->Extent[axis * 2], other.Extent[axis * 2]);
+      this->Extent[axis * 2 + 1] = std::max(this->Extent[axis * 2 + 1], other.Extent[axis * 2 + 1]);
+      }
+    this->IntensityMinimum = std::min(this->IntensityMinimum, other.IntensityMinimum);
+    this->IntensityMaximum = std::max(this->IntensityMaximum, other.IntensityMaximum);
+    // Pairwise combination of mean and squared deviations (Chan et al.)
+    if (other.IntensityCount == 0)
+      {
+      return;
+      }
+    if (this->IntensityCount == 0)
+      {
+      this->IntensityCount = other.IntensityCount;
+      this->IntensityMean = other.IntensityMean;
+      this->IntensitySquaredDeviationSum = other.IntensitySquaredDeviationSum;
+      return;
+      }
+    double count = static_cast<double>(this->IntensityCount);
+    double otherCount = static_cast<double>(other.IntensityCount);
+    double totalCount = count + otherCount;
+    double delta = other.IntensityMean - this->IntensityMean;
+    this->IntensityMean += delta * otherCount / totalCount;
+    this->IntensitySquaredDeviationSum += other.IntensitySquaredDeviationSum
+      + delta * delta * count * otherCount / totalCount;
+    this->IntensityCount += other.IntensityCount;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Accumulate statistics of all labels in a single pass. Rows of the image are processed in parallel,
+// each thread collects statistics of the labels in its rows, which are merged at the end.
+// Consecutive voxels of the same label in a row are added together, so that the statistics of a label
+// are looked up only once for each run of voxels. Intensity pointer may be nullptr.
+template <typename TLabel, typename TIntensity>
+void vtkImageLabelStatisticsAccumulate(vtkImageLabelStatistics* self, const int extent[6], const TLabel* labelPtr,
+  int labelNumComp, const TIntensity* intensityPtr, const vtkIdType intensityIncrements[3],
+  std::map<double, vtkLabelStatisticsAccumulator>& statistics)
+{
+  // Compared as double, because the background value may not be representable in the label scalar type
+  double backgroundValue = self->GetBackgroundValue();
+  int rowLength = extent[1] - extent[0] + 1;
+  int numberOfRows1 = extent[3] - extent[2] + 1;
+  vtkIdType numberOfRows = static_cast<vtkIdType>(numberOfRows1) * (extent[5] - extent[4] + 1);
+
+  vtkSMPThreadLocal<std::map<TLabel, vtkLabelStatisticsAccumulator>> localStatistics;
+  vtkSMPTools::For(0, numberOfRows, [&](vtkIdType beginRow, vtkIdType endRow)
+    {
+    std::map<TLabel, vtkLabelStatisticsAccumulator>& threadStatistics = localStatistics.Local();
+    for (vtkIdType row = beginRow; row < endRow; row++)
+      {
+      int idx1 = extent[2] + static_cast<int>(row % numberOfRows1);
+      int idx2 = extent[4] + static_cast<int>(row / numberOfRows1);
+      const TLabel* rowLabelPtr = labelPtr + row * rowLength * labelNumComp;
+      const TIntensity* rowIntensityPtr = (intensityPtr ? intensityPtr
+          + (idx1 - extent[2]) * intensityIncrements[1] + (idx2 - extent[4]) * intensityIncrements[2] : nullptr);
+      int runBegin = 0;
+      while (runBegin < rowLength)
+        {
+        TLabel label = rowLabelPtr[runBegin * labelNumComp];
+        int runEnd = runBegin + 1;
+        while (runEnd < rowLength && rowLabelPtr[runEnd * labelNumComp] == label)
+          {
+          runEnd++;
+          }
+        if (static_cast<double>(label) != backgroundValue)
+          {
+          vtkLabelStatisticsAccumulator& labelStatistics = threadStatistics[label];
+          labelStatistics.AddRun(extent[0] + runBegin, extent[0] + runEnd - 1, idx1, idx2);
+          if (rowIntensityPtr)
+            {
+            for (int idx0 = runBegin; idx0 < runEnd; idx0++)
+              {
+              labelStatistics.AddIntensity(static_cast<double>(rowIntensityPtr[idx0 * intensityIncrements[0]]));
+              }
+            }
+          }
+        runBegin = runEnd;
+        }
+      }
+    });
+
+  // Merge statistics of all threads
+  for (const auto& threadStatistics : localStatistics)
+    {
+    for (const auto& labelStatistics : threadStatistics)
+      {
+      statistics[static_cast<double>(labelStatistics.first)].Merge(labelStatistics.second);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <typename TLabel>
+bool vtkImageLabelStatisticsDispatchIntensity(vtkImageLabelStatistics* self, const int extent[6],
+  vtkDataArray* labelArray, vtkImageData* intensityImage, std::map<double, vtkLabelStatisticsAccumulator>& statistics)
+{
+  const TLabel* labelPtr = static_cast<const TLabel*>(labelArray->GetVoidPointer(0));
+  int labelNumComp = labelArray->GetNumberOfComponents();
+  vtkIdType intensityIncrements[3] = { 0, 0, 0 };
+  if (!intensityImage)
+    {
+    vtkImageLabelStatisticsAccumulate(self, extent, labelPtr, labelNumComp, static_cast<const TLabel*>(nullptr),
+      intensityIncrements, statistics);
+    return true;
+    }
+  intensityImage->GetIncrements(intensityIncrements);
+  void* intensityPtr = intensityImage->GetScalarPointer(extent[0], extent[2], extent[4]);
+  switch (intensityImage->GetScalarType())
+    {
+    vtkTemplateMacro(vtkImageLabelStatisticsAccumulate(self, extent, labelPtr, labelNumComp,
+      static_cast<const VTK_TT*>(intensityPtr), intensityIncrements, statistics));
+    default:
+      return false;
+    }
+  return true;
+}
+
+} // end anonymous namespace
+
+//------------------------------------------------------------------------------
+int vtkImageLabelStatistics::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+{
+  // Statistics are computed for the entire labelmap
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), wholeExtent, 6);
+
+  // Intensities are needed in the same region
+  if (inputVector[1]->GetNumberOfInformationObjects() > 0)
+    {
+    vtkInformation* intensityInfo = inputVector[1]->GetInformationObject(0);
+    int intensityWholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    intensityInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), intensityWholeExtent);
+    int intensityExt[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int axis = 0; axis < 3; axis++)
+      {
+      intensityExt[axis * 2] = std::max(wholeExtent[axis * 2], intensityWholeExtent[axis * 2]);
+      intensityExt[axis * 2 + 1] = std::min(wholeExtent[axis * 2 + 1], intensityWholeExtent[axis * 2 + 1]);
+      }
+    intensityInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), intensityExt, 6);
+    }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageLabelStatistics::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkTable* output = vtkTable::GetData(outputVector);
+  output->Initialize();
+
+  vtkImageData* labelImage = vtkImageData::SafeDownCast(
+    inputVector[0]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+  vtkDataArray* labelArray = this->GetInputArrayToProcess(0, inputVector);
+  if (!labelImage || !labelArray)
+    {
+    vtkErrorMacro(<< "Execute: No input labelmap to process");
+    return 0;
+    }
+  vtkImageData* intensityImage = nullptr;
+  if (inputVector[1]->GetNumberOfInformationObjects() > 0)
+    {
+    intensityImage = vtkImageData::SafeDownCast(
+      inputVector[1]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+    }
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelImage->GetExtent(extent);
+  bool emptyExtent = (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5]);
+  if (intensityImage && !emptyExtent)
+    {
+    int* intensityExtent = intensityImage->GetExtent();
+    for (int axis = 0; axis < 3; axis++)
+      {
+      if (intensityExtent[axis * 2] > extent[axis * 2] || intensityExtent[axis * 2 + 1] < extent[axis * 2 + 1])
+        {
+        vtkErrorMacro(<< "Execute: intensity image does not contain the entire labelmap extent");
+        return 0;
+        }
+      }
+    if (!vtkAddonMathUtilities::ImageGeometryAreEqual(labelImage, intensityImage))
+      {
+      vtkErrorMacro(<< "Execute: intensity image origin, spacing, or axis directions differ from the labelmap");
+      return 0;
+      }
+    if (!intensityImage->GetPointData()->GetScalars())
+      {
+      vtkErrorMacro(<< "Execute: No intensity scalars");
+      return 0;
+      }
+    }
+
+  std::map<double, vtkLabelStatisticsAccumulator> statistics;
+  if (!emptyExtent)
+    {
+    bool success = false;
+    switch (labelArray->GetDataType())
+      {
+      vtkTemplateMacro(success = vtkImageLabelStatisticsDispatchIntensity<VTK_TT>(this, extent, labelArray,
+        intensityImage, statistics));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown label ScalarType");
+        return 0;
+      }
+    if (!success)
+      {
+      vtkErrorMacro(<< "Execute: Unknown intensity ScalarType");
+      return 0;
+      }
+    }
+
+  // Fill the output table, one row for each label
+  vtkIdType numberOfLabels = static_cast<vtkIdType>(statistics.size());
+  vtkNew<vtkDoubleArray> labelValues;
+  labelValues->SetName("LabelValue");
+  labelValues->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkIdTypeArray> voxelCounts;
+  voxelCounts->SetName("VoxelCount");
+  voxelCounts->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> volumes;
+  volumes->SetName("Volume");
+  volumes->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> centroids;
+  centroids->SetName("Centroid");
+  centroids->SetNumberOfComponents(3);
+  centroids->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkIntArray> extents;
+  extents->SetName("Extent");
+  extents->SetNumberOfComponents(6);
+  extents->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> intensityMinimums;
+  intensityMinimums->SetName("IntensityMinimum");
+  intensityMinimums->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> intensityMaximums;
+  intensityMaximums->SetName("IntensityMaximum");
+  intensityMaximums->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> intensityMeans;
+  intensityMeans->SetName("IntensityMean");
+  intensityMeans->SetNumberOfTuples(numberOfLabels);
+  vtkNew<vtkDoubleArray> intensityStandardDeviations;
+  intensityStandardDeviations->SetName("IntensityStandardDeviation");
+  intensityStandardDeviations->SetNumberOfTuples(numberOfLabels);
+
+  double* spacing = labelImage->GetSpacing();
+  double voxelVolume = std::fabs(spacing[0] * spacing[1] * spacing[2]);
+  vtkIdType labelIndex = 0;
+  for (const auto& labelStatistics : statistics)
+    {
+    const vtkLabelStatisticsAccumulator& accumulator = labelStatistics.second;
+    double voxelCount = static_cast<double>(accumulator.VoxelCount);
+    labelValues->SetValue(labelIndex, labelStatistics.first);
+    voxelCounts->SetValue(labelIndex, accumulator.VoxelCount);
+    volumes->SetValue(labelIndex, voxelCount * voxelVolume);
+    double centroidIndex[3] = { accumulator.IndexSum[0] / voxelCount, accumulator.IndexSum[1] / voxelCount,
+      accumulator.IndexSum[2] / voxelCount };
+    double centroid[3] = { 0.0, 0.0, 0.0 };
+    labelImage->TransformContinuousIndexToPhysicalPoint(centroidIndex, centroid);
+    centroids->SetTypedTuple(labelIndex, centroid);
+    extents->SetTypedTuple(labelIndex, accumulator.Extent);
+    intensityMinimums->SetValue(labelIndex, accumulator.IntensityMinimum);
+    intensityMaximums->SetValue(labelIndex, accumulator.IntensityMaximum);
+    intensityMeans->SetValue(labelIndex, accumulator.IntensityMean);
+    intensityStandardDeviations->SetValue(labelIndex, std::sqrt(accumulator.GetIntensityVariance()));
+    labelIndex++;
+    }
+
+  output->AddColumn(labelValues);
+  output->AddColumn(voxelCounts);
+  output->AddColumn(volumes);
+  output->AddColumn(centroids);
+  output->AddColumn(extents);
+  if (intensityImage)
+    {
+    output->AddColumn(intensityMinimums);
+    output->AddColumn(intensityMaximums);
+    output->AddColumn(intensityMeans);
+    output->AddColumn(intensityStandardDeviations);
+    }
+  return 1;
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+// SPDX-License-Identifier: BSD-3-Clause
+/**
+ * @class   vtkImageLabelStatistics
+ * @brief   Compute statistics of all labels of a labelmap image
+ *
+ * vtkImageLabelStatistics computes voxel count, volume, bounding box, and centroid of each label
+ * in a labelmap image, and intensity statistics of each label if an intensity image is specified.
+ * All labels are processed in a single pass over the image: the image rows are split between threads,
+ * each thread accumulates statistics of all labels that it encounters, and at the end the statistics
+ * of the threads are merged. Therefore computation time does not grow with the number of labels.
+ *
+ * The output is a table that contains one row for each label value that occurs in the image
+ * (except the background value), sorted by label value. Columns:
+ * - LabelValue: label value
+ * - VoxelCount: number of voxels of the label
+ * - Volume: total volume of the voxels, in physical units (taking image spacing into account)
+ * - Centroid: center of mass of the voxels in physical coordinates (taking image geometry into account)
+ * - Extent: bounding box of the voxels, as voxel index extent (iMin, iMax, jMin, jMax, kMin, kMax)
+ * - IntensityMinimum, IntensityMaximum, IntensityMean, IntensityStandardDeviation: statistics of
+ *   intensity image voxel values (first component) in the label. Only added if intensity image is set.
+ *   Standard deviation is the population standard deviation.
+ *
+ * Labels are read from the first component of the input array to process (default is the active scalars).
+ *
+ * @sa vtkImageLabelDilate3D
+ */
+
+#ifndef vtkImageLabelStatistics_h
+#define vtkImageLabelStatistics_h
+
+#include "vtkAddonExport.h" // For export macro
+#include "vtkTableAlgorithm.h"
+
+class vtkImageData;
+
+class VTK_ADDON_EXPORT vtkImageLabelStatistics : public vtkTableAlgorithm
+{
+public:
+  static vtkImageLabelStatistics* New();
+  vtkTypeMacro(vtkImageLabelStatistics, vtkTableAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Set/Get the optional intensity image (second input). Intensity statistics are computed from the
+   * first scalar component. The intensity image must contain the entire extent of the labelmap image
+   * and must have the same geometry (origin, spacing, and axis directions) as the labelmap image,
+   * so that voxels of the same index are at the same physical position.
+   */
+  void SetIntensityInputData(vtkImageData* intensity);
+  void SetIntensityInputConnection(vtkAlgorithmOutput* intensityConnection);
+  vtkImageData* GetIntensityInput();
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the background value. Voxels of this value are not included in the output table.
+   * If the value cannot be represented by the label scalar type then all voxels are included.
+   * Default value is 0.
+   */
+  vtkSetMacro(BackgroundValue, double);
+  vtkGetMacro(BackgroundValue, double);
+  ///@}
+
+protected:
+  vtkImageLabelStatistics();
+  ~vtkImageLabelStatistics() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  double BackgroundValue = 0.0;
+
+private:
+  vtkImageLabelStatistics(const vtkImageLabelStatistics&) = delete;
+  void operator=(const vtkImageLabelStatistics&) = delete;
+};
+
+#endif
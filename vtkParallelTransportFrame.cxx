@@ -8,7 +8,7 @@
 =========================================================================auto=*/
 
 /*
-  Portions of vtkParallelTransportFrame::ComputeAxisDirections method
+  Portions of vtkParallelTransportFrame::ComputeAxisDirectionsWorker
   are covered under the VMTK copyright and BSD license:
 
     Copyright (c) Luca Antiga, David Steinman. All rights reserved.
@@ -19,14 +19,238 @@
 
 #include "vtkParallelTransportFrame.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkCellArray.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPolyLine.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimeStamp.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+template <class ArrayType>
+vtkSmartPointer<vtkDataArray> CreateFrameArray(const char* name, int numberOfComponents)
+{
+  vtkSmartPointer<ArrayType> array = vtkSmartPointer<ArrayType>::New();
+  array->SetName(name);
+  array->SetNumberOfComponents(numberOfComponents);
+  return array;
+}
+
+//----------------------------------------------------------------------------
+/// Set the number of tuples, keeping the existing values and initializing new values to zero.
+/// Returns pointer to the values.
+template <class ArrayType>
+typename ArrayType::ValueType* ResizeFrameArray(ArrayType* array, vtkIdType numberOfTuples)
+{
+  vtkIdType previousNumberOfValues = array->GetNumberOfValues();
+  array->SetNumberOfTuples(numberOfTuples);
+  typename ArrayType::ValueType* values = array->GetPointer(0);
+  vtkIdType numberOfValues = array->GetNumberOfValues();
+  if (previousNumberOfValues < numberOfValues)
+    {
+    std::fill(values + previousNumberOfValues, values + numberOfValues, 0);
+    }
+  return values;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkParallelTransportFrame::vtkInternal
+{
+public:
+  /// State of the frame computation at the end of a cell,
+  /// which is stored in incremental mode to continue the computation when points are appended to the cell.
+  struct CellState
+    {
+    /// Number of points of the cell in the last execution
+    vtkIdType NumberOfPoints = 0;
+    /// The cell was a polyline and its initial tangent was determined, therefore the computation can be continued
+    bool Continuable = false;
+    /// Frame of the last point is written by this cell
+    bool LastPointOwned = false;
+    /// Tangent and normal at the second to last point, and position of that point
+    double Tangent[3] = { 0.0, 0.0, 0.0 };
+    double Normal[3] = { 0.0, 0.0, 0.0 };
+    double PointPosition[3] = { 0.0, 0.0, 0.0 };
+    };
+
+  /// Cells are processed in parallel. If a point is shared by multiple cells (for example, the branching point of
+  /// centerlines) then its frame is written only by the last polyline cell that contains it, same as in serial
+  /// processing, so that the output does not depend on the order of execution.
+  void InitializePointOwners(vtkCellArray* lines, vtkIdType numberOfCells, vtkIdType numberOfPoints)
+  {
+    this->PointOwnerOffset = 0;
+    this->PointOwnerCells.assign(numberOfPoints, -1);
+    vtkNew<vtkIdList> cellPointIdsBuffer;
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+      {
+      vtkIdType numberOfPointsInCell = 0;
+      const vtkIdType* pointIds = nullptr;
+      lines->GetCellAtId(cellIndex, numberOfPointsInCell, pointIds, cellPointIdsBuffer);
+      if (numberOfPointsInCell < 3)
+        {
+        // not a polyline, frames are not written
+        continue;
+        }
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfPointsInCell; pointIndex++)
+        {
+        this->PointOwnerCells[pointIds[pointIndex]] = cellIndex;
+        }
+      }
+  }
+
+  /// Prepare for computing frames only for points appended since the last execution.
+  /// Owners are determined only for the new points.
+  /// Returns false if all frames must be recomputed, because the filter was modified or the
+  /// previously processed points have changed.
+  bool InitializeContinuation(vtkPolyData* input, vtkMTimeType filterMTime)
+  {
+    vtkIdType numberOfPoints = input->GetNumberOfPoints();
+    vtkCellArray* lines = input->GetLines();
+    vtkIdType numberOfCells = (numberOfPoints > 0 && lines ? lines->GetNumberOfCells() : 0);
+    vtkIdType numberOfPreviousCells = static_cast<vtkIdType>(this->CellStates.size());
+    if (this->FrameArrays.empty() || filterMTime > this->ComputeTime.GetMTime()
+      || numberOfPoints < this->NumberOfPoints || numberOfCells < numberOfPreviousCells)
+      {
+      return false;
+      }
+
+    // Coordinates of all previously processed points must be unchanged
+    if (this->NumberOfPoints > 0)
+      {
+      vtkDataArray* pointArray = input->GetPoints()->GetData();
+      std::size_t coordinatesSize =
+        static_cast<std::size_t>(this->NumberOfPoints) * 3 * pointArray->GetDataTypeSize();
+      if (pointArray->GetDataType() != this->ProcessedPointDataType
+        || this->ProcessedPointCoordinates.size() != coordinatesSize
+        || memcmp(pointArray->GetVoidPointer(0), this->ProcessedPointCoordinates.data(), coordinatesSize) != 0)
+        {
+        return false;
+        }
+      }
+
+    this->PointOwnerOffset = this->NumberOfPoints;
+    this->PointOwnerCells.assign(numberOfPoints - this->PointOwnerOffset, -1);
+    vtkNew<vtkIdList> cellPointIdsBuffer;
+    // Position of the previously processed point IDs of the current cell in ProcessedCellPointIds
+    std::size_t processedCellPointIdsOffset = 0;
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+      {
+      vtkIdType numberOfPointsInCell = 0;
+      const vtkIdType* pointIds = nullptr;
+      lines->GetCellAtId(cellIndex, numberOfPointsInCell, pointIds, cellPointIdsBuffer);
+      if (cellIndex < numberOfPreviousCells)
+        {
+        // Previously processed points of the cell must be unchanged
+        vtkIdType numberOfProcessedPoints = this->CellStates[cellIndex].NumberOfPoints;
+        if (numberOfPointsInCell < numberOfProcessedPoints
+          || !std::equal(pointIds, pointIds + numberOfProcessedPoints,
+            this->ProcessedCellPointIds.begin() + processedCellPointIdsOffset))
+          {
+          return false;
+          }
+        processedCellPointIdsOffset += numberOfProcessedPoints;
+        }
+      if (numberOfPointsInCell < 3)
+        {
+        // not a polyline, frames are not written
+        continue;
+        }
+      vtkIdType firstNewPointIndex = 0;
+      if (cellIndex < numberOfPreviousCells)
+        {
+        const CellState& state = this->CellStates[cellIndex];
+        if (!state.Continuable)
+          {
+          return false;
+          }
+        firstNewPointIndex = state.NumberOfPoints;
+        }
+      for (vtkIdType pointIndex = firstNewPointIndex; pointIndex < numberOfPointsInCell; pointIndex++)
+        {
+        if (pointIds[pointIndex] < this->PointOwnerOffset)
+          {
+          // A previously existing point is added to a cell, it may be owned by another cell
+          return false;
+          }
+        this->PointOwnerCells[pointIds[pointIndex] - this->PointOwnerOffset] = cellIndex;
+        }
+      }
+    this->CellStates.resize(numberOfCells);
+    return true;
+  }
+
+  /// Store the point coordinates and cell point IDs that the frames were computed from,
+  /// for detecting changes of previously processed points in the next execution.
+  void StoreProcessedPoints(vtkPolyData* input, vtkIdType numberOfCells)
+  {
+    this->NumberOfPoints = input->GetNumberOfPoints();
+    this->ProcessedPointCoordinates.clear();
+    this->ProcessedCellPointIds.clear();
+    if (this->NumberOfPoints > 0)
+      {
+      vtkDataArray* pointArray = input->GetPoints()->GetData();
+      const unsigned char* coordinates = static_cast<const unsigned char*>(pointArray->GetVoidPointer(0));
+      this->ProcessedPointDataType = pointArray->GetDataType();
+      this->ProcessedPointCoordinates.assign(coordinates,
+        coordinates + static_cast<std::size_t>(this->NumberOfPoints) * 3 * pointArray->GetDataTypeSize());
+      }
+    vtkCellArray* lines = input->GetLines();
+    vtkNew<vtkIdList> cellPointIdsBuffer;
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+      {
+      vtkIdType numberOfPointsInCell = 0;
+      const vtkIdType* pointIds = nullptr;
+      lines->GetCellAtId(cellIndex, numberOfPointsInCell, pointIds, cellPointIdsBuffer);
+      this->ProcessedCellPointIds.insert(this->ProcessedCellPointIds.end(), pointIds, pointIds + numberOfPointsInCell);
+      }
+  }
+
+  /// Returns true if the cell writes the frame of the point.
+  bool IsPointOwner(vtkIdType cellIndex, vtkIdType pointId) const
+  {
+    if (pointId < this->PointOwnerOffset)
+      {
+      // When the computation is continued then the only previously existing point that is written
+      // is the previous last point of the cell.
+      return this->CellStates[cellIndex].LastPointOwned;
+      }
+    return this->PointOwnerCells[pointId - this->PointOwnerOffset] == cellIndex;
+  }
+
+  /// Index of the cell that writes the frame of each point, starting from point PointOwnerOffset.
+  std::vector<vtkIdType> PointOwnerCells;
+  vtkIdType PointOwnerOffset = 0;
+
+  /// State of the last execution, used in incremental mode
+  std::vector<CellState> CellStates;
+  vtkIdType NumberOfPoints = 0;
+  /// Raw coordinates of the processed points and point IDs of all processed cells
+  std::vector<unsigned char> ProcessedPointCoordinates;
+  int ProcessedPointDataType = VTK_VOID;
+  std::vector<vtkIdType> ProcessedCellPointIds;
+  std::vector<vtkSmartPointer<vtkDataArray>> FrameArrays;
+  vtkTimeStamp ComputeTime;
+};
 
 vtkStandardNewMacro(vtkParallelTransportFrame);
 
@@ -36,6 +260,8 @@ vtkParallelTransportFrame::vtkParallelTransportFrame()
   this->SetTangentsArrayName("Tangents");
   this->SetNormalsArrayName("Normals");
   this->SetBinormalsArrayName("Binormals");
+  this->SetFramesArrayName("Frames");
+  this->Internal = new vtkInternal();
 }
 
 //----------------------------------------------------------------------------
@@ -44,6 +270,8 @@ vtkParallelTransportFrame::~vtkParallelTransportFrame()
   this->SetTangentsArrayName(nullptr);
   this->SetNormalsArrayName(nullptr);
   this->SetBinormalsArrayName(nullptr);
+  this->SetFramesArrayName(nullptr);
+  delete this->Internal;
 }
 
 //----------------------------------------------------------------------------
@@ -54,6 +282,11 @@ void vtkParallelTransportFrame::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "TangentsArrayName: " << (this->TangentsArrayName ? this->TangentsArrayName : "(none)") << "\n";
   os << indent << "NormalsArrayName: " << (this->NormalsArrayName ? this->NormalsArrayName : "(none)") << "\n";
   os << indent << "BinormalsArrayName: " << (this->BinormalsArrayName ? this->BinormalsArrayName : "(none)") << "\n";
+  os << indent << "FramesArrayName: " << (this->FramesArrayName ? this->FramesArrayName : "(none)") << "\n";
+  os << indent << "OutputFormat: " << vtkParallelTransportFrame::GetOutputFormatAsString(this->OutputFormat) << "\n";
+  os << indent << "Incremental: " << (this->Incremental ? "true" : "false") << "\n";
+
+  os << indent << "Algorithm: " << vtkParallelTransportFrame::GetAlgorithmAsString(this->Algorithm) << "\n";
 
   os << indent << "Tolerance: " << this->Tolerance << "\n";
   os << indent << "MinimumDistance: " << this->MinimumDistance << "\n";
@@ -65,189 +298,506 @@ void vtkParallelTransportFrame::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //----------------------------------------------------------------------------
-int vtkParallelTransportFrame::RequestData(
-  vtkInformation* vtkNotUsed(request),
-  vtkInformationVector** inputVector,
-  vtkInformationVector* outputVector)
+const char* vtkParallelTransportFrame::GetAlgorithmAsString(int algorithm)
 {
-  // get the info objects
-  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation* outInfo = outputVector->GetInformationObject(0);
-
-  // get the input and ouptut
-  vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
-
-  if (!this->TangentsArrayName)
+  switch (algorithm)
     {
-    vtkErrorMacro(<< "TangentsArrayName is not specified");
-    return 0;
+    case ALGORITHM_ROTATION:
+      {
+      return "rotation";
+      }
+    case ALGORITHM_DOUBLE_REFLECTION:
+      {
+      return "doubleReflection";
+      }
+    default:
+      {
+      return "";
+      }
     }
-  if (!this->NormalsArrayName)
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelTransportFrame::GetAlgorithmFromString(const char* algorithm)
+{
+  if (algorithm == nullptr)
     {
-    vtkErrorMacro(<< "NormalsArrayName is not specified");
-    return 0;
+    // invalid name
+    vtkGenericWarningMacro("Invalid algorithm name");
+    return -1;
     }
-  if (!this->BinormalsArrayName)
+  for (int i = 0; i < vtkParallelTransportFrame::ALGORITHM_LAST; i++)
     {
-    vtkErrorMacro(<< "BinormalsArrayName is not specified");
-    return 0;
+    if (strcmp(algorithm, vtkParallelTransportFrame::GetAlgorithmAsString(i)) == 0)
+      {
+      // found a matching name
+      return i;
+      }
     }
+  // name not found
+  vtkGenericWarningMacro("Unknown algorithm: " << algorithm);
+  return -1;
+}
 
-  output->DeepCopy(input);
-
-  vtkNew<vtkDoubleArray> tangentsArray;
-  tangentsArray->SetNumberOfComponents(3);
-  tangentsArray->SetName(this->TangentsArrayName);
-
-  vtkNew<vtkDoubleArray> normalsArray;
-  normalsArray->SetNumberOfComponents(3);
-  normalsArray->SetName(this->NormalsArrayName);
-
-  vtkNew<vtkDoubleArray> binormalsArray;
-  binormalsArray->SetNumberOfComponents(3);
-  binormalsArray->SetName(this->BinormalsArrayName);
-
-  vtkIdType numberOfPoints = input->GetNumberOfPoints();
-  tangentsArray->SetNumberOfTuples(numberOfPoints);
-  tangentsArray->Fill(0.0);
-  normalsArray->SetNumberOfTuples(numberOfPoints);
-  normalsArray->Fill(0.0);
-  binormalsArray->SetNumberOfTuples(numberOfPoints);
-  binormalsArray->Fill(0.0);
-
-  int numberOfCells = input->GetNumberOfCells();
-  for (int cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+//----------------------------------------------------------------------------
+const char* vtkParallelTransportFrame::GetOutputFormatAsString(int outputFormat)
+{
+  switch (outputFormat)
     {
-    this->ComputeAxisDirections(input, cellIndex, tangentsArray, normalsArray, binormalsArray);
+    case OUTPUT_FORMAT_AXIS_VECTORS:
+      {
+      return "axisVectors";
+      }
+    case OUTPUT_FORMAT_QUATERNION:
+      {
+      return "quaternion";
+      }
+    case OUTPUT_FORMAT_PACKED_FRAME:
+      {
+      return "packedFrame";
+      }
+    default:
+      {
+      return "";
+      }
     }
-
-  output->GetPointData()->AddArray(tangentsArray);
-  output->GetPointData()->AddArray(normalsArray);
-  output->GetPointData()->AddArray(binormalsArray);
-
-  return 1;
 }
 
 //----------------------------------------------------------------------------
-void vtkParallelTransportFrame::ComputeAxisDirections(vtkPolyData* input, vtkIdType cellIndex, vtkDoubleArray* tangentsArray, vtkDoubleArray* normalsArray, vtkDoubleArray* binormalsArray)
+int vtkParallelTransportFrame::GetOutputFormatFromString(const char* outputFormat)
 {
-  vtkPolyLine* polyLine = vtkPolyLine::SafeDownCast(input->GetCell(cellIndex));
-  if (!polyLine)
+  if (outputFormat == nullptr)
     {
-    return;
+    // invalid name
+    vtkGenericWarningMacro("Invalid output format name");
+    return -1;
     }
-  vtkIdType numberOfPointsInCell = polyLine->GetNumberOfPoints();
-  if (numberOfPointsInCell < 2)
+  for (int i = 0; i < vtkParallelTransportFrame::OUTPUT_FORMAT_LAST; i++)
     {
-    return;
+    if (strcmp(outputFormat, vtkParallelTransportFrame::GetOutputFormatAsString(i)) == 0)
+      {
+      // found a matching name
+      return i;
+      }
     }
+  // name not found
+  vtkGenericWarningMacro("Unknown output format: " << outputFormat);
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+/// Compute frames along the polyline cells in parallel.
+/// Cell points are read directly from the connectivity array and point coordinates from the typed point array,
+/// and frame axes are written into raw output array pointers, so that nothing is allocated per cell or point.
+struct vtkParallelTransportFrame::ComputeAxisDirectionsWorker
+{
+  vtkParallelTransportFrame* Self;
+  vtkCellArray* Lines;
+  int OutputFormat;
+  /// Output for OUTPUT_FORMAT_AXIS_VECTORS
+  double* Tangents;
+  double* Normals;
+  double* Binormals;
+  /// Output for OUTPUT_FORMAT_QUATERNION and OUTPUT_FORMAT_PACKED_FRAME
+  float* Frames;
+
+  template <typename PointArrayType>
+  void operator()(PointArrayType* pointArray)
+  {
+    const auto points = vtk::DataArrayTupleRange<3>(pointArray);
+    vtkSMPThreadLocalObject<vtkIdList> localCellPointIds;
+    vtkSMPTools::For(0, this->Lines->GetNumberOfCells(), [&](vtkIdType beginCellIndex, vtkIdType endCellIndex)
+      {
+      vtkIdList* cellPointIds = localCellPointIds.Local();
+      for (vtkIdType cellIndex = beginCellIndex; cellIndex < endCellIndex; cellIndex++)
+        {
+        vtkIdType numberOfPointsInCell = 0;
+        const vtkIdType* pointIds = nullptr;
+        this->Lines->GetCellAtId(cellIndex, numberOfPointsInCell, pointIds, cellPointIds);
+        this->ComputeCellAxisDirections(points, cellIndex, numberOfPointsInCell, pointIds);
+        }
+      });
+  }
+
+  void SetFrame(vtkIdType cellIndex, vtkIdType pointId, const double* tangent, const double* normal, const double* binormal)
+  {
+    if (!this->Self->Internal->IsPointOwner(cellIndex, pointId))
+      {
+      return;
+      }
+    switch (this->OutputFormat)
+      {
+      case vtkParallelTransportFrame::OUTPUT_FORMAT_QUATERNION:
+        {
+        // Columns of the rotation matrix are the frame axes
+        double rotation[3][3] =
+          {
+          { normal[0], binormal[0], tangent[0] },
+          { normal[1], binormal[1], tangent[1] },
+          { normal[2], binormal[2], tangent[2] }
+          };
+        double quaternion[4] = { 1.0, 0.0, 0.0, 0.0 };
+        vtkMath::Matrix3x3ToQuaternion(rotation, quaternion);
+        std::copy(quaternion, quaternion + 4, this->Frames + 4 * pointId);
+        break;
+        }
+      case vtkParallelTransportFrame::OUTPUT_FORMAT_PACKED_FRAME:
+        {
+        float* frame = this->Frames + 9 * pointId;
+        std::copy(normal, normal + 3, frame);
+        std::copy(binormal, binormal + 3, frame + 3);
+        std::copy(tangent, tangent + 3, frame + 6);
+        break;
+        }
+      default:
+        {
+        std::copy(tangent, tangent + 3, this->Tangents + 3 * pointId);
+        std::copy(normal, normal + 3, this->Normals + 3 * pointId);
+        std::copy(binormal, binormal + 3, this->Binormals + 3 * pointId);
+        break;
+        }
+      }
+  }
+
+  template <typename PointsRangeType>
+  void ComputeCellAxisDirections(const PointsRangeType& points, vtkIdType cellIndex,
+    vtkIdType numberOfPointsInCell, const vtkIdType* pointIds)
+  {
+    // In incremental mode the state of the computation at the end of the cell is stored
+    vtkInternal::CellState* state = (this->Self->Internal->CellStates.empty() ? nullptr
+      : &this->Self->Internal->CellStates[cellIndex]);
+
+    // Two-point cells are lines, not polylines, and they are ignored
+    if (numberOfPointsInCell < 3)
+      {
+      if (state)
+        {
+        state->NumberOfPoints = numberOfPointsInCell;
+        state->Continuable = false;
+        }
+      return;
+      }
+
+    auto getPoint = [&points](vtkIdType pointId, double position[3])
+      {
+      const auto point = points[pointId];
+      position[0] = static_cast<double>(point[0]);
+      position[1] = static_cast<double>(point[1]);
+      position[2] = static_cast<double>(point[2]);
+      };
+
+    double tangent0[3] = { 0.0, 0.0, 0.0 };
+    double normal0[3] = { 0.0, 0.0, 0.0 };
+    double binormal0[3] = { 0.0, 0.0, 0.0 };
+    double pointPosition0[3] = { 0.0, 0.0, 0.0 };
+    // Index of the first point that the frame is transported to
+    vtkIdType firstTransportedPointIndex = 1;
+    bool initialTangentFound = false;
+    if (state && state->Continuable)
+      {
+      // Continue the computation from the second to last point of the previous execution.
+      // The previously processed points are verified to be unchanged.
+      if (numberOfPointsInCell == state->NumberOfPoints)
+        {
+        // no new points
+        return;
+        }
+      std::copy(state->Tangent, state->Tangent + 3, tangent0);
+      std::copy(state->Normal, state->Normal + 3, normal0);
+      std::copy(state->PointPosition, state->PointPosition + 3, pointPosition0);
+      firstTransportedPointIndex = state->NumberOfPoints - 1;
+      initialTangentFound = true;
+      }
+    else
+      {
+      vtkIdType pointId0 = pointIds[0];
+      getPoint(pointId0, pointPosition0);
+
+      // Find tangent by direction vector by moving a minimal distance from the initial point
+      for (int pointIndex = 1; pointIndex < numberOfPointsInCell; pointIndex++)
+        {
+        vtkIdType pointId1 = pointIds[pointIndex];
+        double pointPosition1[3];
+        getPoint(pointId1, pointPosition1);
+        tangent0[0] = pointPosition1[0] - pointPosition0[0];
+        tangent0[1] = pointPosition1[1] - pointPosition0[1];
+        tangent0[2] = pointPosition1[2] - pointPosition0[2];
+        if (vtkMath::Norm(tangent0) >= this->Self->MinimumDistance)
+          {
+          initialTangentFound = true;
+          break;
+          }
+        }
+      vtkMath::Normalize(tangent0);
+
+      // Compute initial normal and binormal directions from the initial tangent and preferred
+      // normal/binormal directions.
+      vtkMath::Cross(tangent0, this->Self->PreferredInitialNormalVector, binormal0);
+      if (vtkMath::Norm(binormal0) > this->Self->Tolerance)
+        {
+        vtkMath::Normalize(binormal0);
+        vtkMath::Cross(binormal0, tangent0, normal0);
+        }
+      else
+        {
+        vtkMath::Cross(this->Self->PreferredInitialBinormalVector, tangent0, normal0);
+        vtkMath::Normalize(normal0);
+        vtkMath::Cross(tangent0, normal0, binormal0);
+        }
+
+      this->SetFrame(cellIndex, pointId0, tangent0, normal0, binormal0);
+      }
+
+    bool doubleReflection = (this->Self->Algorithm == vtkParallelTransportFrame::ALGORITHM_DOUBLE_REFLECTION);
+
+    vtkIdType pointId2 = -1;
+    double tangent1[3] = { tangent0[0], tangent0[1], tangent0[2] };
+    double normal1[3] = { normal0[0], normal0[1], normal0[2] };
+    double binormal1[3] = { binormal0[0], binormal0[1], binormal0[2] };
+    for (vtkIdType i = firstTransportedPointIndex; i < numberOfPointsInCell - 1; i++)
+      {
+      vtkIdType pointId1 = pointIds[i];
+      pointId2 = pointIds[i+1];
+      double pointPosition1[3];
+      double pointPosition2[3];
+      getPoint(pointId1, pointPosition1);
+      getPoint(pointId2, pointPosition2);
+
+      tangent1[0] = pointPosition2[0] - pointPosition1[0];
+      tangent1[1] = pointPosition2[1] - pointPosition1[1];
+      tangent1[2] = pointPosition2[2] - pointPosition1[2];
+
+      if (doubleReflection)
+        {
+        if (vtkMath::Normalize(tangent1) == 0.0)
+          {
+          // Repeated point, keep the previous tangent
+          tangent1[0] = tangent0[0];
+          tangent1[1] = tangent0[1];
+          tangent1[2] = tangent0[2];
+          }
+
+        // Tangents are computed from segments, therefore the first reflection plane bisects the segment
+        // between the previous and next points (scaling of the reflection vector does not matter).
+        double reflectionVector1[3] =
+          {
+          pointPosition2[0] - pointPosition0[0],
+          pointPosition2[1] - pointPosition0[1],
+          pointPosition2[2] - pointPosition0[2]
+          };
+        double reflectedTangent[3] = { tangent0[0], tangent0[1], tangent0[2] };
+        double reflectedNormal[3] = { normal0[0], normal0[1], normal0[2] };
+        double c1 = vtkMath::Dot(reflectionVector1, reflectionVector1);
+        if (c1 > 0.0)
+          {
+          double tangentFactor = 2.0 * vtkMath::Dot(reflectionVector1, tangent0) / c1;
+          double normalFactor = 2.0 * vtkMath::Dot(reflectionVector1, normal0) / c1;
+          for (int comp = 0; comp < 3; comp++)
+            {
+            reflectedTangent[comp] -= tangentFactor * reflectionVector1[comp];
+            reflectedNormal[comp] -= normalFactor * reflectionVector1[comp];
+            }
+          }
+
+        // The second reflection maps the reflected tangent to the next tangent
+        double reflectionVector2[3] =
+          {
+          tangent1[0] - reflectedTangent[0],
+          tangent1[1] - reflectedTangent[1],
+          tangent1[2] - reflectedTangent[2]
+          };
+        double c2 = vtkMath::Dot(reflectionVector2, reflectionVector2);
+        double normalFactor = (c2 > 0.0 ? 2.0 * vtkMath::Dot(reflectionVector2, reflectedNormal) / c2 : 0.0);
+        for (int comp = 0; comp < 3; comp++)
+          {
+          normal1[comp] = reflectedNormal[comp] - normalFactor * reflectionVector2[comp];
+          }
+        }
+      else
+        {
+        vtkMath::Normalize(tangent0);
+        vtkMath::Normalize(tangent1);
+
+        double dot = vtkMath::Dot(tangent0, tangent1);
+        double theta = 0.0;
+        if ((1 - dot) < this->Self->Tolerance)
+          {
+          theta = 0.0;
+          }
+        else
+          {
+          theta = acos(dot);
+          }
+
+        double rotationAxis[3];
+        vtkMath::Cross(tangent0, tangent1, rotationAxis);
+
+        vtkParallelTransportFrame::RotateVector(normal0, normal1, rotationAxis, theta);
+
+        dot = vtkMath::Dot(tangent1, normal1);
+        normal1[0] -= dot * tangent1[0];
+        normal1[1] -= dot * tangent1[1];
+        normal1[2] -= dot * tangent1[2];
+
+        vtkMath::Normalize(normal1);
+        }
+      vtkMath::Cross(tangent1, normal1, binormal1);
+
+      this->SetFrame(cellIndex, pointId1, tangent1, normal1, binormal1);
+
+      // Save current data for next iteration
+      tangent0[0] = tangent1[0];
+      tangent0[1] = tangent1[1];
+      tangent0[2] = tangent1[2];
+      normal0[0] = normal1[0];
+      normal0[1] = normal1[1];
+      normal0[2] = normal1[2];
+      pointPosition0[0] = pointPosition1[0];
+      pointPosition0[1] = pointPosition1[1];
+      pointPosition0[2] = pointPosition1[2];
+      }
+
+    if (pointId2 >= 0)
+      {
+      this->SetFrame(cellIndex, pointId2, tangent1, normal1, binormal1);
+      }
+
+    if (state)
+      {
+      // The computation cannot be continued if the initial tangent may change when points are appended
+      state->NumberOfPoints = numberOfPointsInCell;
+      state->Continuable = initialTangentFound;
+      state->LastPointOwned = this->Self->Internal->IsPointOwner(cellIndex, pointIds[numberOfPointsInCell - 1]);
+      std::copy(tangent0, tangent0 + 3, state->Tangent);
+      std::copy(normal0, normal0 + 3, state->Normal);
+      std::copy(pointPosition0, pointPosition0 + 3, state->PointPosition);
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+int vtkParallelTransportFrame::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  // get the info objects
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
 
-  double tangent0[3] = { 0.0, 0.0, 0.0 };
-  vtkIdType pointId0 = polyLine->GetPointId(0);
-  double pointPosition0[3];
-  input->GetPoint(pointId0, pointPosition0);
+  // get the input and ouptut
+  vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  // Find tangent by direction vector by moving a minimal distance from the initial point
-  for (int pointIndex = 1; pointIndex < numberOfPointsInCell; pointIndex++)
+  if (this->OutputFormat == OUTPUT_FORMAT_AXIS_VECTORS)
     {
-    vtkIdType pointId1 = polyLine->GetPointId(pointIndex);
-    double pointPosition1[3];
-    input->GetPoint(pointId1, pointPosition1);
-    tangent0[0] = pointPosition1[0] - pointPosition0[0];
-    tangent0[1] = pointPosition1[1] - pointPosition0[1];
-    tangent0[2] = pointPosition1[2] - pointPosition0[2];
-    if (vtkMath::Norm(tangent0) >= this->MinimumDistance)
-      {
-      break;
+    if (!this->TangentsArrayName)
+      {
+      vtkErrorMacro(<< "TangentsArrayName is not specified");
+      return 0;
+      }
+    if (!this->NormalsArrayName)
+      {
+      vtkErrorMacro(<< "NormalsArrayName is not specified");
+      return 0;
+      }
+    if (!this->BinormalsArrayName)
+      {
+      vtkErrorMacro(<< "BinormalsArrayName is not specified");
+      return 0;
       }
     }
-  vtkMath::Normalize(tangent0);
-
-  // Compute initial normal and binormal directions from the initial tangent and preferred
-  // normal/binormal directions.
-  double normal0[3] = {0.0, 0.0, 0.0};
-  double binormal0[3] = {0.0, 0.0, 0.0};
-  vtkMath::Cross(tangent0, this->PreferredInitialNormalVector, binormal0);
-  if (vtkMath::Norm(binormal0) > this->Tolerance)
+  else if (this->OutputFormat == OUTPUT_FORMAT_QUATERNION || this->OutputFormat == OUTPUT_FORMAT_PACKED_FRAME)
     {
-    vtkMath::Normalize(binormal0);
-    vtkMath::Cross(binormal0, tangent0, normal0);
+    if (!this->FramesArrayName)
+      {
+      vtkErrorMacro(<< "FramesArrayName is not specified");
+      return 0;
+      }
     }
   else
     {
-    vtkMath::Cross(this->PreferredInitialBinormalVector, tangent0, normal0);
-    vtkMath::Normalize(normal0);
-    vtkMath::Cross(tangent0, normal0, binormal0);
+    vtkErrorMacro(<< "Invalid output format: " << this->OutputFormat);
+    return 0;
     }
 
-  tangentsArray->SetTuple(pointId0, tangent0);
-  normalsArray->SetTuple(pointId0, normal0);
-  binormalsArray->SetTuple(pointId0, binormal0);
+  // Geometry and topology are shared with the input, only the frame arrays are allocated
+  output->ShallowCopy(input);
 
-  vtkIdType pointId2 = -1;
-  double tangent1[3] = { tangent0[0], tangent0[1], tangent0[2] };
-  double normal1[3] = { normal0[0], normal0[1], normal0[2] };
-  double binormal1[3] = { binormal0[0], binormal0[1], binormal0[2] };
-  for (int i = 1; i < numberOfPointsInCell - 1; i++)
-    {
-    vtkIdType pointId1 = polyLine->GetPointId(i);
-    pointId2 = polyLine->GetPointId(i+1);
-    double pointPosition1[3];
-    double pointPosition2[3];
-    input->GetPoint(pointId1, pointPosition1);
-    input->GetPoint(pointId2, pointPosition2);
-
-    tangent1[0] = pointPosition2[0] - pointPosition1[0];
-    tangent1[1] = pointPosition2[1] - pointPosition1[1];
-    tangent1[2] = pointPosition2[2] - pointPosition1[2];
-
-    vtkMath::Normalize(tangent0);
-    vtkMath::Normalize(tangent1);
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  vtkCellArray* lines = input->GetLines();
+  vtkIdType numberOfCells = (numberOfPoints > 0 && lines ? lines->GetNumberOfCells() : 0);
 
-    double dot = vtkMath::Dot(tangent0, tangent1);
-    double theta = 0.0;
-   if ((1 - dot) < this->Tolerance)
+  // In incremental mode only the points that were appended since the last execution are processed,
+  // if the previously processed points have not changed.
+  bool continueComputation = this->Incremental && this->Internal->InitializeContinuation(input, this->GetMTime());
+  if (!continueComputation)
+    {
+    this->Internal->FrameArrays.clear();
+    if (this->OutputFormat == OUTPUT_FORMAT_AXIS_VECTORS)
       {
-      theta = 0.0;
+      this->Internal->FrameArrays.push_back(CreateFrameArray<vtkDoubleArray>(this->TangentsArrayName, 3));
+      this->Internal->FrameArrays.push_back(CreateFrameArray<vtkDoubleArray>(this->NormalsArrayName, 3));
+      this->Internal->FrameArrays.push_back(CreateFrameArray<vtkDoubleArray>(this->BinormalsArrayName, 3));
       }
     else
       {
-      theta = acos(dot);
+      this->Internal->FrameArrays.push_back(CreateFrameArray<vtkFloatArray>(this->FramesArrayName,
+        this->OutputFormat == OUTPUT_FORMAT_QUATERNION ? 4 : 9));
       }
+    this->Internal->InitializePointOwners(lines, numberOfCells, numberOfPoints);
+    this->Internal->CellStates.assign(this->Incremental ? numberOfCells : 0, vtkInternal::CellState());
+    }
 
-    double rotationAxis[3];
-    vtkMath::Cross(tangent0, tangent1, rotationAxis);
-
-    vtkParallelTransportFrame::RotateVector(normal0, normal1, rotationAxis, theta);
-
-    dot = vtkMath::Dot(tangent1, normal1);
-    normal1[0] -= dot * tangent1[0];
-    normal1[1] -= dot * tangent1[1];
-    normal1[2] -= dot * tangent1[2];
-
-    vtkMath::Normalize(normal1);
-    vtkMath::Cross(tangent1, normal1, binormal1);
+  // Extend the frame arrays to all points (in incremental mode the previously computed values are kept)
+  ComputeAxisDirectionsWorker worker;
+  worker.Self = this;
+  worker.Lines = lines;
+  worker.OutputFormat = this->OutputFormat;
+  worker.Tangents = nullptr;
+  worker.Normals = nullptr;
+  worker.Binormals = nullptr;
+  worker.Frames = nullptr;
+  if (this->OutputFormat == OUTPUT_FORMAT_AXIS_VECTORS)
+    {
+    worker.Tangents = ResizeFrameArray(vtkDoubleArray::SafeDownCast(this->Internal->FrameArrays[0]), numberOfPoints);
+    worker.Normals = ResizeFrameArray(vtkDoubleArray::SafeDownCast(this->Internal->FrameArrays[1]), numberOfPoints);
+    worker.Binormals = ResizeFrameArray(vtkDoubleArray::SafeDownCast(this->Internal->FrameArrays[2]), numberOfPoints);
+    }
+  else
+    {
+    worker.Frames = ResizeFrameArray(vtkFloatArray::SafeDownCast(this->Internal->FrameArrays[0]), numberOfPoints);
+    }
 
-    tangentsArray->SetTuple(pointId1, tangent1);
-    normalsArray->SetTuple(pointId1, normal1);
-    binormalsArray->SetTuple(pointId1, binormal1);
+  if (numberOfCells > 0)
+    {
+    vtkDataArray* pointArray = input->GetPoints()->GetData();
+    typedef vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals> Dispatcher;
+    if (!Dispatcher::Execute(pointArray, worker))
+      {
+      // fallback to slower, non-typed array access
+      worker(pointArray);
+      }
+    }
 
-    // Save current data for next iteration
-    tangent0[0] = tangent1[0];
-    tangent0[1] = tangent1[1];
-    tangent0[2] = tangent1[2];
-    normal0[0] = normal1[0];
-    normal0[1] = normal1[1];
-    normal0[2] = normal1[2];
+  for (vtkDataArray* frameArray : this->Internal->FrameArrays)
+    {
+    // values were written directly into the array memory
+    frameArray->Modified();
+    output->GetPointData()->AddArray(frameArray);
     }
 
-  if (pointId2 >= 0)
+  if (this->Incremental)
     {
-    tangentsArray->SetTuple(pointId2, tangent1);
-    normalsArray->SetTuple(pointId2, normal1);
-    binormalsArray->SetTuple(pointId2, binormal1);
+    this->Internal->StoreProcessedPoints(input, numberOfCells);
+    this->Internal->ComputeTime.Modified();
     }
+  else
+    {
+    this->Internal->FrameArrays.clear();
+    }
+
+  return 1;
 }
 
 //----------------------------------------------------------------------------
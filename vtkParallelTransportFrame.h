@@ -30,6 +30,8 @@
 /// - Parallel transport implementation: Piccinelli M, Veneziani A, Steinman DA, Remuzzi A, Antiga L.
 ///   "A framework for geometric analysis of vascular structures: application to cerebral aneurysms.",
 ///   IEEE Trans Med Imaging. 2009 Aug;28(8):1141-55. doi: 10.1109/TMI.2009.2021652.
+/// - Double reflection method: W. Wang, B. Juttler, D. Zheng, Y. Liu, "Computation of rotation minimizing frames",
+///   ACM Transactions on Graphics, vol. 27, no. 1, pp. 2:1-2:18, 2008. doi: 10.1145/1330511.1330513.
 /// 
 /// The initial implementation was based on VMTK (vtkvmtkCenterlineAttributesFilter) which was optimized
 /// and enhanced with more predictable initial normal vector direction. In the future, support for closed
@@ -70,6 +72,49 @@ public:
   vtkGetStringMacro(BinormalsArrayName);
   ///@} 
 
+  ///@{
+  /// Get/set the point array name that contains the frames if the output format is
+  /// OUTPUT_FORMAT_QUATERNION or OUTPUT_FORMAT_PACKED_FRAME.
+  /// Default value is "Frames"
+  vtkSetStringMacro(FramesArrayName);
+  vtkGetStringMacro(FramesArrayName);
+  ///@}
+
+  /// Format of the frames in the output point data.
+  ///     OUTPUT_FORMAT_AXIS_VECTORS = three 3-component double arrays: TangentsArrayName, NormalsArrayName,
+  ///                                  BinormalsArrayName (72 bytes per point)
+  ///     OUTPUT_FORMAT_QUATERNION   = one 4-component float array (FramesArrayName) containing the rotation
+  ///                                  from the coordinate system axes to the frame axes as a (w, x, y, z)
+  ///                                  quaternion (16 bytes per point)
+  ///     OUTPUT_FORMAT_PACKED_FRAME = one 9-component float array (FramesArrayName) containing the
+  ///                                  normal, binormal, and tangent vectors (36 bytes per point)
+  /// Points that are not part of any polyline get all-zero values.
+  /// Default is OUTPUT_FORMAT_AXIS_VECTORS.
+  enum
+    {
+    OUTPUT_FORMAT_AXIS_VECTORS,
+    OUTPUT_FORMAT_QUATERNION,
+    OUTPUT_FORMAT_PACKED_FRAME,
+    OUTPUT_FORMAT_LAST,
+    };
+  static const char* GetOutputFormatAsString(int outputFormat);
+  static int GetOutputFormatFromString(const char* outputFormat);
+  vtkSetMacro(OutputFormat, int);
+  vtkGetMacro(OutputFormat, int);
+
+  /// Compute frames incrementally for polylines that are extended by appending points (for example,
+  /// a curve that is acquired by tracking a device).
+  /// If enabled, the state of the computation at the end of each cell is stored, and in the next execution
+  /// frames are computed only for the newly appended points (and the previous last point of each cell),
+  /// instead of processing all points. The frame arrays are reused between executions.
+  /// All frames are recomputed if the filter is modified, the number of points or cells decreases,
+  /// or any previously processed point position or cell point ID has changed. Changes are detected
+  /// by comparing the input with a copy of the previously processed point coordinates and cell point IDs.
+  /// Default is false.
+  vtkSetMacro(Incremental, bool);
+  vtkGetMacro(Incremental, bool);
+  vtkBooleanMacro(Incremental, bool);
+
   /// Define the preferred direction of the normal vector at the first point of the curve.
   /// It is just "preferred" because the direction has to be orhogonal to the tangent,
   /// so in general the normal vector cannot point into exactly to a required direction.
@@ -88,30 +133,57 @@ public:
   vtkGetVectorMacro(PreferredInitialBinormalVector, double, 3);
   ///@}
 
+  /// Algorithm for transporting the frame from one point to the next.
+  ///     ALGORITHM_ROTATION          = rotate the normal by the angle between the tangents of consecutive
+  ///                                   segments around their cross product, then re-orthogonalize it
+  ///     ALGORITHM_DOUBLE_REFLECTION = reflect the frame across the plane orthogonal to the chord between the
+  ///                                   previous and next points, then across the plane that maps the reflected
+  ///                                   tangent to the next tangent (Wang et al. 2008). It does not require
+  ///                                   trigonometric functions, therefore it is faster and it is more accurate
+  ///                                   when consecutive tangents are nearly parallel.
+  /// Default is ALGORITHM_ROTATION.
+  enum
+    {
+    ALGORITHM_ROTATION,
+    ALGORITHM_DOUBLE_REFLECTION,
+    ALGORITHM_LAST,
+    };
+  static const char* GetAlgorithmAsString(int algorithm);
+  static int GetAlgorithmFromString(const char* algorithm);
+  vtkSetClampMacro(Algorithm, int, ALGORITHM_ROTATION, ALGORITHM_LAST - 1);
+  vtkGetMacro(Algorithm, int);
+
 protected:
   vtkParallelTransportFrame();
   ~vtkParallelTransportFrame() override;
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
-  void ComputeAxisDirections(vtkPolyData* input, vtkIdType cellIndex, vtkDoubleArray* tangentsArray, vtkDoubleArray* normalsArray, vtkDoubleArray* binormalsArray);
-
   /// Rotate a vector around an axis
   static void RotateVector(double* inVector, double* outVector, const double* axis, double angle);
 
 private:
+  struct ComputeAxisDirectionsWorker;
+  class vtkInternal;
+  vtkInternal* Internal;
+
   vtkParallelTransportFrame(const vtkParallelTransportFrame&) = delete;
   void operator=(const vtkParallelTransportFrame&) = delete;
 
   char* TangentsArrayName = nullptr;
   char* NormalsArrayName = nullptr;
   char* BinormalsArrayName = nullptr;
+  char* FramesArrayName = nullptr;
 
   /// Tolerance value used for checking that a value is non-zero.
   double Tolerance = 1e-6;
   /// Minimum distance for comuting initial tangent direction
   double MinimumDistance = 1e-3;
   
+  int Algorithm = ALGORITHM_ROTATION;
+  int OutputFormat = OUTPUT_FORMAT_AXIS_VECTORS;
+  bool Incremental = false;
+
   double PreferredInitialNormalVector[3] = { 1.0, 0.0, 0.0 };
   double PreferredInitialBinormalVector[3] = { 0.0, 0.0, 0.0 };
 };
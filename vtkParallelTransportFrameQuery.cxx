@@ -0,0 +1,370 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include <algorithm> // VTK 8.2.0 has bug for C++17 "clamp" function (algorithm must be included before vtMath.h)
+
+#include "vtkParallelTransportFrameQuery.h"
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <cmath>
+
+vtkStandardNewMacro(vtkParallelTransportFrameQuery);
+
+//----------------------------------------------------------------------------
+vtkParallelTransportFrameQuery::vtkParallelTransportFrameQuery()
+{
+  this->SetTangentsArrayName("Tangents");
+  this->SetNormalsArrayName("Normals");
+  this->SetBinormalsArrayName("Binormals");
+  this->SetFramesArrayName("Frames");
+}
+
+//----------------------------------------------------------------------------
+vtkParallelTransportFrameQuery::~vtkParallelTransportFrameQuery()
+{
+  this->SetTangentsArrayName(nullptr);
+  this->SetNormalsArrayName(nullptr);
+  this->SetBinormalsArrayName(nullptr);
+  this->SetFramesArrayName(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelTransportFrameQuery::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "TangentsArrayName: " << (this->TangentsArrayName ? this->TangentsArrayName : "(none)") << "\n";
+  os << indent << "NormalsArrayName: " << (this->NormalsArrayName ? this->NormalsArrayName : "(none)") << "\n";
+  os << indent << "BinormalsArrayName: " << (this->BinormalsArrayName ? this->BinormalsArrayName : "(none)") << "\n";
+  os << indent << "FramesArrayName: " << (this->FramesArrayName ? this->FramesArrayName : "(none)") << "\n";
+  os << indent << "NumberOfCurvePoints: " << this->GetNumberOfCurvePoints() << "\n";
+  os << indent << "CurveLength: " << this->GetCurveLength() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkParallelTransportFrameQuery::Build(vtkPolyData* curve, vtkIdType cellIndex)
+{
+  this->ArcLengths.clear();
+  this->Positions.clear();
+  this->Quaternions.clear();
+  this->Modified();
+
+  vtkCellArray* lines = (curve ? curve->GetLines() : nullptr);
+  if (!lines || !curve->GetPoints() || cellIndex < 0 || cellIndex >= lines->GetNumberOfCells())
+    {
+    vtkErrorMacro("Build failed: invalid curve or cell index " << cellIndex);
+    return false;
+    }
+
+  vtkPointData* pointData = curve->GetPointData();
+  vtkDataArray* tangentsArray = (this->TangentsArrayName ? pointData->GetArray(this->TangentsArrayName) : nullptr);
+  vtkDataArray* normalsArray = (this->NormalsArrayName ? pointData->GetArray(this->NormalsArrayName) : nullptr);
+  vtkDataArray* binormalsArray = (this->BinormalsArrayName ? pointData->GetArray(this->BinormalsArrayName) : nullptr);
+  vtkDataArray* framesArray = (this->FramesArrayName ? pointData->GetArray(this->FramesArrayName) : nullptr);
+  bool useAxisArrays = (tangentsArray && normalsArray && binormalsArray);
+  if (!useAxisArrays && (!framesArray
+    || (framesArray->GetNumberOfComponents() != 4 && framesArray->GetNumberOfComponents() != 9)))
+    {
+    vtkErrorMacro("Build failed: the curve does not contain frame arrays");
+    return false;
+    }
+
+  vtkNew<vtkIdList> pointIds;
+  lines->GetCellAtId(cellIndex, pointIds);
+  vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+  if (numberOfPoints == 0)
+    {
+    vtkErrorMacro("Build failed: cell " << cellIndex << " is empty");
+    return false;
+    }
+
+  this->ArcLengths.resize(numberOfPoints);
+  this->Positions.resize(3 * numberOfPoints);
+  this->Quaternions.resize(4 * numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    vtkIdType pointId = pointIds->GetId(pointIndex);
+    double* position = &this->Positions[3 * pointIndex];
+    curve->GetPoint(pointId, position);
+    this->ArcLengths[pointIndex] = (pointIndex == 0 ? 0.0 : this->ArcLengths[pointIndex - 1]
+      + sqrt(vtkMath::Distance2BetweenPoints(position - 3, position)));
+
+    double* quaternion = &this->Quaternions[4 * pointIndex];
+    // Frames are not computed for some points (for example, if the cell has less than 3 points),
+    // these are stored as zero quaternion or zero axis vectors.
+    bool validFrame = true;
+    if (!useAxisArrays && framesArray->GetNumberOfComponents() == 4)
+      {
+      framesArray->GetTuple(pointId, quaternion);
+      }
+    else
+      {
+      double axes[3][3] = { { 0.0 } }; // normal, binormal, tangent
+      if (useAxisArrays)
+        {
+        normalsArray->GetTuple(pointId, axes[0]);
+        binormalsArray->GetTuple(pointId, axes[1]);
+        tangentsArray->GetTuple(pointId, axes[2]);
+        }
+      else
+        {
+        double packedAxes[9] = { 0.0 };
+        framesArray->GetTuple(pointId, packedAxes);
+        std::copy(packedAxes, packedAxes + 9, &axes[0][0]);
+        }
+      // Matrix3x3ToQuaternion would convert zero axes to a valid quaternion, therefore axes are checked here
+      for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+        {
+        if (vtkMath::Norm(axes[axisIndex]) < 1e-6)
+          {
+          validFrame = false;
+          }
+        }
+      // Columns of the rotation matrix are the frame axes
+      double rotation[3][3] = { { 0.0 } };
+      for (int i = 0; i < 3; i++)
+        {
+        for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+          {
+          rotation[i][axisIndex] = axes[axisIndex][i];
+          }
+        }
+      vtkMath::Matrix3x3ToQuaternion(rotation, quaternion);
+      }
+
+    double quaternionNorm = sqrt(quaternion[0] * quaternion[0] + quaternion[1] * quaternion[1]
+      + quaternion[2] * quaternion[2] + quaternion[3] * quaternion[3]);
+    if (!validFrame || quaternionNorm < 1e-6)
+      {
+      vtkErrorMacro("Build failed: invalid frame at point " << pointId);
+      this->ArcLengths.clear();
+      this->Positions.clear();
+      this->Quaternions.clear();
+      return false;
+      }
+    // q and -q represent the same rotation, choose the one that is closer to the previous quaternion
+    // so that interpolation takes the shortest path.
+    double sign = 1.0;
+    if (pointIndex > 0)
+      {
+      const double* previousQuaternion = quaternion - 4;
+      double dot = previousQuaternion[0] * quaternion[0] + previousQuaternion[1] * quaternion[1]
+        + previousQuaternion[2] * quaternion[2] + previousQuaternion[3] * quaternion[3];
+      sign = (dot < 0.0 ? -1.0 : 1.0);
+      }
+    for (int i = 0; i < 4; i++)
+      {
+      quaternion[i] *= sign / quaternionNorm;
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkParallelTransportFrameQuery::GetCurveLength()
+{
+  return (this->ArcLengths.empty() ? 0.0 : this->ArcLengths.back());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkParallelTransportFrameQuery::GetNumberOfCurvePoints()
+{
+  return static_cast<vtkIdType>(this->ArcLengths.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelTransportFrameQuery::InterpolateFrame(double arcLength, double position[3], double quaternion[4])
+{
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(this->ArcLengths.size());
+  if (numberOfPoints == 1)
+    {
+    std::copy(this->Positions.begin(), this->Positions.begin() + 3, position);
+    std::copy(this->Quaternions.begin(), this->Quaternions.begin() + 4, quaternion);
+    return;
+    }
+
+  // Find the segment that contains the arc length position
+  arcLength = std::max(0.0, std::min(arcLength, this->ArcLengths.back()));
+  vtkIdType segmentIndex = static_cast<vtkIdType>(
+    std::upper_bound(this->ArcLengths.begin(), this->ArcLengths.end(), arcLength) - this->ArcLengths.begin()) - 1;
+  segmentIndex = std::max<vtkIdType>(0, std::min<vtkIdType>(segmentIndex, numberOfPoints - 2));
+  double segmentLength = this->ArcLengths[segmentIndex + 1] - this->ArcLengths[segmentIndex];
+  double t = (segmentLength > 0.0 ? (arcLength - this->ArcLengths[segmentIndex]) / segmentLength : 0.0);
+
+  const double* position0 = &this->Positions[3 * segmentIndex];
+  const double* position1 = position0 + 3;
+  for (int i = 0; i < 3; i++)
+    {
+    position[i] = (1.0 - t) * position0[i] + t * position1[i];
+    }
+
+  // Spherical linear interpolation. Quaternions of consecutive points are in the same hemisphere.
+  const double* quaternion0 = &this->Quaternions[4 * segmentIndex];
+  const double* quaternion1 = quaternion0 + 4;
+  double dot = quaternion0[0] * quaternion1[0] + quaternion0[1] * quaternion1[1]
+    + quaternion0[2] * quaternion1[2] + quaternion0[3] * quaternion1[3];
+  double weight0 = 1.0 - t;
+  double weight1 = t;
+  if (dot < 0.9995)
+    {
+    double theta = acos(std::max(-1.0, dot));
+    double sinTheta = sin(theta);
+    weight0 = sin((1.0 - t) * theta) / sinTheta;
+    weight1 = sin(t * theta) / sinTheta;
+    }
+  // else: the quaternions are almost the same, linear interpolation is accurate
+  double norm2 = 0.0;
+  for (int i = 0; i < 4; i++)
+    {
+    quaternion[i] = weight0 * quaternion0[i] + weight1 * quaternion1[i];
+    norm2 += quaternion[i] * quaternion[i];
+    }
+  double norm = sqrt(norm2);
+  for (int i = 0; i < 4; i++)
+    {
+    quaternion[i] /= norm;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkParallelTransportFrameQuery::GetFrame(double arcLength, double position[3],
+  double normal[3], double binormal[3], double tangent[3])
+{
+  if (this->ArcLengths.empty())
+    {
+    vtkErrorMacro("GetFrame failed: query is not built");
+    return false;
+    }
+  double interpolatedPosition[3] = { 0.0, 0.0, 0.0 };
+  double quaternion[4] = { 1.0, 0.0, 0.0, 0.0 };
+  this->InterpolateFrame(arcLength, interpolatedPosition, quaternion);
+  double rotation[3][3] = { { 0.0 } };
+  vtkMath::QuaternionToMatrix3x3(quaternion, rotation);
+  double* axes[3] = { normal, binormal, tangent };
+  for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+    {
+    if (axes[axisIndex])
+      {
+      for (int i = 0; i < 3; i++)
+        {
+        axes[axisIndex][i] = rotation[i][axisIndex];
+        }
+      }
+    }
+  if (position)
+    {
+    std::copy(interpolatedPosition, interpolatedPosition + 3, position);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkParallelTransportFrameQuery::GetFrame(double arcLength, vtkMatrix4x4* frame)
+{
+  if (!frame)
+    {
+    vtkErrorMacro("GetFrame failed: invalid frame matrix");
+    return false;
+    }
+  double axes[4][3] = { { 0.0 } }; // normal, binormal, tangent, position
+  if (!this->GetFrame(arcLength, axes[3], axes[0], axes[1], axes[2]))
+    {
+    return false;
+    }
+  frame->Identity();
+  for (int columnIndex = 0; columnIndex < 4; columnIndex++)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      frame->SetElement(i, columnIndex, axes[columnIndex][i]);
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkParallelTransportFrameQuery::GetFrames(vtkDoubleArray* arcLengths, vtkDoubleArray* positions,
+  vtkDoubleArray* normals, vtkDoubleArray* binormals, vtkDoubleArray* tangents)
+{
+  if (this->ArcLengths.empty())
+    {
+    vtkErrorMacro("GetFrames failed: query is not built");
+    return false;
+    }
+  if (!arcLengths || arcLengths->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("GetFrames failed: arc lengths must be specified in a single-component array");
+    return false;
+    }
+
+  vtkIdType numberOfFrames = arcLengths->GetNumberOfTuples();
+  vtkDoubleArray* outputArrays[4] = { positions, normals, binormals, tangents };
+  double* outputValues[4] = { nullptr, nullptr, nullptr, nullptr };
+  for (int arrayIndex = 0; arrayIndex < 4; arrayIndex++)
+    {
+    if (outputArrays[arrayIndex])
+      {
+      outputArrays[arrayIndex]->SetNumberOfComponents(3);
+      outputArrays[arrayIndex]->SetNumberOfTuples(numberOfFrames);
+      outputValues[arrayIndex] = outputArrays[arrayIndex]->GetPointer(0);
+      }
+    }
+  const double* arcLengthValues = arcLengths->GetPointer(0);
+
+  vtkSMPTools::For(0, numberOfFrames, [&](vtkIdType beginFrameIndex, vtkIdType endFrameIndex)
+    {
+    for (vtkIdType frameIndex = beginFrameIndex; frameIndex < endFrameIndex; frameIndex++)
+      {
+      double position[3] = { 0.0, 0.0, 0.0 };
+      double quaternion[4] = { 1.0, 0.0, 0.0, 0.0 };
+      this->InterpolateFrame(arcLengthValues[frameIndex], position, quaternion);
+      if (outputValues[0])
+        {
+        std::copy(position, position + 3, outputValues[0] + 3 * frameIndex);
+        }
+      if (!outputValues[1] && !outputValues[2] && !outputValues[3])
+        {
+        continue;
+        }
+      double rotation[3][3] = { { 0.0 } };
+      vtkMath::QuaternionToMatrix3x3(quaternion, rotation);
+      for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+        {
+        double* axis = outputValues[axisIndex + 1];
+        if (axis)
+          {
+          axis += 3 * frameIndex;
+          axis[0] = rotation[0][axisIndex];
+          axis[1] = rotation[1][axisIndex];
+          axis[2] = rotation[2][axisIndex];
+          }
+        }
+      }
+    });
+
+  for (int arrayIndex = 0; arrayIndex < 4; arrayIndex++)
+    {
+    if (outputArrays[arrayIndex])
+      {
+      outputArrays[arrayIndex]->Modified();
+      }
+    }
+  return true;
+}
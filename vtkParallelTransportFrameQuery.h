@@ -0,0 +1,117 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+/// \brief Get interpolated coordinate frames at arbitrary arc length positions along a curve.
+///
+/// The query is built from a polyline that has coordinate frames stored at its points, typically the output
+/// of vtkParallelTransportFrame (all output formats are supported). Cumulative arc length of the points
+/// is computed once when the query is built, and then the frame at any arc length position is found by binary search
+/// of the curve segment, linear interpolation of the position, and spherical linear interpolation (slerp)
+/// of the orientation, so that the interpolated frame is always orthonormal.
+///
+/// This is useful for example for generating reformat planes along a curve (curved planar reformatting).
+/// Queries of a built object are thread-safe.
+///
+/// Vectors of the basis: normal (x), binormal (y), tangent (z).
+/// \sa vtkParallelTransportFrame
+
+#ifndef vtkParallelTransportFrameQuery_h
+#define vtkParallelTransportFrameQuery_h
+
+#include "vtkAddon.h"  // For export macro
+#include <vtkObject.h>
+
+// STD includes
+#include <vector>
+
+class vtkDoubleArray;
+class vtkMatrix4x4;
+class vtkPolyData;
+
+class VTK_ADDON_EXPORT vtkParallelTransportFrameQuery : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkParallelTransportFrameQuery, vtkObject);
+  static vtkParallelTransportFrameQuery* New();
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /// Get/set the point array names that contain the tangent (z), normal (x), and binormal (y) axes.
+  /// These arrays are used if all of them are present in the curve.
+  /// Default values are the same as in vtkParallelTransportFrame.
+  vtkSetStringMacro(TangentsArrayName);
+  vtkGetStringMacro(TangentsArrayName);
+  vtkSetStringMacro(NormalsArrayName);
+  vtkGetStringMacro(NormalsArrayName);
+  vtkSetStringMacro(BinormalsArrayName);
+  vtkGetStringMacro(BinormalsArrayName);
+  ///@}
+
+  ///@{
+  /// Get/set the point array name that contains the frames as quaternions (4 components)
+  /// or packed axes (9 components). It is used if the axis arrays are not present in the curve.
+  /// Default value is "Frames".
+  /// \sa vtkParallelTransportFrame::SetOutputFormat()
+  vtkSetStringMacro(FramesArrayName);
+  vtkGetStringMacro(FramesArrayName);
+  ///@}
+
+  /// Build the query from a line cell of the curve. The curve is not referenced after the query is built.
+  /// Returns false if the cell does not exist or frames are not available at all its points
+  /// (e.g., because the cell has less than 3 points).
+  bool Build(vtkPolyData* curve, vtkIdType cellIndex = 0);
+
+  /// Length of the curve. Returns 0 if the query is not built.
+  double GetCurveLength();
+
+  /// Number of curve points that the query was built from.
+  vtkIdType GetNumberOfCurvePoints();
+
+  /// Get the interpolated position and frame axes at the specified arc length along the curve
+  /// (distance from the first point). Arc length is clamped to the curve length.
+  /// Any of the output pointers may be nullptr.
+  /// Returns false if the query is not built.
+  bool GetFrame(double arcLength, double position[3], double normal[3], double binormal[3], double tangent[3]);
+
+  /// Get the interpolated frame at the specified arc length along the curve as a transformation matrix.
+  /// Columns of the matrix are the normal, binormal, tangent axes, and the position.
+  /// Returns false if the query is not built.
+  bool GetFrame(double arcLength, vtkMatrix4x4* frame);
+
+  /// Get the interpolated positions and frame axes at multiple arc length positions, using multiple threads.
+  /// Output arrays are 3-component arrays that are resized to the number of arc length values.
+  /// Any of the output arrays may be nullptr.
+  /// Returns false if the query is not built.
+  bool GetFrames(vtkDoubleArray* arcLengths, vtkDoubleArray* positions,
+    vtkDoubleArray* normals, vtkDoubleArray* binormals, vtkDoubleArray* tangents);
+
+protected:
+  vtkParallelTransportFrameQuery();
+  ~vtkParallelTransportFrameQuery() override;
+  vtkParallelTransportFrameQuery(const vtkParallelTransportFrameQuery&) = delete;
+  void operator=(const vtkParallelTransportFrameQuery&) = delete;
+
+  /// Get interpolated position and orientation (as a quaternion) at the arc length.
+  void InterpolateFrame(double arcLength, double position[3], double quaternion[4]);
+
+  char* TangentsArrayName = nullptr;
+  char* NormalsArrayName = nullptr;
+  char* BinormalsArrayName = nullptr;
+  char* FramesArrayName = nullptr;
+
+  /// Cumulative arc length at each curve point
+  std::vector<double> ArcLengths;
+  /// Position of each curve point (3 values per point)
+  std::vector<double> Positions;
+  /// Orientation of the frame at each curve point as a (w, x, y, z) quaternion (4 values per point).
+  /// Signs are chosen so that quaternions of consecutive points are in the same hemisphere.
+  std::vector<double> Quaternions;
+};
+
+#endif // vtkParallelTransportFrameQuery_h
@@ -0,0 +1,776 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkSlicerDijkstraGraph.h"
+#include "vtkSlicerDijkstraGraphGeodesicPath.h"
+#include "vtkSlicerDijkstraGraphQuery.h"
+
+// VTK includes
+#include <vtkArrayDispatch.h>
+#include <vtkCellArray.h>
+#include <vtkDataArrayRange.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+/// Get the sorted list of distinct vertices that share a polygon edge with vertex u.
+/// Cell links must be built in the mesh. cellPointIdsBuffer is used by the mesh for thread-safe access to cell points.
+void GetVertexNeighbors(vtkPolyData* mesh, vtkIdType u, vtkIdList* cellPointIdsBuffer, std::vector<vtkIdType>& neighbors)
+{
+  neighbors.clear();
+  vtkIdType numberOfCells = 0;
+  vtkIdType* cellIds = nullptr;
+  mesh->GetPointCells(u, numberOfCells, cellIds);
+  for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+    {
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* cellPointIds = nullptr;
+    mesh->GetCellPoints(cellIds[cellIndex], numberOfCellPoints, cellPointIds, cellPointIdsBuffer);
+    for (vtkIdType i = 0; i < numberOfCellPoints; i++)
+      {
+      // All occurrences are checked, as a vertex may appear multiple times in a degenerate polygon
+      if (cellPointIds[i] == u)
+        {
+        neighbors.push_back(cellPointIds[(i + numberOfCellPoints - 1) % numberOfCellPoints]);
+        neighbors.push_back(cellPointIds[(i + 1) % numberOfCellPoints]);
+        }
+      }
+    }
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), u), neighbors.end());
+}
+
+//------------------------------------------------------------------------------
+/// Computes the cost of all edges in both directions from the typed point coordinates
+/// and the first component of the scalars, in parallel over the vertices.
+/// If UpdatedVertices is set then only the edges that start or end at those vertices are computed.
+struct ComputeEdgeCostsWorker
+{
+  const vtkIdType* Offsets;
+  const vtkIdType* Neighbors;
+  float* Costs;
+  float* TransposedCosts;
+  /// Scalar value of each vertex that the costs are computed from is stored here, if not nullptr
+  double* Scalars;
+  vtkIdType NumberOfVertices;
+  int CostFunctionType;
+  const vtkIdType* UpdatedVertices;
+  vtkIdType NumberOfUpdatedVertices;
+
+  template <typename PointArrayType, typename ScalarArrayType>
+  void operator()(PointArrayType* pointArray, ScalarArrayType* scalarArray)
+  {
+    const auto scalars = vtk::DataArrayTupleRange(scalarArray);
+    this->Compute(pointArray, [&scalars](vtkIdType v) { return static_cast<double>(scalars[v][0]); });
+  }
+
+  /// Compute costs without scalar weights
+  template <typename PointArrayType>
+  void operator()(PointArrayType* pointArray)
+  {
+    this->Compute(pointArray, [](vtkIdType) { return 0.0; });
+  }
+
+  template <typename PointArrayType, typename ScalarFunctionType>
+  void Compute(PointArrayType* pointArray, const ScalarFunctionType& getScalar)
+  {
+    const auto points = vtk::DataArrayTupleRange<3>(pointArray);
+
+    // Compute the costs of edges of vertex u in the specified index range
+    auto computeVertexEdgeCosts = [&](vtkIdType u, vtkIdType beginEdge, vtkIdType endEdge)
+      {
+      const auto pointU = points[u];
+      double scalarU = getScalar(u);
+      for (vtkIdType edgeIndex = beginEdge; edgeIndex < endEdge; edgeIndex++)
+        {
+        vtkIdType v = this->Neighbors[edgeIndex];
+        const auto pointV = points[v];
+        double distance2 = 0.0;
+        for (int i = 0; i < 3; i++)
+          {
+          double difference = static_cast<double>(pointV[i]) - static_cast<double>(pointU[i]);
+          distance2 += difference * difference;
+          }
+        double distance = sqrt(distance2);
+        this->Costs[edgeIndex] = static_cast<float>(
+          vtkSlicerDijkstraGraph::GetWeightedEdgeCost(this->CostFunctionType, distance, getScalar(v)));
+        this->TransposedCosts[edgeIndex] = static_cast<float>(
+          vtkSlicerDijkstraGraph::GetWeightedEdgeCost(this->CostFunctionType, distance, scalarU));
+        }
+      };
+
+    if (!this->UpdatedVertices)
+      {
+      vtkSMPTools::For(0, this->NumberOfVertices, [&](vtkIdType beginVertex, vtkIdType endVertex)
+        {
+        for (vtkIdType u = beginVertex; u < endVertex; u++)
+          {
+          if (this->Scalars)
+            {
+            this->Scalars[u] = getScalar(u);
+            }
+          computeVertexEdgeCosts(u, this->Offsets[u], this->Offsets[u + 1]);
+          }
+        });
+      return;
+      }
+
+    // Only a few vertices are updated and adjacent updated vertices write the same edges,
+    // therefore they are processed serially.
+    for (vtkIdType i = 0; i < this->NumberOfUpdatedVertices; i++)
+      {
+      vtkIdType u = this->UpdatedVertices[i];
+      if (this->Scalars)
+        {
+        this->Scalars[u] = getScalar(u);
+        }
+      computeVertexEdgeCosts(u, this->Offsets[u], this->Offsets[u + 1]);
+      for (vtkIdType edgeIndex = this->Offsets[u]; edgeIndex < this->Offsets[u + 1]; edgeIndex++)
+        {
+        // The edge v -> u is found by binary search, as neighbors of each vertex are sorted
+        vtkIdType v = this->Neighbors[edgeIndex];
+        const vtkIdType* neighborsBegin = this->Neighbors + this->Offsets[v];
+        const vtkIdType* neighborsEnd = this->Neighbors + this->Offsets[v + 1];
+        const vtkIdType* reverseEdge = std::lower_bound(neighborsBegin, neighborsEnd, u);
+        if (reverseEdge != neighborsEnd && *reverseEdge == u)
+          {
+          vtkIdType reverseEdgeIndex = reverseEdge - this->Neighbors;
+          computeVertexEdgeCosts(v, reverseEdgeIndex, reverseEdgeIndex + 1);
+          }
+        }
+      }
+  }
+};
+
+//------------------------------------------------------------------------------
+/// Finds the vertices whose scalar value (first component) is different from the stored value.
+struct FindModifiedScalarsWorker
+{
+  const double* Scalars;
+  vtkIdType NumberOfVertices;
+  std::vector<vtkIdType> ModifiedVertices;
+
+  template <typename ScalarArrayType>
+  void operator()(ScalarArrayType* scalarArray)
+  {
+    const auto scalars = vtk::DataArrayTupleRange(scalarArray);
+    vtkSMPThreadLocal<std::vector<vtkIdType>> localModifiedVertices;
+    vtkSMPTools::For(0, this->NumberOfVertices, [&](vtkIdType beginVertex, vtkIdType endVertex)
+      {
+      std::vector<vtkIdType>& modifiedVertices = localModifiedVertices.Local();
+      for (vtkIdType v = beginVertex; v < endVertex; v++)
+        {
+        if (static_cast<double>(scalars[v][0]) != this->Scalars[v])
+          {
+          modifiedVertices.push_back(v);
+          }
+        }
+      });
+    this->ModifiedVertices.clear();
+    for (const std::vector<vtkIdType>& modifiedVertices : localModifiedVertices)
+      {
+      this->ModifiedVertices.insert(this->ModifiedVertices.end(), modifiedVertices.begin(), modifiedVertices.end());
+      }
+    std::sort(this->ModifiedVertices.begin(), this->ModifiedVertices.end());
+  }
+};
+
+} // end anonymous namespace
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerDijkstraGraph);
+
+//------------------------------------------------------------------------------
+vtkSlicerDijkstraGraph::vtkSlicerDijkstraGraph()
+{
+  this->Offsets.push_back(0);
+  this->RequestedNumberOfLandmarks = 0;
+  this->CostFunctionType = vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE;
+  this->UseScalarWeights = false;
+  this->MaximumEdgeLength = 0.0;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerDijkstraGraph::~vtkSlicerDijkstraGraph() = default;
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::PrintSelf(std::ostream &os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfVertices: " << this->GetNumberOfVertices() << std::endl;
+  os << indent << "NumberOfEdges: " << this->GetNumberOfEdges() << std::endl;
+  os << indent << "CostFunctionType: "
+    << vtkSlicerDijkstraGraphGeodesicPath::GetCostFunctionTypeAsString(this->CostFunctionType) << std::endl;
+  os << indent << "UseScalarWeights: " << (this->UseScalarWeights ? "true" : "false") << std::endl;
+  os << indent << "NumberOfTriangles: " << this->GetNumberOfTriangles() << std::endl;
+  os << indent << "NumberOfLandmarks: " << this->GetNumberOfLandmarks() << std::endl;
+  os << indent << "RequestedNumberOfLandmarks: " << this->RequestedNumberOfLandmarks << std::endl;
+}
+
+//------------------------------------------------------------------------------
+double vtkSlicerDijkstraGraph::GetWeightedEdgeCost(int costFunctionType, double distance, double scalar)
+{
+  switch (costFunctionType)
+    {
+    case vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_ADDITIVE:
+      return distance + scalar;
+    case vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_MULTIPLICATIVE:
+      return distance * scalar;
+    case vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_INVERSE_SQUARED:
+      // same as the vtkDijkstraGraphGeodesicPath cost function
+      return (scalar != 0.0 ? distance / (scalar * scalar) : distance);
+    default:
+      return distance;
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSlicerDijkstraGraph::GetNumberOfVertices()
+{
+  return static_cast<vtkIdType>(this->Offsets.size()) - 1;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSlicerDijkstraGraph::GetNumberOfEdges()
+{
+  return static_cast<vtkIdType>(this->Neighbors.size());
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerDijkstraGraph::GetNumberOfLandmarks()
+{
+  return static_cast<int>(this->Landmarks.size());
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::Build(vtkPolyData* mesh, int costFunctionType, bool useScalarWeights)
+{
+  vtkIdType numberOfVertices = (mesh ? mesh->GetNumberOfPoints() : 0);
+  this->Offsets.assign(numberOfVertices + 1, 0);
+  this->Neighbors.clear();
+  this->Costs.clear();
+  this->TransposedCosts.clear();
+  this->Scalars.clear();
+  this->Triangles.clear();
+  this->VertexTriangleOffsets.clear();
+  this->VertexTriangles.clear();
+  this->Points.clear();
+  this->MaximumEdgeLength = 0.0;
+  this->ClearLandmarks();
+  this->CostFunctionType = costFunctionType;
+  this->UseScalarWeights = useScalarWeights;
+  this->Modified();
+
+  if (!mesh || !mesh->GetPolys() || mesh->GetPolys()->GetNumberOfCells() == 0)
+    {
+    return;
+    }
+
+  // Only polygons, triangles, and quads are used, same as in vtkDijkstraGraphGeodesicPath.
+  // Cell links are built in a shallow copy to leave the input unchanged.
+  vtkNew<vtkPolyData> polygonMesh;
+  polygonMesh->SetPoints(mesh->GetPoints());
+  polygonMesh->SetPolys(mesh->GetPolys());
+  polygonMesh->BuildLinks();
+
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localNeighbors;
+  vtkSMPThreadLocalObject<vtkIdList> localCellPointIds;
+
+  // Count the edges of each vertex, storing them shifted by one so that the prefix sum gives the offsets
+  vtkSMPTools::For(0, numberOfVertices, [&](vtkIdType beginVertex, vtkIdType endVertex)
+    {
+    std::vector<vtkIdType>& neighbors = localNeighbors.Local();
+    vtkIdList* cellPointIds = localCellPointIds.Local();
+    for (vtkIdType u = beginVertex; u < endVertex; u++)
+      {
+      GetVertexNeighbors(polygonMesh, u, cellPointIds, neighbors);
+      this->Offsets[u + 1] = static_cast<vtkIdType>(neighbors.size());
+      }
+    });
+  std::partial_sum(this->Offsets.begin(), this->Offsets.end(), this->Offsets.begin());
+
+  vtkIdType numberOfEdges = this->Offsets[numberOfVertices];
+  this->Neighbors.resize(numberOfEdges);
+  this->Costs.resize(numberOfEdges);
+  this->TransposedCosts.resize(numberOfEdges);
+
+  vtkSMPTools::For(0, numberOfVertices, [&](vtkIdType beginVertex, vtkIdType endVertex)
+    {
+    std::vector<vtkIdType>& neighbors = localNeighbors.Local();
+    vtkIdList* cellPointIds = localCellPointIds.Local();
+    for (vtkIdType u = beginVertex; u < endVertex; u++)
+      {
+      GetVertexNeighbors(polygonMesh, u, cellPointIds, neighbors);
+      std::copy(neighbors.begin(), neighbors.end(), this->Neighbors.begin() + this->Offsets[u]);
+      }
+    });
+
+  this->UpdateEdgeCosts(mesh, costFunctionType, useScalarWeights);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::UpdateEdgeCosts(vtkPolyData* mesh, int costFunctionType, bool useScalarWeights)
+{
+  this->ClearLandmarks();
+  this->CostFunctionType = costFunctionType;
+  this->UseScalarWeights = useScalarWeights;
+  this->Modified();
+  if (!mesh || !mesh->GetPoints() || this->Neighbors.empty())
+    {
+    this->Scalars.clear();
+    return;
+    }
+  if (mesh->GetNumberOfPoints() != this->GetNumberOfVertices())
+    {
+    vtkErrorMacro("UpdateEdgeCosts: number of mesh points (" << mesh->GetNumberOfPoints()
+      << ") does not match the number of graph vertices (" << this->GetNumberOfVertices() << ")");
+    this->Scalars.clear();
+    return;
+    }
+  // Scalar values are stored for detecting which vertices are modified
+  if (this->GetScalarWeightsUsed())
+    {
+    this->Scalars.resize(this->GetNumberOfVertices());
+    }
+  else
+    {
+    this->Scalars.clear();
+    }
+  this->ComputeEdgeCosts(mesh, nullptr, 0);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSlicerDijkstraGraph::UpdateModifiedEdgeCosts(vtkPolyData* mesh, vtkIdList* modifiedVertices)
+{
+  if (!mesh || !mesh->GetPoints() || this->Neighbors.empty())
+    {
+    return 0;
+    }
+  vtkIdType numberOfVertices = this->GetNumberOfVertices();
+  if (mesh->GetNumberOfPoints() != numberOfVertices)
+    {
+    vtkErrorMacro("UpdateModifiedEdgeCosts: number of mesh points (" << mesh->GetNumberOfPoints()
+      << ") does not match the number of graph vertices (" << numberOfVertices << ")");
+    return 0;
+    }
+
+  std::vector<vtkIdType> updatedVertices;
+  if (modifiedVertices)
+    {
+    for (vtkIdType i = 0; i < modifiedVertices->GetNumberOfIds(); i++)
+      {
+      vtkIdType v = modifiedVertices->GetId(i);
+      if (v < 0 || v >= numberOfVertices)
+        {
+        vtkErrorMacro("UpdateModifiedEdgeCosts: vertex " << v << " is out of range [0, " << numberOfVertices - 1 << "]");
+        return 0;
+        }
+      updatedVertices.push_back(v);
+      }
+    std::sort(updatedVertices.begin(), updatedVertices.end());
+    updatedVertices.erase(std::unique(updatedVertices.begin(), updatedVertices.end()), updatedVertices.end());
+    }
+  else if (this->GetScalarWeightsUsed())
+    {
+    vtkDataArray* scalarArray = (mesh->GetPointData() ? mesh->GetPointData()->GetScalars() : nullptr);
+    if (scalarArray && scalarArray->GetNumberOfTuples() < numberOfVertices)
+      {
+      vtkErrorMacro("UpdateModifiedEdgeCosts: number of scalars (" << scalarArray->GetNumberOfTuples()
+        << ") is less than the number of graph vertices (" << numberOfVertices << ")");
+      return 0;
+      }
+    if (scalarArray)
+      {
+      FindModifiedScalarsWorker worker;
+      worker.Scalars = this->Scalars.data();
+      worker.NumberOfVertices = numberOfVertices;
+      if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::AllTypes>::Execute(scalarArray, worker))
+        {
+        // fallback to slower, non-typed array access
+        worker(scalarArray);
+        }
+      updatedVertices.swap(worker.ModifiedVertices);
+      }
+    else
+      {
+      // Missing scalars are treated as zero scalar values
+      for (vtkIdType v = 0; v < numberOfVertices; v++)
+        {
+        if (this->Scalars[v] != 0.0)
+          {
+          updatedVertices.push_back(v);
+          }
+        }
+      }
+    }
+
+  if (updatedVertices.empty())
+    {
+    // Edge costs did not change, therefore landmark distances are still valid
+    return 0;
+    }
+  this->Modified();
+
+  // Landmark distances that were computed with lower edge costs are still valid lower bounds
+  // (the bound is not larger than the distance with the old costs, which is not larger than the distance
+  // with the new costs), therefore landmarks are only removed if any edge cost decreases.
+  // All the updated edges start or end at an updated vertex, therefore the costs of these edges are saved.
+  std::vector<float> previousCosts;
+  std::vector<float> previousTransposedCosts;
+  if (!this->Landmarks.empty())
+    {
+    for (vtkIdType v : updatedVertices)
+      {
+      previousCosts.insert(previousCosts.end(), this->Costs.begin() + this->Offsets[v],
+        this->Costs.begin() + this->Offsets[v + 1]);
+      previousTransposedCosts.insert(previousTransposedCosts.end(), this->TransposedCosts.begin() + this->Offsets[v],
+        this->TransposedCosts.begin() + this->Offsets[v + 1]);
+      }
+    }
+  this->ComputeEdgeCosts(mesh, updatedVertices.data(), static_cast<vtkIdType>(updatedVertices.size()));
+  if (!this->Landmarks.empty())
+    {
+    bool costDecreased = false;
+    size_t previousCostIndex = 0;
+    for (vtkIdType v : updatedVertices)
+      {
+      for (vtkIdType edgeIndex = this->Offsets[v]; edgeIndex < this->Offsets[v + 1]; edgeIndex++, previousCostIndex++)
+        {
+        if (this->Costs[edgeIndex] < previousCosts[previousCostIndex]
+          || this->TransposedCosts[edgeIndex] < previousTransposedCosts[previousCostIndex])
+          {
+          costDecreased = true;
+          }
+        }
+      }
+    if (costDecreased)
+      {
+      this->ClearLandmarks();
+      }
+    }
+  if (!this->Points.empty())
+    {
+    // Points of the listed vertices may have been moved
+    for (vtkIdType v : updatedVertices)
+      {
+      mesh->GetPoint(v, this->Points.data() + 3 * v);
+      }
+    for (vtkIdType v : updatedVertices)
+      {
+      for (vtkIdType edgeIndex = this->Offsets[v]; edgeIndex < this->Offsets[v + 1]; edgeIndex++)
+        {
+        const double* p0 = this->Points.data() + 3 * v;
+        const double* p1 = this->Points.data() + 3 * this->Neighbors[edgeIndex];
+        double edgeLength2 = (p1[0] - p0[0]) * (p1[0] - p0[0]) + (p1[1] - p0[1]) * (p1[1] - p0[1]) + (p1[2] - p0[2]) * (p1[2] - p0[2]);
+        this->MaximumEdgeLength = std::max(this->MaximumEdgeLength, sqrt(edgeLength2));
+        }
+      }
+    }
+  return static_cast<vtkIdType>(updatedVertices.size());
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraph::GetScalarWeightsUsed()
+{
+  return this->UseScalarWeights
+    && this->CostFunctionType != vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::ComputeEdgeCosts(vtkPolyData* mesh, const vtkIdType* vertices, vtkIdType numberOfVertices)
+{
+  vtkDataArray* pointArray = mesh->GetPoints()->GetData();
+
+  // Missing scalars are treated as zero scalar values
+  vtkDataArray* scalarArray = nullptr;
+  if (this->GetScalarWeightsUsed())
+    {
+    scalarArray = (mesh->GetPointData() ? mesh->GetPointData()->GetScalars() : nullptr);
+    }
+
+  ComputeEdgeCostsWorker worker;
+  worker.Offsets = this->Offsets.data();
+  worker.Neighbors = this->Neighbors.data();
+  worker.Costs = this->Costs.data();
+  worker.TransposedCosts = this->TransposedCosts.data();
+  worker.Scalars = (this->Scalars.empty() ? nullptr : this->Scalars.data());
+  worker.NumberOfVertices = this->GetNumberOfVertices();
+  worker.CostFunctionType = (this->UseScalarWeights ? this->CostFunctionType
+    : vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE);
+  worker.UpdatedVertices = vertices;
+  worker.NumberOfUpdatedVertices = numberOfVertices;
+  if (scalarArray)
+    {
+    typedef vtkArrayDispatch::Dispatch2ByValueType<vtkArrayDispatch::Reals, vtkArrayDispatch::AllTypes> Dispatcher;
+    if (!Dispatcher::Execute(pointArray, scalarArray, worker))
+      {
+      // fallback to slower, non-typed array access
+      worker(pointArray, scalarArray);
+      }
+    }
+  else
+    {
+    typedef vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals> Dispatcher;
+    if (!Dispatcher::Execute(pointArray, worker))
+      {
+      // fallback to slower, non-typed array access
+      worker(pointArray);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSlicerDijkstraGraph::GetNumberOfTriangles()
+{
+  return static_cast<vtkIdType>(this->Triangles.size() / 3);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::BuildTriangles(vtkPolyData* mesh)
+{
+  this->Triangles.clear();
+  this->VertexTriangleOffsets.clear();
+  this->VertexTriangles.clear();
+  this->Points.clear();
+  this->MaximumEdgeLength = 0.0;
+  this->Modified();
+  const vtkIdType numberOfVertices = this->GetNumberOfVertices();
+  if (!mesh || !mesh->GetPoints() || !mesh->GetPolys() || numberOfVertices == 0)
+    {
+    return;
+    }
+  if (mesh->GetNumberOfPoints() != numberOfVertices)
+    {
+    vtkErrorMacro("BuildTriangles: number of mesh points (" << mesh->GetNumberOfPoints()
+      << ") does not match the number of graph vertices (" << numberOfVertices << ")");
+    return;
+    }
+
+  this->Points.resize(3 * numberOfVertices);
+  vtkSMPTools::For(0, numberOfVertices, [&](vtkIdType beginVertex, vtkIdType endVertex)
+    {
+    for (vtkIdType v = beginVertex; v < endVertex; v++)
+      {
+      mesh->GetPoint(v, this->Points.data() + 3 * v);
+      }
+    });
+
+  vtkCellArray* polys = mesh->GetPolys();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  for (polys->InitTraversal(); polys->GetNextCell(numberOfCellPoints, cellPointIds);)
+    {
+    for (vtkIdType i = 1; i + 1 < numberOfCellPoints; i++)
+      {
+      vtkIdType a = cellPointIds[0];
+      vtkIdType b = cellPointIds[i];
+      vtkIdType c = cellPointIds[i + 1];
+      if (a == b || b == c || c == a)
+        {
+        // degenerate triangle
+        continue;
+        }
+      this->Triangles.push_back(a);
+      this->Triangles.push_back(b);
+      this->Triangles.push_back(c);
+      }
+    }
+
+  // Triangles of each vertex, in compressed sparse row format
+  const vtkIdType numberOfTriangles = this->GetNumberOfTriangles();
+  this->VertexTriangleOffsets.assign(numberOfVertices + 1, 0);
+  for (vtkIdType v : this->Triangles)
+    {
+    this->VertexTriangleOffsets[v + 1]++;
+    }
+  std::partial_sum(this->VertexTriangleOffsets.begin(), this->VertexTriangleOffsets.end(), this->VertexTriangleOffsets.begin());
+  this->VertexTriangles.resize(this->Triangles.size());
+  std::vector<vtkIdType> insertPositions(this->VertexTriangleOffsets.begin(), this->VertexTriangleOffsets.end() - 1);
+  for (vtkIdType triangleIndex = 0; triangleIndex < numberOfTriangles; triangleIndex++)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      vtkIdType v = this->Triangles[3 * triangleIndex + i];
+      this->VertexTriangles[insertPositions[v]++] = triangleIndex;
+      }
+    }
+
+  for (vtkIdType triangleIndex = 0; triangleIndex < numberOfTriangles; triangleIndex++)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      const double* p0 = this->Points.data() + 3 * this->Triangles[3 * triangleIndex + i];
+      const double* p1 = this->Points.data() + 3 * this->Triangles[3 * triangleIndex + (i + 1) % 3];
+      double edgeLength2 = (p1[0] - p0[0]) * (p1[0] - p0[0]) + (p1[1] - p0[1]) * (p1[1] - p0[1]) + (p1[2] - p0[2]) * (p1[2] - p0[2]);
+      this->MaximumEdgeLength = std::max(this->MaximumEdgeLength, sqrt(edgeLength2));
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::ClearLandmarks()
+{
+  this->Landmarks.clear();
+  this->FromLandmarkDistances.clear();
+  this->ToLandmarkDistances.clear();
+  this->RequestedNumberOfLandmarks = 0;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::BuildLandmarks(int numberOfLandmarks)
+{
+  this->ClearLandmarks();
+  this->RequestedNumberOfLandmarks = numberOfLandmarks;
+  this->Modified();
+  const vtkIdType numberOfVertices = this->GetNumberOfVertices();
+  if (numberOfLandmarks <= 0 || numberOfVertices <= 0)
+    {
+    return;
+    }
+
+  // Farthest-point sampling: the first landmark is the vertex farthest from the start vertex, each next landmark
+  // is the vertex that is farthest from all the previous landmarks. The start vertex must have neighbors,
+  // otherwise no other vertex would be reachable from it (e.g., unused point 0 of a mesh).
+  vtkIdType startVertex = 0;
+  while (startVertex < numberOfVertices && this->Offsets[startVertex + 1] == this->Offsets[startVertex])
+    {
+    startVertex++;
+    }
+  if (startVertex >= numberOfVertices)
+    {
+    // there are no edges
+    return;
+    }
+  vtkNew<vtkSlicerDijkstraGraphQuery> query;
+  query->SetGraph(this);
+  query->ComputeDistanceField(startVertex);
+  std::vector<double> distanceFromLandmarks(numberOfVertices);
+  for (vtkIdType v = 0; v < numberOfVertices; v++)
+    {
+    distanceFromLandmarks[v] = query->GetCumulativeWeight(v);
+    }
+  std::vector<std::vector<double>> fromLandmarkDistances;
+  while (static_cast<int>(this->Landmarks.size()) < numberOfLandmarks)
+    {
+    vtkIdType farthestVertex = -1;
+    double farthestDistance = (this->Landmarks.empty() ? -1.0 : 0.0);
+    for (vtkIdType v = 0; v < numberOfVertices; v++)
+      {
+      // unreachable vertices have negative distance, therefore they are never selected
+      if (distanceFromLandmarks[v] > farthestDistance)
+        {
+        farthestDistance = distanceFromLandmarks[v];
+        farthestVertex = v;
+        }
+      }
+    if (farthestVertex < 0)
+      {
+      // all reachable vertices are landmarks already
+      break;
+      }
+    this->Landmarks.push_back(farthestVertex);
+    query->ComputeDistanceField(farthestVertex);
+    fromLandmarkDistances.emplace_back(numberOfVertices);
+    std::vector<double>& distances = fromLandmarkDistances.back();
+    for (vtkIdType v = 0; v < numberOfVertices; v++)
+      {
+      double distance = query->GetCumulativeWeight(v);
+      distances[v] = (distance < 0.0 ? VTK_DOUBLE_MAX : distance);
+      if (this->Landmarks.size() == 1 || distance < distanceFromLandmarks[v])
+        {
+        distanceFromLandmarks[v] = distance;
+        }
+      }
+    }
+
+  // The distances to the landmarks are independent from each other, therefore they are computed in parallel
+  const vtkIdType numberOfSelectedLandmarks = static_cast<vtkIdType>(this->Landmarks.size());
+  this->FromLandmarkDistances.resize(numberOfVertices * numberOfSelectedLandmarks);
+  this->ToLandmarkDistances.resize(numberOfVertices * numberOfSelectedLandmarks);
+  vtkSMPThreadLocalObject<vtkSlicerDijkstraGraphQuery> localQuery;
+  vtkSMPTools::For(0, numberOfSelectedLandmarks, [&](vtkIdType beginLandmark, vtkIdType endLandmark)
+    {
+    vtkSlicerDijkstraGraphQuery* landmarkQuery = localQuery.Local();
+    landmarkQuery->SetGraph(this);
+    for (vtkIdType landmarkIndex = beginLandmark; landmarkIndex < endLandmark; landmarkIndex++)
+      {
+      landmarkQuery->ComputeDistanceField(this->Landmarks[landmarkIndex], true);
+      for (vtkIdType v = 0; v < numberOfVertices; v++)
+        {
+        double distance = landmarkQuery->GetCumulativeWeight(v);
+        this->FromLandmarkDistances[v * numberOfSelectedLandmarks + landmarkIndex] = fromLandmarkDistances[landmarkIndex][v];
+        this->ToLandmarkDistances[v * numberOfSelectedLandmarks + landmarkIndex] = (distance < 0.0 ? VTK_DOUBLE_MAX : distance);
+        }
+      }
+    });
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraph::GetLandmarkVertices(vtkIdList* landmarkVertices)
+{
+  if (!landmarkVertices)
+    {
+    return;
+    }
+  landmarkVertices->SetNumberOfIds(static_cast<vtkIdType>(this->Landmarks.size()));
+  std::copy(this->Landmarks.begin(), this->Landmarks.end(), landmarkVertices->GetPointer(0));
+}
+
+//------------------------------------------------------------------------------
+double vtkSlicerDijkstraGraph::GetLandmarkLowerBound(vtkIdType v, vtkIdType t) const
+{
+  // Triangle inequality with each landmark L: d(v,t) >= d(L,t) - d(L,v) and d(v,t) >= d(v,L) - d(t,L).
+  // Landmarks that cannot reach (or be reached from) both vertices are ignored.
+  const size_t numberOfLandmarks = this->Landmarks.size();
+  if (numberOfLandmarks == 0)
+    {
+    return 0.0;
+    }
+  const double* fromLandmarkToV = this->FromLandmarkDistances.data() + v * numberOfLandmarks;
+  const double* fromLandmarkToT = this->FromLandmarkDistances.data() + t * numberOfLandmarks;
+  const double* toLandmarkFromV = this->ToLandmarkDistances.data() + v * numberOfLandmarks;
+  const double* toLandmarkFromT = this->ToLandmarkDistances.data() + t * numberOfLandmarks;
+  double bound = 0.0;
+  for (size_t i = 0; i < numberOfLandmarks; i++)
+    {
+    if (fromLandmarkToV[i] != VTK_DOUBLE_MAX && fromLandmarkToT[i] != VTK_DOUBLE_MAX)
+      {
+      bound = std::max(bound, fromLandmarkToT[i] - fromLandmarkToV[i]);
+      }
+    if (toLandmarkFromV[i] != VTK_DOUBLE_MAX && toLandmarkFromT[i] != VTK_DOUBLE_MAX)
+      {
+      bound = std::max(bound, toLandmarkFromV[i] - toLandmarkFromT[i]);
+      }
+    }
+  return bound;
+}
@@ -0,0 +1,166 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerDijkstraGraph_h
+#define __vtkSlicerDijkstraGraph_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// export
+#include "vtkAddonExport.h"
+
+// STD includes
+#include <vector>
+
+class vtkIdList;
+class vtkPolyData;
+
+/// Graph of mesh vertices and edges, with edge costs, for shortest path searches.
+///
+/// The polygon edges of the mesh are stored in compressed sparse row format, with the cost of each edge
+/// in both directions (edge costs are not symmetric if scalar weights are used). Optionally, distances from
+/// and to a few landmark vertices are precomputed, which are used for speeding up single-pair searches.
+///
+/// Searches do not modify the graph, their state is stored in vtkSlicerDijkstraGraphQuery objects.
+/// Therefore one graph can be shared by multiple queries that run concurrently (for example, one query per thread),
+/// as long as the graph is not rebuilt while searches are running.
+/// \sa vtkSlicerDijkstraGraphQuery, vtkSlicerDijkstraGraphGeodesicPath
+class VTK_ADDON_EXPORT vtkSlicerDijkstraGraph : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkSlicerDijkstraGraph, vtkObject);
+  static vtkSlicerDijkstraGraph* New();
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Build the graph from the polygons of the mesh and compute the edge costs.
+  /// Edge costs are computed from the point coordinates and the first component of the active point scalars.
+  /// Landmarks are removed.
+  /// \sa vtkSlicerDijkstraGraphGeodesicPath::SetCostFunctionType()
+  void Build(vtkPolyData* mesh, int costFunctionType, bool useScalarWeights);
+
+  /// Recompute the cost of all edges without changing the graph topology.
+  /// The mesh must have the same points and polygons as the mesh that the graph was built from.
+  /// Landmarks are removed, as their distances are no longer valid.
+  void UpdateEdgeCosts(vtkPolyData* mesh, int costFunctionType, bool useScalarWeights);
+
+  /// Recompute the cost of the edges that start or end at modified vertices, with the cost function
+  /// of the last Build or UpdateEdgeCosts call. This is much faster than updating all edge costs
+  /// when scalar weights are changed only in a small region (for example, by painting).
+  /// If modifiedVertices is nullptr then modified vertices are found by comparing the scalars of the mesh
+  /// with the scalar values that the edge costs were computed from.
+  /// If modifiedVertices is specified then point coordinates of those vertices may be changed, too.
+  /// The mesh must have the same number of points and the same polygons as the mesh that the graph was built from.
+  /// Landmarks are removed if any edge cost decreases. If edge costs only increase then landmarks are kept,
+  /// as their distances still give valid (but less tight) lower bounds.
+  /// Returns the number of vertices whose edge costs were updated.
+  vtkIdType UpdateModifiedEdgeCosts(vtkPolyData* mesh, vtkIdList* modifiedVertices = nullptr);
+
+  /// Store the triangles of the mesh and the point coordinates, which are needed for fast marching.
+  /// Polygons that have more than three points are split into triangle fans.
+  /// Triangles are removed when the graph is built again, therefore this has to be called after Build.
+  /// \sa vtkSlicerDijkstraGraphQuery::ComputeFastMarchingDistanceField()
+  void BuildTriangles(vtkPolyData* mesh);
+
+  /// Number of triangles stored by BuildTriangles (0 if triangles are not built).
+  vtkIdType GetNumberOfTriangles();
+
+  /// Cost function type and use of scalar weights that edge costs are computed with.
+  vtkGetMacro(CostFunctionType, int);
+  vtkGetMacro(UseScalarWeights, bool);
+
+  /// Select landmark vertices by farthest-point sampling and compute the distances from and to each landmark.
+  /// Landmark distances are used by vtkSlicerDijkstraGraphQuery for A* search with lower bounds obtained
+  /// by the triangle inequality (ALT). Preprocessing requires two full searches per landmark and stores two
+  /// distance values per vertex per landmark.
+  /// Fewer landmarks are selected if there are not enough vertices reachable from the first vertex
+  /// that has neighbors. No landmarks are selected if the graph has no edges.
+  void BuildLandmarks(int numberOfLandmarks);
+
+  /// Number of landmarks that was requested in the last BuildLandmarks call
+  /// (0 if landmarks were not built or were removed).
+  vtkGetMacro(RequestedNumberOfLandmarks, int);
+
+  /// Get the selected landmark vertices.
+  void GetLandmarkVertices(vtkIdList* landmarkVertices);
+
+  /// Number of landmarks that were selected.
+  int GetNumberOfLandmarks();
+
+  /// Number of vertices in the graph, same as the number of points in the mesh.
+  vtkIdType GetNumberOfVertices();
+
+  /// Number of directed edges. Each polygon edge is counted twice, once in each direction.
+  vtkIdType GetNumberOfEdges();
+
+  /// Cost of an edge that has the specified length and scalar value at its end vertex.
+  /// \sa vtkSlicerDijkstraGraphGeodesicPath::SetCostFunctionType()
+  static double GetWeightedEdgeCost(int costFunctionType, double distance, double scalar);
+
+  /// Lower bound of the cost of the shortest path from vertex v to vertex t, computed from the landmark distances.
+  /// Returns 0 if there are no landmarks.
+  double GetLandmarkLowerBound(vtkIdType v, vtkIdType t) const;
+
+protected:
+  vtkSlicerDijkstraGraph();
+  ~vtkSlicerDijkstraGraph() override;
+  vtkSlicerDijkstraGraph(const vtkSlicerDijkstraGraph&) = delete;
+  void operator=(const vtkSlicerDijkstraGraph&) = delete;
+
+  /// Remove all landmarks and their distances.
+  void ClearLandmarks();
+
+  /// Returns true if scalar values have an effect on the edge costs.
+  bool GetScalarWeightsUsed();
+
+  /// Compute the cost of the edges of the specified vertices (in both directions), or all edges if vertices is nullptr.
+  void ComputeEdgeCosts(vtkPolyData* mesh, const vtkIdType* vertices, vtkIdType numberOfVertices);
+
+  friend class vtkSlicerDijkstraGraphQuery;
+
+  /// Edges starting from vertex u are stored at indices Offsets[u] ... Offsets[u+1]-1 of the edge arrays.
+  std::vector<vtkIdType> Offsets;
+  /// End vertex of each edge.
+  std::vector<vtkIdType> Neighbors;
+  /// Cost of going from u to the neighbor.
+  std::vector<float> Costs;
+  /// Cost of going from the neighbor to u.
+  std::vector<float> TransposedCosts;
+  /// Scalar value of each vertex that edge costs were computed from (empty if scalar weights are not used).
+  std::vector<double> Scalars;
+  int CostFunctionType;
+  bool UseScalarWeights;
+
+  /// Vertex indices of the triangles (three values per triangle).
+  std::vector<vtkIdType> Triangles;
+  /// Triangles that contain vertex v are stored at indices VertexTriangleOffsets[v] ... VertexTriangleOffsets[v+1]-1
+  /// of VertexTriangles.
+  std::vector<vtkIdType> VertexTriangleOffsets;
+  std::vector<vtkIdType> VertexTriangles;
+  /// Point coordinates (three values per vertex).
+  std::vector<double> Points;
+  /// Length of the longest triangle edge.
+  double MaximumEdgeLength;
+
+  /// Landmark vertices and their distance fields, stored interleaved
+  /// (distances of vertex v are at indices v*numberOfLandmarks ... (v+1)*numberOfLandmarks-1).
+  std::vector<vtkIdType> Landmarks;
+  std::vector<double> FromLandmarkDistances;
+  std::vector<double> ToLandmarkDistances;
+  int RequestedNumberOfLandmarks;
+};
+
+#endif
@@ -20,15 +20,25 @@
 
 // Markups MRML includes
 #include "vtkSlicerDijkstraGraphGeodesicPath.h"
+#include "vtkSlicerDijkstraGraph.h"
+#include "vtkSlicerDijkstraGraphQuery.h"
 
 // VTK includes
-#include <vtkFloatArray.h>
-#include <vtkPointData.h>
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerDijkstraGraphGeodesicPath);
+vtkCxxSetObjectMacro(vtkSlicerDijkstraGraphGeodesicPath, TargetVertices, vtkIdList);
+vtkCxxSetObjectMacro(vtkSlicerDijkstraGraphGeodesicPath, ModifiedVertices, vtkIdList);
 
 //------------------------------------------------------------------------------
 vtkSlicerDijkstraGraphGeodesicPath::vtkSlicerDijkstraGraphGeodesicPath()
@@ -37,16 +47,45 @@ vtkSlicerDijkstraGraphGeodesicPath::vtkSlicerDijkstraGraphGeodesicPath()
   this->PreviousUseScalarWeights = this->UseScalarWeights;
   this->CostFunctionType = COST_FUNCTION_TYPE_DISTANCE;
   this->PreviousCostFunctionType = this->CostFunctionType;
+  this->SearchMode = SEARCH_MODE_UNIDIRECTIONAL;
+  this->TargetVertices = nullptr;
+  this->ComputeDistanceField = false;
+  this->ParallelDistanceField = false;
+  this->DistanceField = vtkDoubleArray::New();
+  this->DistanceFieldArrayName = nullptr;
+  this->SetDistanceFieldArrayName("GeodesicDistance");
+  this->NumberOfLandmarks = 0;
+  this->MaximumPathCost = VTK_DOUBLE_MAX;
+  this->ModifiedVertices = nullptr;
+  this->GraphPointsMTime = 0;
+  this->GraphPolysMTime = 0;
+  this->Graph = vtkSmartPointer<vtkSlicerDijkstraGraph>::New();
+  this->Query = vtkSmartPointer<vtkSlicerDijkstraGraphQuery>::New();
+  this->Query->SetGraph(this->Graph);
 }
 
 //------------------------------------------------------------------------------
-vtkSlicerDijkstraGraphGeodesicPath::~vtkSlicerDijkstraGraphGeodesicPath() = default;
+vtkSlicerDijkstraGraphGeodesicPath::~vtkSlicerDijkstraGraphGeodesicPath()
+{
+  this->SetTargetVertices(nullptr);
+  this->SetModifiedVertices(nullptr);
+  this->DistanceField->Delete();
+  this->SetDistanceFieldArrayName(nullptr);
+}
 
 //------------------------------------------------------------------------------
 void vtkSlicerDijkstraGraphGeodesicPath::PrintSelf(std::ostream &os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "CostFunction: " << this->GetCostFunctionTypeAsString(this->CostFunctionType) << std::endl;
+  os << indent << "SearchMode: " << this->GetSearchModeAsString(this->SearchMode) << std::endl;
+  os << indent << "TargetVertices: " << (this->TargetVertices ? this->TargetVertices->GetNumberOfIds() : 0) << std::endl;
+  os << indent << "ComputeDistanceField: " << (this->ComputeDistanceField ? "true" : "false") << std::endl;
+  os << indent << "ParallelDistanceField: " << (this->ParallelDistanceField ? "true" : "false") << std::endl;
+  os << indent << "DistanceFieldArrayName: " << (this->DistanceFieldArrayName ? this->DistanceFieldArrayName : "(none)") << std::endl;
+  os << indent << "NumberOfLandmarks: " << this->NumberOfLandmarks << std::endl;
+  os << indent << "MaximumPathCost: " << this->MaximumPathCost << std::endl;
+  os << indent << "ModifiedVertices: " << (this->ModifiedVertices ? this->ModifiedVertices->GetNumberOfIds() : 0) << std::endl;
 }
 
 //------------------------------------------------------------------------------
@@ -99,6 +138,52 @@ int vtkSlicerDijkstraGraphGeodesicPath::GetCostFunctionTypeFromString(const char
   return -1;
 }
 
+//------------------------------------------------------------------------------
+const char* vtkSlicerDijkstraGraphGeodesicPath::GetSearchModeAsString(int searchMode)
+{
+  switch (searchMode)
+    {
+    case SEARCH_MODE_UNIDIRECTIONAL:
+      {
+      return "unidirectional";
+      }
+    case SEARCH_MODE_BIDIRECTIONAL:
+      {
+      return "bidirectional";
+      }
+    case SEARCH_MODE_FAST_MARCHING:
+      {
+      return "fastMarching";
+      }
+    default:
+      {
+      return "";
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerDijkstraGraphGeodesicPath::GetSearchModeFromString(const char* searchMode)
+{
+  if (searchMode == nullptr)
+    {
+    // invalid name
+    vtkGenericWarningMacro("Invalid search mode name");
+    return -1;
+    }
+  for (int i = 0; i < vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_LAST; i++)
+    {
+    if (strcmp(searchMode, vtkSlicerDijkstraGraphGeodesicPath::GetSearchModeAsString(i)) == 0)
+      {
+      // found a matching name
+      return i;
+      }
+    }
+  // name not found
+  vtkGenericWarningMacro("Unknown search mode: " << searchMode);
+  return -1;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerDijkstraGraphGeodesicPath::RequestData(
   vtkInformation* vtkNotUsed(request),
@@ -124,68 +209,249 @@ int vtkSlicerDijkstraGraphGeodesicPath::RequestData(
     return 0;
     }
 
-  if (this->AdjacencyBuildTime.GetMTime() < input->GetMTime() ||
-      this->CostFunctionType != this->PreviousCostFunctionType ||
-      static_cast<bool>(this->UseScalarWeights) != this->PreviousUseScalarWeights)
+  bool costFunctionChanged = (this->CostFunctionType != this->PreviousCostFunctionType ||
+    static_cast<bool>(this->UseScalarWeights) != this->PreviousUseScalarWeights);
+  if (this->AdjacencyBuildTime.GetMTime() < input->GetMTime() && this->GetGraphGeometryModified(input))
     {
-    this->Initialize(input);
+    // The superclass adjacency and search state are not used, therefore only our own adjacency is built.
+    this->NumberOfVertices = input->GetNumberOfPoints();
+    this->BuildAdjacency(input);
     }
-  else
+  else if (costFunctionChanged)
     {
-    this->Reset();
+    // The mesh is not changed, only the edge costs need to be updated
+    this->Graph->UpdateEdgeCosts(input, this->CostFunctionType, this->UseScalarWeights);
+    this->AdjacencyBuildTime.Modified();
+    }
+  else if (this->AdjacencyBuildTime.GetMTime() < input->GetMTime())
+    {
+    // Only the point data is modified (for example, scalar weights are painted in a small region),
+    // therefore only the costs of edges of the modified vertices are updated.
+    this->Graph->UpdateModifiedEdgeCosts(input, this->ModifiedVertices);
+    this->AdjacencyBuildTime.Modified();
     }
   this->PreviousUseScalarWeights = this->UseScalarWeights;
   this->PreviousCostFunctionType= this->CostFunctionType;
 
+  // Triangles are removed from the graph when it is rebuilt
+  if (this->SearchMode == SEARCH_MODE_FAST_MARCHING && this->Graph->GetNumberOfTriangles() == 0)
+    {
+    this->Graph->BuildTriangles(input);
+    }
+
   if (this->NumberOfVertices == 0)
     {
     return 0;
     }
 
-  this->ShortestPath(input, this->StartVertex, this->EndVertex);
-  this->TraceShortestPath(input, output, this->StartVertex, this->EndVertex);
+  vtkNew<vtkIdList> endVertices;
+  if (this->TargetVertices && this->TargetVertices->GetNumberOfIds() > 0)
+    {
+    endVertices->DeepCopy(this->TargetVertices);
+    }
+  else
+    {
+    endVertices->InsertNextId(this->EndVertex);
+    }
+
+  if (this->StartVertex < 0 || this->StartVertex >= this->NumberOfVertices)
+    {
+    vtkErrorMacro("RequestData: start vertex " << this->StartVertex
+      << " is out of range [0, " << this->NumberOfVertices - 1 << "]");
+    return 0;
+    }
+  for (vtkIdType endVertexIndex = 0; endVertexIndex < endVertices->GetNumberOfIds(); endVertexIndex++)
+    {
+    vtkIdType endVertex = endVertices->GetId(endVertexIndex);
+    if (endVertex < 0 || endVertex >= this->NumberOfVertices)
+      {
+      vtkErrorMacro("RequestData: end vertex " << endVertex
+        << " is out of range [0, " << this->NumberOfVertices - 1 << "]");
+      return 0;
+      }
+    }
+
+  // Landmarks are removed from the graph when edge costs decrease, therefore they are rebuilt automatically.
+  // Building them requires two full searches per landmark, therefore it is postponed until a search uses them.
+  bool landmarksUsed = (this->SearchMode == SEARCH_MODE_UNIDIRECTIONAL && this->StopWhenEndReached
+    && !this->ComputeDistanceField && endVertices->GetNumberOfIds() == 1);
+  if (this->NumberOfLandmarks != this->Graph->GetRequestedNumberOfLandmarks()
+    && (landmarksUsed || this->NumberOfLandmarks == 0))
+    {
+    this->Graph->BuildLandmarks(this->NumberOfLandmarks);
+    }
+
+  this->ComputeShortestPaths(input, this->StartVertex, endVertices);
+  this->TracePaths(input, output, endVertices);
+
+  if (this->ComputeDistanceField)
+    {
+    this->GetCumulativeWeights(this->DistanceField);
+    this->DistanceField->SetName(this->DistanceFieldArrayName);
+    }
+  else
+    {
+    this->DistanceField->Initialize();
+    }
   return 1;
 }
 
 //------------------------------------------------------------------------------
-double vtkSlicerDijkstraGraphGeodesicPath::CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v)
+void vtkSlicerDijkstraGraphGeodesicPath::BuildAdjacency(vtkDataSet* inData)
 {
-  // Parent implementation is inverse squared
-  if (this->CostFunctionType == COST_FUNCTION_TYPE_INVERSE_SQUARED)
+  vtkPolyData* mesh = vtkPolyData::SafeDownCast(inData);
+  this->Graph->Build(mesh, this->CostFunctionType, this->UseScalarWeights);
+  this->GraphPointsMTime = (mesh && mesh->GetPoints() ? mesh->GetPoints()->GetMTime() : 0);
+  this->GraphPolysMTime = (mesh && mesh->GetPolys() ? mesh->GetPolys()->GetMTime() : 0);
+  this->AdjacencyBuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraphGeodesicPath::GetGraphGeometryModified(vtkPolyData* input)
+{
+  // Modification times are unique, therefore replacing the points or polygons by other objects is detected, too.
+  // Modification time of the points includes the modification time of their data array.
+  vtkMTimeType pointsMTime = (input->GetPoints() ? input->GetPoints()->GetMTime() : 0);
+  vtkMTimeType polysMTime = (input->GetPolys() ? input->GetPolys()->GetMTime() : 0);
+  // If only the mesh is marked as modified (for example, point coordinates are edited in place and then
+  // Modified() is called on the mesh) then it is not known what has changed, therefore the graph is rebuilt.
+  // The own modification time of the mesh does not include the time of its points, cells, and point data.
+  vtkMTimeType meshMTime = input->vtkObject::GetMTime();
+  return this->Graph->GetNumberOfVertices() != input->GetNumberOfPoints()
+    || this->NumberOfVertices != input->GetNumberOfPoints()
+    || pointsMTime != this->GraphPointsMTime
+    || polysMTime != this->GraphPolysMTime
+    || meshMTime > this->AdjacencyBuildTime.GetMTime();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::GetLandmarkVertices(vtkIdList* landmarkVertices)
+{
+  this->Graph->GetLandmarkVertices(landmarkVertices);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::GetSettledVertices(vtkIdList* settledVertices)
+{
+  this->Query->GetSettledVertices(settledVertices);
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerDijkstraGraph* vtkSlicerDijkstraGraphGeodesicPath::GetGraph()
+{
+  return this->Graph;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::ComputeShortestPaths(vtkDataSet* inData, vtkIdType startv,
+  vtkIdList* endVertices)
+{
+  if (this->RepelPathFromVertices)
+    {
+    this->Query->SetDynamicEdgeCostFunction([this, inData](vtkIdType u, vtkIdType v)
+      {
+      return this->CalculateDynamicEdgeCost(inData, u, v);
+      });
+    }
+  else
     {
-    return Superclass::CalculateStaticEdgeCost(inData, u, v);
+    this->Query->SetDynamicEdgeCostFunction(nullptr);
     }
+  this->Query->SetMaximumPathCost(this->MaximumPathCost);
 
-  double p1[3];
-  inData->GetPoint(u,p1);
-  double p2[3];
-  inData->GetPoint(v,p2);
+  // If the search does not have to stop at the end vertices then cumulative weights of all vertices are computed
+  bool stopAtEndVertices = this->StopWhenEndReached && !this->ComputeDistanceField;
+  if (this->SearchMode == SEARCH_MODE_BIDIRECTIONAL && (!stopAtEndVertices || endVertices->GetNumberOfIds() != 1))
+    {
+    vtkWarningMacro("ComputeShortestPaths: bidirectional search requires StopWhenEndReached enabled,"
+      << " ComputeDistanceField disabled, and a single end vertex. Unidirectional search is used instead.");
+    }
+  if (this->SearchMode == SEARCH_MODE_FAST_MARCHING)
+    {
+    this->Query->ComputeFastMarchingDistanceField(startv, stopAtEndVertices ? endVertices : nullptr);
+    }
+  else if (this->ComputeDistanceField && this->ParallelDistanceField && !this->RepelPathFromVertices)
+    {
+    this->Query->ComputeDistanceFieldParallel(startv);
+    }
+  else if (stopAtEndVertices && endVertices->GetNumberOfIds() == 1)
+    {
+    this->Query->FindShortestPath(startv, endVertices->GetId(0), this->SearchMode);
+    }
+  else
+    {
+    this->Query->FindShortestPaths(startv, endVertices, stopAtEndVertices);
+    }
+}
 
-  double distance = sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
-  double cost = distance;
-  if (this->UseScalarWeights && this->CostFunctionType != COST_FUNCTION_TYPE_DISTANCE)
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::TracePaths(vtkDataSet* inData, vtkPolyData* outPoly, vtkIdList* endVertices)
+{
+  this->IdList->Reset();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType endVertexIndex = 0; endVertexIndex < endVertices->GetNumberOfIds(); endVertexIndex++)
     {
-    double scalarV = 0.0;
-    // Note this edge cost is not symmetric!
-    if (inData->GetPointData())
+    if (this->SearchMode == SEARCH_MODE_FAST_MARCHING)
       {
-      vtkFloatArray* scalars = vtkFloatArray::SafeDownCast(inData->GetPointData()->GetScalars());
-      if (scalars)
+      vtkIdType firstPointIndex = points->GetNumberOfPoints();
+      this->Query->GetFastMarchingPath(endVertices->GetId(endVertexIndex), points);
+      lines->InsertNextCell(points->GetNumberOfPoints() - firstPointIndex);
+      for (vtkIdType pointIndex = firstPointIndex; pointIndex < points->GetNumberOfPoints(); pointIndex++)
         {
-        scalarV = static_cast<double>(scalars->GetValue(v));
+        lines->InsertCellPoint(pointIndex);
         }
+      continue;
       }
+    vtkIdType firstPathPointIndex = this->IdList->GetNumberOfIds();
+    this->Query->GetPath(endVertices->GetId(endVertexIndex), this->IdList);
 
-    switch (this->CostFunctionType)
+    // Add a cell even if the path is empty, to keep cell index the same as the end vertex index
+    vtkIdType numberOfPathPoints = this->IdList->GetNumberOfIds() - firstPathPointIndex;
+    lines->InsertNextCell(numberOfPathPoints);
+    for (vtkIdType i = firstPathPointIndex; i < firstPathPointIndex + numberOfPathPoints; i++)
       {
-      case COST_FUNCTION_TYPE_ADDITIVE:
-        cost += scalarV;
-        break;
-      case COST_FUNCTION_TYPE_MULTIPLICATIVE:
-        cost *= scalarV;
-      default:
-        break;
+      inData->GetPoint(this->IdList->GetId(i), point);
+      lines->InsertCellPoint(points->InsertNextPoint(point));
       }
     }
-  return cost;
+
+  if (endVertices->GetNumberOfIds() == 1 && points->GetNumberOfPoints() == 0)
+    {
+    // Keep the single path output empty if there is no path
+    lines->Initialize();
+    }
+  outPoly->SetPoints(points);
+  outPoly->SetLines(lines);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::GetCumulativeWeights(vtkDoubleArray* weights)
+{
+  this->Query->GetCumulativeWeights(weights);
+}
+
+//------------------------------------------------------------------------------
+double vtkSlicerDijkstraGraphGeodesicPath::CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v)
+{
+  double p1[3];
+  inData->GetPoint(u,p1);
+  double p2[3];
+  inData->GetPoint(v,p2);
+
+  double distance = sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  if (!this->UseScalarWeights)
+    {
+    return distance;
+    }
+
+  // Note this edge cost is not symmetric!
+  double scalarV = 0.0;
+  vtkDataArray* scalars = (inData->GetPointData() ? inData->GetPointData()->GetScalars() : nullptr);
+  if (scalars)
+    {
+    scalarV = scalars->GetComponent(v, 0);
+    }
+  return vtkSlicerDijkstraGraph::GetWeightedEdgeCost(this->CostFunctionType, distance, scalarV);
 }
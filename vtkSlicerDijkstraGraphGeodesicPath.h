@@ -23,10 +23,16 @@
 
 // VTK includes
 #include <vtkDijkstraGraphGeodesicPath.h>
+#include <vtkSmartPointer.h>
 
 // export
 #include "vtkAddonExport.h"
 
+class vtkDoubleArray;
+class vtkIdList;
+class vtkSlicerDijkstraGraph;
+class vtkSlicerDijkstraGraphQuery;
+
 /// Filter that generates curves between points of an input polydata
 class VTK_ADDON_EXPORT vtkSlicerDijkstraGraphGeodesicPath : public vtkDijkstraGraphGeodesicPath
 {
@@ -54,20 +60,163 @@ public:
   vtkSetMacro(CostFunctionType, int);
   vtkGetMacro(CostFunctionType, int);
 
+  /// Search mode is the method that is used to find the shortest path between StartVertex and EndVertex.
+  /// Ex.
+  ///     SEARCH_MODE_UNIDIRECTIONAL = Dijkstra search from the start vertex until the end vertex is reached
+  ///     SEARCH_MODE_BIDIRECTIONAL  = simultaneous Dijkstra searches from the start vertex and (using the transposed
+  ///                                  edge costs) from the end vertex, until the two search fronts meet.
+  ///     SEARCH_MODE_FAST_MARCHING  = fast marching method on the triangles of the mesh, which computes the geodesic
+  ///                                  distance along straight lines across the triangles instead of along the edges.
+  /// Bidirectional search settles about half as many vertices for long paths and finds a path with the same cost.
+  /// It is only used if StopWhenEndReached is enabled, ComputeDistanceField is disabled, and there is a single end
+  /// vertex, because otherwise cumulative weights are needed for more vertices. In other cases a warning is logged
+  /// and unidirectional search is used.
+  /// Dijkstra search overestimates the geodesic distance and its paths zig-zag along the mesh edges. Fast marching
+  /// gives accurate distances and smooth paths (traced along the gradient of the distance field) on the original
+  /// mesh resolution. It uses the geometric distance only: CostFunctionType, scalar weights, RepelPathFromVertices,
+  /// and ParallelDistanceField are ignored. Output path points are generally not mesh vertices, therefore IdList is empty.
+  enum
+    {
+    SEARCH_MODE_UNIDIRECTIONAL,
+    SEARCH_MODE_BIDIRECTIONAL,
+    SEARCH_MODE_FAST_MARCHING,
+    SEARCH_MODE_LAST,
+    };
+  static const char* GetSearchModeAsString(int searchMode);
+  static int GetSearchModeFromString(const char* searchMode);
+  vtkSetMacro(SearchMode, int);
+  vtkGetMacro(SearchMode, int);
+
+  /// Target vertices for computing paths from StartVertex to multiple vertices with a single search.
+  /// If the list is not empty then EndVertex is ignored and the output contains one line cell for each target
+  /// (in the same order as the targets), traced from the target back to StartVertex. The cell is empty if the
+  /// target cannot be reached. IdList contains the vertex ids of all the output points.
+  /// If StopWhenEndReached is enabled then the search stops when all targets are reached.
+  /// By default the list is not set.
+  virtual void SetTargetVertices(vtkIdList* targetVertices);
+  vtkGetObjectMacro(TargetVertices, vtkIdList);
+
+  /// Continue the search until all reachable vertices are visited (even if StopWhenEndReached is enabled)
+  /// and store the cumulative weight of each input point in DistanceField.
+  /// Disabled by default.
+  vtkSetMacro(ComputeDistanceField, bool);
+  vtkGetMacro(ComputeDistanceField, bool);
+  vtkBooleanMacro(ComputeDistanceField, bool);
+
+  /// Compute the distance field using multiple threads (delta-stepping algorithm), which is faster for meshes
+  /// with millions of vertices. Distances are the same as with the serial algorithm within floating-point tolerance,
+  /// but if multiple paths have the same cost then a different path may be chosen.
+  /// It is not used if RepelPathFromVertices is enabled.
+  /// Disabled by default.
+  /// \sa vtkSlicerDijkstraGraphQuery::ComputeDistanceFieldParallel()
+  vtkSetMacro(ParallelDistanceField, bool);
+  vtkGetMacro(ParallelDistanceField, bool);
+  vtkBooleanMacro(ParallelDistanceField, bool);
+
+  /// Distance from StartVertex to each input point, computed if ComputeDistanceField is enabled.
+  /// It can be added to the point data of the input mesh, for example for distance-based coloring.
+  /// Points that cannot be reached have a value of -1.
+  vtkGetObjectMacro(DistanceField, vtkDoubleArray);
+
+  /// Name of the DistanceField array. Default value is "GeodesicDistance".
+  vtkSetStringMacro(DistanceFieldArrayName);
+  vtkGetStringMacro(DistanceFieldArrayName);
+
+  /// Number of landmark vertices used for speeding up repeated single-pair path queries on the same mesh.
+  /// If larger than zero then landmarks are selected by farthest-point sampling and the distances from and to
+  /// each landmark are precomputed. Unidirectional searches for a single end vertex then use A* search with
+  /// lower bounds obtained from these distances by the triangle inequality (ALT), which visits much fewer vertices.
+  /// The precomputed distances are updated automatically when the input mesh or the edge cost function changes.
+  /// Preprocessing requires two full searches per landmark and stores two distance values per vertex per landmark.
+  /// It is performed at the first update that runs such a search after the change. If only scalar weights of some
+  /// vertices are modified (see ModifiedVertices) then the landmarks are kept as long as no edge cost decreases,
+  /// because distances computed with lower costs still give valid lower bounds. Decreasing edge costs frequently
+  /// (for example, painting lower weights) therefore triggers the full preprocessing after each edit: in this case
+  /// it is better not to use landmarks.
+  /// Default value is 0 (landmarks are not used).
+  vtkSetClampMacro(NumberOfLandmarks, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfLandmarks, int);
+
+  /// Get the landmark vertices that are selected in the last preprocessing step.
+  /// Fewer vertices than NumberOfLandmarks are selected if the mesh does not have enough vertices.
+  void GetLandmarkVertices(vtkIdList* landmarkVertices);
+
+  /// Maximum cost of the paths, for example for finding all vertices within a given geodesic distance from StartVertex.
+  /// The search stops when all vertices within this cost are settled, therefore local queries on large meshes
+  /// only visit the neighborhood of StartVertex. Vertices that are farther are considered unreachable: their
+  /// DistanceField value is -1 and the output path to them is empty.
+  /// Default value is VTK_DOUBLE_MAX (no limit).
+  vtkSetMacro(MaximumPathCost, double);
+  vtkGetMacro(MaximumPathCost, double);
+
+  /// Vertices whose scalar values were modified since the last update.
+  /// If only the point data of the input mesh is modified (the points and polygons are unchanged) then the graph is
+  /// not rebuilt, but only the costs of the edges of the modified vertices are recomputed. If Modified() is called
+  /// on the mesh itself then it is not known what has changed and the graph is rebuilt. If this list is not set
+  /// then modified vertices are found by comparing the scalars with the values that the edge costs were computed from.
+  /// Setting the list avoids this comparison, but then it must be updated before each update of the filter.
+  /// By default the list is not set.
+  /// \sa vtkSlicerDijkstraGraph::UpdateModifiedEdgeCosts()
+  virtual void SetModifiedVertices(vtkIdList* modifiedVertices);
+  vtkGetObjectMacro(ModifiedVertices, vtkIdList);
+
+  /// Get the vertices whose distance from StartVertex was determined by the last search, in the order they were
+  /// settled. With ComputeDistanceField enabled, these are all the vertices within MaximumPathCost.
+  void GetSettledVertices(vtkIdList* settledVertices);
+
+  /// Graph of the input mesh that is used for the searches.
+  /// It is built when the filter is updated. The graph can be shared with vtkSlicerDijkstraGraphQuery objects
+  /// to run additional searches concurrently (for example, from multiple threads) without duplicating the graph.
+  vtkSlicerDijkstraGraph* GetGraph();
+
+  /// Fill the array with the cumulative weights of the last search.
+  /// Vertices that were not reached by the search have a weight of -1.
+  /// Reimplemented because the search state is stored in a vtkSlicerDijkstraGraphQuery.
+  void GetCumulativeWeights(vtkDoubleArray* weights) override;
+
 protected:
   /// Reimplemented to rebuild the adjacency info if either CostFunctionType or UseScalarWeights are changed.
   int RequestData(vtkInformation*, vtkInformationVector**,
     vtkInformationVector*) override;
 
-  /// The fixed cost going from vertex u to v.
-  /// Reimplemented to provide additional cost function types.
-  /// \sa SetCostFunctionType()
-  double CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v) override;
+  /// The fixed cost going from vertex u to v, computed the same way as the edge costs in the graph.
+  /// Edge costs are computed by vtkSlicerDijkstraGraph (see vtkSlicerDijkstraGraph::GetWeightedEdgeCost),
+  /// therefore the filter does not call this method. It is final, so that subclasses cannot override it
+  /// expecting to change the edge costs. Use CostFunctionType and scalar weights instead.
+  double CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v) final;
+
+  /// Build the graph of the input mesh and compute the edge costs.
+  /// Reimplemented to store the edges in a vtkSlicerDijkstraGraph instead of the superclass.
+  void BuildAdjacency(vtkDataSet* inData) override;
+
+  /// Returns true if the points or polygons of the input mesh are different from the mesh that the graph was built from.
+  bool GetGraphGeometryModified(vtkPolyData* input);
+
+  /// Find the shortest paths from startv to all the end vertices using the current SearchMode.
+  void ComputeShortestPaths(vtkDataSet* inData, vtkIdType startv, vtkIdList* endVertices);
+
+  /// Generate one output polyline for each end vertex and fill IdList by following
+  /// the predecessors from the end vertices back to the start vertex.
+  void TracePaths(vtkDataSet* inData, vtkPolyData* outPoly, vtkIdList* endVertices);
 
   int CostFunctionType;
+  int SearchMode;
+  vtkIdList* TargetVertices;
+  bool ComputeDistanceField;
+  bool ParallelDistanceField;
+  vtkDoubleArray* DistanceField;
+  char* DistanceFieldArrayName;
+  int NumberOfLandmarks;
+  double MaximumPathCost;
+  vtkIdList* ModifiedVertices;
+  vtkMTimeType GraphPointsMTime;
+  vtkMTimeType GraphPolysMTime;
   int PreviousCostFunctionType;
   bool PreviousUseScalarWeights;
 
+  vtkSmartPointer<vtkSlicerDijkstraGraph> Graph;
+  vtkSmartPointer<vtkSlicerDijkstraGraphQuery> Query;
+
 protected:
   vtkSlicerDijkstraGraphGeodesicPath();
   ~vtkSlicerDijkstraGraphGeodesicPath() override;
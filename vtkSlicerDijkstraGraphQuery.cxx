@@ -0,0 +1,1055 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkSlicerDijkstraGraphQuery.h"
+#include "vtkSlicerDijkstraGraph.h"
+#include "vtkSlicerDijkstraGraphGeodesicPath.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+/// Compute the arrival time at vertex c of a planar wavefront that reached a at time ta and b at time tb,
+/// by unfolding the triangle into the plane and finding the virtual point source of the front.
+/// Returns VTK_DOUBLE_MAX if the front does not reach c through the edge ab (then the update must use the edges).
+double ComputeTriangleArrivalTime(const double* a, const double* b, const double* c, double ta, double tb)
+{
+  double ab2 = vtkMath::Distance2BetweenPoints(a, b);
+  double ac2 = vtkMath::Distance2BetweenPoints(a, c);
+  double bc2 = vtkMath::Distance2BetweenPoints(b, c);
+  double ab = sqrt(ab2);
+  if (ab <= 0.0)
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  // a is at the origin, b is on the positive x axis, c is above the x axis
+  double cx = (ac2 - bc2 + ab2) / (2.0 * ab);
+  double cy2 = ac2 - cx * cx;
+  if (cy2 <= 0.0)
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  double cy = sqrt(cy2);
+  // virtual source is below the x axis, at distance ta from a and tb from b
+  double sx = (ta * ta - tb * tb + ab2) / (2.0 * ab);
+  double sy2 = ta * ta - sx * sx;
+  if (sy2 < 0.0)
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  double sy = -sqrt(sy2);
+  // the ray from the source to c must cross the edge ab
+  double crossingX = sx + (cx - sx) * (-sy) / (cy - sy);
+  if (crossingX < 0.0 || crossingX > ab)
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  return sqrt((cx - sx) * (cx - sx) + (cy - sy) * (cy - sy));
+}
+
+} // end anonymous namespace
+
+//------------------------------------------------------------------------------
+class vtkSlicerDijkstraGraphQuery::vtkInternal
+{
+public:
+  /// State of one Dijkstra search front.
+  /// The heap may contain multiple items for the same vertex, items of already settled vertices are skipped.
+  /// Only the vertices that were reached by the previous search are reset, therefore the cost of a search that
+  /// is limited to a small neighborhood (by a maximum path cost or by reaching the end vertices) does not depend
+  /// on the size of the graph.
+  class SearchFront
+  {
+  public:
+    typedef std::pair<double, vtkIdType> HeapItem;
+
+    void Reset(vtkIdType numberOfVertices)
+    {
+      if (static_cast<vtkIdType>(this->Weights.size()) != numberOfVertices)
+        {
+        this->Weights.assign(numberOfVertices, VTK_DOUBLE_MAX);
+        this->Predecessors.assign(numberOfVertices, -1);
+        this->Settled.assign(numberOfVertices, 0);
+        }
+      else
+        {
+        for (vtkIdType v : this->ReachedVertices)
+          {
+          this->Weights[v] = VTK_DOUBLE_MAX;
+          this->Predecessors[v] = -1;
+          this->Settled[v] = 0;
+          }
+        }
+      this->ReachedVertices.clear();
+      this->SettledVertices.clear();
+      this->Heap.clear();
+    }
+
+    /// Set the weight and predecessor of a vertex and remember that it has to be reset before the next search.
+    void SetWeight(vtkIdType v, double weight, vtkIdType predecessor)
+    {
+      if (this->Weights[v] == VTK_DOUBLE_MAX)
+        {
+        this->ReachedVertices.push_back(v);
+        }
+      this->Weights[v] = weight;
+      this->Predecessors[v] = predecessor;
+    }
+
+    /// Add a vertex to the heap. The key is the weight of the vertex plus its potential (estimated remaining cost).
+    void Push(vtkIdType v, double key)
+    {
+      this->Heap.emplace_back(key, v);
+      std::push_heap(this->Heap.begin(), this->Heap.end(), std::greater<HeapItem>());
+    }
+
+    /// Update the weight of v if it can be reached with a lower cost through u.
+    /// Vertices that are farther than maximumWeight are not added to the front.
+    void Relax(vtkIdType u, vtkIdType v, double cost, double maximumWeight, double potential = 0.0)
+    {
+      double weight = this->Weights[u] + cost;
+      if (weight < this->Weights[v] && weight <= maximumWeight)
+        {
+        this->SetWeight(v, weight, u);
+        this->Push(v, weight + potential);
+        }
+    }
+
+    /// Heap key of the next vertex that would be settled (VTK_DOUBLE_MAX if the front is empty).
+    double GetMinimumKey()
+    {
+      while (!this->Heap.empty() && this->Settled[this->Heap.front().second])
+        {
+        std::pop_heap(this->Heap.begin(), this->Heap.end(), std::greater<HeapItem>());
+        this->Heap.pop_back();
+        }
+      return this->Heap.empty() ? VTK_DOUBLE_MAX : this->Heap.front().first;
+    }
+
+    /// Remove the vertex with the lowest weight from the front and mark it as settled.
+    /// Returns -1 if the front is empty.
+    vtkIdType SettleMinimum()
+    {
+      if (this->GetMinimumKey() == VTK_DOUBLE_MAX)
+        {
+        return -1;
+        }
+      vtkIdType u = this->Heap.front().second;
+      std::pop_heap(this->Heap.begin(), this->Heap.end(), std::greater<HeapItem>());
+      this->Heap.pop_back();
+      this->Settled[u] = 1;
+      this->SettledVertices.push_back(u);
+      return u;
+    }
+
+    std::vector<double> Weights;
+    std::vector<vtkIdType> Predecessors;
+    std::vector<char> Settled;
+    std::vector<HeapItem> Heap;
+    /// Vertices that have a weight, in the order they were first reached.
+    std::vector<vtkIdType> ReachedVertices;
+    /// Vertices in the order they were settled (in increasing order of their heap key).
+    std::vector<vtkIdType> SettledVertices;
+  };
+
+  /// Mark or unmark the vertices as targets of the search.
+  /// Returns the number of distinct vertices that changed.
+  vtkIdType SetTargets(const vtkIdType* vertices, vtkIdType numberOfVertices, char value)
+  {
+    vtkIdType numberOfChangedVertices = 0;
+    for (vtkIdType i = 0; i < numberOfVertices; i++)
+      {
+      if (this->IsTarget[vertices[i]] != value)
+        {
+        this->IsTarget[vertices[i]] = value;
+        numberOfChangedVertices++;
+        }
+      }
+    return numberOfChangedVertices;
+  }
+
+  /// Non-zero for vertices that the unidirectional search has to reach before it can stop.
+  std::vector<char> IsTarget;
+
+  /// Search from the start vertex.
+  /// Its weights and predecessors describe the result of every search mode.
+  SearchFront Forward;
+  /// Search from the end vertex, using transposed edge costs.
+  SearchFront Backward;
+
+  DynamicEdgeCostFunctionType DynamicEdgeCostFunction;
+
+  /// Source vertex of the last fast marching search (-1 if the last search was not fast marching).
+  vtkIdType FastMarchingSourceVertex = -1;
+};
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerDijkstraGraphQuery);
+vtkCxxSetObjectMacro(vtkSlicerDijkstraGraphQuery, Graph, vtkSlicerDijkstraGraph);
+
+//------------------------------------------------------------------------------
+vtkSlicerDijkstraGraphQuery::vtkSlicerDijkstraGraphQuery()
+{
+  this->Graph = nullptr;
+  this->MaximumPathCost = VTK_DOUBLE_MAX;
+  this->Internal = new vtkInternal;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerDijkstraGraphQuery::~vtkSlicerDijkstraGraphQuery()
+{
+  this->SetGraph(nullptr);
+  delete this->Internal;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::PrintSelf(std::ostream &os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Graph: " << this->Graph << std::endl;
+  os << indent << "MaximumPathCost: " << this->MaximumPathCost << std::endl;
+  os << indent << "DynamicEdgeCostFunction: " << (this->Internal->DynamicEdgeCostFunction ? "set" : "(none)") << std::endl;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::SetDynamicEdgeCostFunction(const DynamicEdgeCostFunctionType& costFunction)
+{
+  this->Internal->DynamicEdgeCostFunction = costFunction;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraphQuery::FindShortestPath(vtkIdType startVertex, vtkIdType endVertex, int searchMode)
+{
+  if (!this->Graph)
+    {
+    vtkErrorMacro("FindShortestPath: graph is not set");
+    return false;
+    }
+  vtkIdType numberOfVertices = this->Graph->GetNumberOfVertices();
+  if (startVertex < 0 || startVertex >= numberOfVertices || endVertex < 0 || endVertex >= numberOfVertices)
+    {
+    vtkErrorMacro("FindShortestPath: start vertex " << startVertex << " or end vertex " << endVertex
+      << " is out of range [0, " << numberOfVertices - 1 << "]");
+    return false;
+    }
+  if (searchMode == vtkSlicerDijkstraGraphGeodesicPath::SEARCH_MODE_BIDIRECTIONAL)
+    {
+    this->BidirectionalSearch(startVertex, endVertex);
+    }
+  else
+    {
+    this->UnidirectionalSearch(startVertex, &endVertex, 1, true, false);
+    }
+  return this->Internal->Forward.Weights[endVertex] != VTK_DOUBLE_MAX;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::FindShortestPaths(vtkIdType startVertex, vtkIdList* endVertices,
+  bool stopWhenEndVerticesReached)
+{
+  if (!this->Graph)
+    {
+    vtkErrorMacro("FindShortestPaths: graph is not set");
+    return;
+    }
+  vtkIdType numberOfVertices = this->Graph->GetNumberOfVertices();
+  vtkIdType numberOfEndVertices = (endVertices ? endVertices->GetNumberOfIds() : 0);
+  if (startVertex < 0 || startVertex >= numberOfVertices)
+    {
+    vtkErrorMacro("FindShortestPaths: start vertex " << startVertex << " is out of range [0, " << numberOfVertices - 1 << "]");
+    return;
+    }
+  for (vtkIdType i = 0; i < numberOfEndVertices; i++)
+    {
+    if (endVertices->GetId(i) < 0 || endVertices->GetId(i) >= numberOfVertices)
+      {
+      vtkErrorMacro("FindShortestPaths: end vertex " << endVertices->GetId(i) << " is out of range [0, " << numberOfVertices - 1 << "]");
+      return;
+      }
+    }
+  this->UnidirectionalSearch(startVertex, numberOfEndVertices > 0 ? endVertices->GetPointer(0) : nullptr,
+    numberOfEndVertices, stopWhenEndVerticesReached && numberOfEndVertices > 0, false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::ComputeDistanceField(vtkIdType sourceVertex, bool reverse)
+{
+  if (!this->Graph)
+    {
+    vtkErrorMacro("ComputeDistanceField: graph is not set");
+    return;
+    }
+  if (sourceVertex < 0 || sourceVertex >= this->Graph->GetNumberOfVertices())
+    {
+    vtkErrorMacro("ComputeDistanceField: source vertex " << sourceVertex
+      << " is out of range [0, " << this->Graph->GetNumberOfVertices() - 1 << "]");
+    return;
+    }
+  this->UnidirectionalSearch(sourceVertex, nullptr, 0, false, reverse);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::ComputeDistanceFieldParallel(vtkIdType sourceVertex, double bucketWidth)
+{
+  if (!this->Graph)
+    {
+    vtkErrorMacro("ComputeDistanceFieldParallel: graph is not set");
+    return;
+    }
+  vtkSlicerDijkstraGraph* graph = this->Graph;
+  const vtkIdType numberOfVertices = graph->GetNumberOfVertices();
+  if (sourceVertex < 0 || sourceVertex >= numberOfVertices)
+    {
+    vtkErrorMacro("ComputeDistanceFieldParallel: source vertex " << sourceVertex
+      << " is out of range [0, " << numberOfVertices - 1 << "]");
+    return;
+    }
+  this->Internal->FastMarchingSourceVertex = -1;
+  if (this->Internal->DynamicEdgeCostFunction)
+    {
+    // The dynamic edge cost function is not required to be thread-safe
+    this->UnidirectionalSearch(sourceVertex, nullptr, 0, false, false);
+    return;
+    }
+
+  const vtkIdType* offsets = graph->Offsets.data();
+  const vtkIdType* neighbors = graph->Neighbors.data();
+  // Weights are pulled from the neighbors, therefore the cost of the edge from the neighbor to the vertex is needed
+  const float* incomingCosts = graph->TransposedCosts.data();
+  const vtkIdType numberOfEdges = graph->GetNumberOfEdges();
+  const double maximumPathCost = this->MaximumPathCost;
+
+  if (bucketWidth <= 0.0)
+    {
+    // Average edge cost is a good compromise between the number of buckets and the number of repeated relaxations
+    vtkSMPThreadLocal<double> localCostSum(0.0);
+    vtkSMPTools::For(0, numberOfEdges, [&](vtkIdType beginEdge, vtkIdType endEdge)
+      {
+      double& costSum = localCostSum.Local();
+      for (vtkIdType edgeIndex = beginEdge; edgeIndex < endEdge; edgeIndex++)
+        {
+        costSum += incomingCosts[edgeIndex];
+        }
+      });
+    double costSum = 0.0;
+    for (double localSum : localCostSum)
+      {
+      costSum += localSum;
+      }
+    bucketWidth = (numberOfEdges > 0 && costSum > 0.0 ? costSum / numberOfEdges : 1.0);
+    }
+  auto getBucketIndex = [bucketWidth](double weight)
+    {
+    return static_cast<vtkTypeInt64>(std::min(std::floor(weight / bucketWidth), 1.0e18));
+    };
+
+  vtkInternal::SearchFront& front = this->Internal->Forward;
+  front.Reset(numberOfVertices);
+  front.SetWeight(sourceVertex, 0.0, -1);
+  const std::vector<double>& weights = front.Weights;
+
+  // Vertices are added to the bucket of their weight when their weight decreases. A vertex may be
+  // in multiple buckets, it is ignored in all buckets except the one that contains its current weight.
+  std::map<vtkTypeInt64, std::vector<vtkIdType>> buckets;
+  buckets[0].push_back(sourceVertex);
+
+  std::vector<vtkIdType> activeVertices;
+  std::vector<vtkIdType> candidateVertices;
+  std::vector<double> candidateWeights;
+  std::vector<vtkIdType> candidatePredecessors;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localCandidateVertices;
+
+  while (!buckets.empty())
+    {
+    const vtkTypeInt64 bucketIndex = buckets.begin()->first;
+    activeVertices.clear();
+    for (vtkIdType v : buckets.begin()->second)
+      {
+      if (getBucketIndex(weights[v]) == bucketIndex)
+        {
+        activeVertices.push_back(v);
+        }
+      }
+    buckets.erase(buckets.begin());
+    std::sort(activeVertices.begin(), activeVertices.end());
+    activeVertices.erase(std::unique(activeVertices.begin(), activeVertices.end()), activeVertices.end());
+    if (activeVertices.empty())
+      {
+      continue;
+      }
+    const double bucketMinimumWeight = bucketIndex * bucketWidth;
+
+    // Relax the edges of the vertices in the current bucket until their weights do not change.
+    // Vertices in earlier buckets are final and cannot be improved.
+    while (!activeVertices.empty())
+      {
+      // Collect the distinct neighbors of the active vertices
+      for (std::vector<vtkIdType>& localCandidates : localCandidateVertices)
+        {
+        localCandidates.clear();
+        }
+      vtkSMPTools::For(0, static_cast<vtkIdType>(activeVertices.size()), [&](vtkIdType beginIndex, vtkIdType endIndex)
+        {
+        std::vector<vtkIdType>& localCandidates = localCandidateVertices.Local();
+        for (vtkIdType index = beginIndex; index < endIndex; index++)
+          {
+          vtkIdType u = activeVertices[index];
+          for (vtkIdType edgeIndex = offsets[u]; edgeIndex < offsets[u + 1]; edgeIndex++)
+            {
+            vtkIdType v = neighbors[edgeIndex];
+            if (weights[v] >= bucketMinimumWeight)
+              {
+              localCandidates.push_back(v);
+              }
+            }
+          }
+        });
+      candidateVertices.clear();
+      for (const std::vector<vtkIdType>& localCandidates : localCandidateVertices)
+        {
+        candidateVertices.insert(candidateVertices.end(), localCandidates.begin(), localCandidates.end());
+        }
+      vtkSMPTools::Sort(candidateVertices.begin(), candidateVertices.end());
+      candidateVertices.erase(std::unique(candidateVertices.begin(), candidateVertices.end()), candidateVertices.end());
+
+      // Each candidate computes its new weight from all its neighbors. Weights are only read in this step,
+      // therefore no synchronization is needed between threads.
+      const vtkIdType numberOfCandidates = static_cast<vtkIdType>(candidateVertices.size());
+      candidateWeights.resize(numberOfCandidates);
+      candidatePredecessors.resize(numberOfCandidates);
+      vtkSMPTools::For(0, numberOfCandidates, [&](vtkIdType beginIndex, vtkIdType endIndex)
+        {
+        for (vtkIdType index = beginIndex; index < endIndex; index++)
+          {
+          vtkIdType v = candidateVertices[index];
+          double bestWeight = weights[v];
+          vtkIdType bestPredecessor = -1;
+          for (vtkIdType edgeIndex = offsets[v]; edgeIndex < offsets[v + 1]; edgeIndex++)
+            {
+            vtkIdType u = neighbors[edgeIndex];
+            if (weights[u] == VTK_DOUBLE_MAX)
+              {
+              continue;
+              }
+            double weight = weights[u] + incomingCosts[edgeIndex];
+            if (weight < bestWeight && weight <= maximumPathCost)
+              {
+              bestWeight = weight;
+              bestPredecessor = u;
+              }
+            }
+          candidateWeights[index] = bestWeight;
+          candidatePredecessors[index] = bestPredecessor;
+          }
+        });
+
+      // Apply the improved weights. Vertices that remain in the current bucket are relaxed again.
+      activeVertices.clear();
+      for (vtkIdType index = 0; index < numberOfCandidates; index++)
+        {
+        if (candidatePredecessors[index] < 0)
+          {
+          continue;
+          }
+        vtkIdType v = candidateVertices[index];
+        front.SetWeight(v, candidateWeights[index], candidatePredecessors[index]);
+        vtkTypeInt64 candidateBucketIndex = getBucketIndex(candidateWeights[index]);
+        if (candidateBucketIndex == bucketIndex)
+          {
+          activeVertices.push_back(v);
+          }
+        else
+          {
+          buckets[candidateBucketIndex].push_back(v);
+          }
+        }
+      }
+    }
+
+  // All reached vertices are final
+  front.SettledVertices = front.ReachedVertices;
+  for (vtkIdType v : front.SettledVertices)
+    {
+    front.Settled[v] = 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::UnidirectionalSearch(vtkIdType startVertex, const vtkIdType* endVertices,
+  vtkIdType numberOfEndVertices, bool stopAtEndVertices, bool transposed)
+{
+  vtkSlicerDijkstraGraph* graph = this->Graph;
+  vtkIdType numberOfVertices = graph->GetNumberOfVertices();
+
+  // A* search is used if landmarks are available for computing lower bounds of the remaining cost to the end vertex.
+  // The lower bound is a consistent heuristic, therefore vertices are still final when they are settled.
+  // Dynamic edge costs only increase the cost of paths, therefore they do not invalidate the bounds.
+  const bool useLandmarks = (stopAtEndVertices && numberOfEndVertices == 1 && !transposed && !graph->Landmarks.empty());
+  const vtkIdType endVertex = (numberOfEndVertices > 0 ? endVertices[0] : -1);
+  this->Internal->FastMarchingSourceVertex = -1;
+
+  const double maximumPathCost = this->MaximumPathCost;
+
+  vtkInternal::SearchFront& front = this->Internal->Forward;
+  front.Reset(numberOfVertices);
+  front.SetWeight(startVertex, 0.0, -1);
+  front.Push(startVertex, 0.0);
+
+  std::vector<char>& isTarget = this->Internal->IsTarget;
+  isTarget.resize(numberOfVertices, 0);
+  vtkIdType numberOfRemainingTargets = this->Internal->SetTargets(endVertices, numberOfEndVertices, 1);
+
+  const vtkIdType* offsets = graph->Offsets.data();
+  const vtkIdType* neighbors = graph->Neighbors.data();
+  const float* costs = (transposed ? graph->TransposedCosts.data() : graph->Costs.data());
+  const DynamicEdgeCostFunctionType& dynamicEdgeCost = this->Internal->DynamicEdgeCostFunction;
+
+  // The heap key is a lower bound of the cost of any path through the vertex,
+  // therefore the search can stop when the minimum key exceeds the maximum path cost.
+  vtkIdType u = -1;
+  while (front.GetMinimumKey() <= maximumPathCost && (u = front.SettleMinimum()) >= 0)
+    {
+    if (isTarget[u])
+      {
+      numberOfRemainingTargets--;
+      if (stopAtEndVertices && numberOfRemainingTargets == 0)
+        {
+        // shortest paths to all end vertices are determined
+        break;
+        }
+      }
+    for (vtkIdType edgeIndex = offsets[u]; edgeIndex < offsets[u + 1]; edgeIndex++)
+      {
+      vtkIdType v = neighbors[edgeIndex];
+      if (front.Settled[v])
+        {
+        continue;
+        }
+      double cost = costs[edgeIndex];
+      if (dynamicEdgeCost)
+        {
+        cost += (transposed ? dynamicEdgeCost(v, u) : dynamicEdgeCost(u, v));
+        }
+      front.Relax(u, v, cost, maximumPathCost, useLandmarks ? graph->GetLandmarkLowerBound(v, endVertex) : 0.0);
+      }
+    }
+
+  this->Internal->SetTargets(endVertices, numberOfEndVertices, 0);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::BidirectionalSearch(vtkIdType startVertex, vtkIdType endVertex)
+{
+  vtkSlicerDijkstraGraph* graph = this->Graph;
+  vtkIdType numberOfVertices = graph->GetNumberOfVertices();
+
+  vtkInternal::SearchFront& forward = this->Internal->Forward;
+  vtkInternal::SearchFront& backward = this->Internal->Backward;
+  this->Internal->FastMarchingSourceVertex = -1;
+  forward.Reset(numberOfVertices);
+  backward.Reset(numberOfVertices);
+  forward.SetWeight(startVertex, 0.0, -1);
+  forward.Push(startVertex, 0.0);
+  backward.SetWeight(endVertex, 0.0, -1);
+  backward.Push(endVertex, 0.0);
+  const double maximumPathCost = this->MaximumPathCost;
+
+  const vtkIdType* offsets = graph->Offsets.data();
+  const vtkIdType* neighbors = graph->Neighbors.data();
+  const float* costs = graph->Costs.data();
+  const float* transposedCosts = graph->TransposedCosts.data();
+  const DynamicEdgeCostFunctionType& dynamicEdgeCost = this->Internal->DynamicEdgeCostFunction;
+
+  // Cost of the best path found so far, which goes through the edge meetingFrom -> meetingTo
+  double bestCost = (startVertex == endVertex ? 0.0 : VTK_DOUBLE_MAX);
+  vtkIdType meetingFrom = -1;
+  vtkIdType meetingTo = -1;
+
+  while (true)
+    {
+    double forwardMinimum = forward.GetMinimumKey();
+    double backwardMinimum = backward.GetMinimumKey();
+    if (forwardMinimum == VTK_DOUBLE_MAX || backwardMinimum == VTK_DOUBLE_MAX
+      || forwardMinimum + backwardMinimum >= bestCost || forwardMinimum + backwardMinimum > maximumPathCost)
+      {
+      // No path that has not been examined yet can be shorter than the best path or the maximum path cost
+      break;
+      }
+
+    if (forwardMinimum <= backwardMinimum)
+      {
+      vtkIdType u = forward.SettleMinimum();
+      for (vtkIdType edgeIndex = offsets[u]; edgeIndex < offsets[u + 1]; edgeIndex++)
+        {
+        vtkIdType v = neighbors[edgeIndex];
+        double cost = costs[edgeIndex];
+        if (dynamicEdgeCost)
+          {
+          cost += dynamicEdgeCost(u, v);
+          }
+        if (!forward.Settled[v])
+          {
+          forward.Relax(u, v, cost, maximumPathCost);
+          }
+        if (backward.Weights[v] != VTK_DOUBLE_MAX && forward.Weights[u] + cost + backward.Weights[v] < bestCost)
+          {
+          bestCost = forward.Weights[u] + cost + backward.Weights[v];
+          meetingFrom = u;
+          meetingTo = v;
+          }
+        }
+      }
+    else
+      {
+      // The backward search goes through the edges in reverse direction,
+      // therefore the cost of going from the neighbor to u is used.
+      vtkIdType u = backward.SettleMinimum();
+      for (vtkIdType edgeIndex = offsets[u]; edgeIndex < offsets[u + 1]; edgeIndex++)
+        {
+        vtkIdType v = neighbors[edgeIndex];
+        double cost = transposedCosts[edgeIndex];
+        if (dynamicEdgeCost)
+          {
+          cost += dynamicEdgeCost(v, u);
+          }
+        if (!backward.Settled[v])
+          {
+          backward.Relax(u, v, cost, maximumPathCost);
+          }
+        if (forward.Weights[v] != VTK_DOUBLE_MAX && forward.Weights[v] + cost + backward.Weights[u] < bestCost)
+          {
+          bestCost = forward.Weights[v] + cost + backward.Weights[u];
+          meetingFrom = v;
+          meetingTo = u;
+          }
+        }
+      }
+    }
+
+  if (meetingTo < 0 || bestCost > maximumPathCost)
+    {
+    // Either start and end vertices are the same or there is no path between them within the maximum cost
+    return;
+    }
+
+  // Extend the forward predecessors with the backward search path, so that the path
+  // and the cumulative weights can be retrieved the same way as for unidirectional search.
+  forward.SetWeight(meetingTo, bestCost - backward.Weights[meetingTo], meetingFrom);
+  for (vtkIdType v = meetingTo; v != endVertex; v = backward.Predecessors[v])
+    {
+    vtkIdType next = backward.Predecessors[v];
+    forward.SetWeight(next, bestCost - backward.Weights[next], v);
+    }
+}
+
+//------------------------------------------------------------------------------
+double vtkSlicerDijkstraGraphQuery::GetCumulativeWeight(vtkIdType vertex)
+{
+  const std::vector<double>& weights = this->Internal->Forward.Weights;
+  if (vertex < 0 || vertex >= static_cast<vtkIdType>(weights.size()) || weights[vertex] == VTK_DOUBLE_MAX)
+    {
+    return -1.0;
+    }
+  return weights[vertex];
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::GetCumulativeWeights(vtkDoubleArray* weights)
+{
+  if (!weights)
+    {
+    return;
+    }
+  const std::vector<double>& cumulativeWeights = this->Internal->Forward.Weights;
+  weights->Initialize();
+  weights->SetNumberOfValues(static_cast<vtkIdType>(cumulativeWeights.size()));
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(cumulativeWeights.size()); i++)
+    {
+    weights->SetValue(i, cumulativeWeights[i] == VTK_DOUBLE_MAX ? -1.0 : cumulativeWeights[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraphQuery::GetPath(vtkIdType endVertex, vtkIdList* pathVertices)
+{
+  const vtkInternal::SearchFront& forward = this->Internal->Forward;
+  if (!pathVertices || endVertex < 0 || endVertex >= static_cast<vtkIdType>(forward.Weights.size())
+    || forward.Weights[endVertex] == VTK_DOUBLE_MAX)
+    {
+    return false;
+    }
+  // The number of ids is limited to protect against predecessor loops along zero-cost edges
+  vtkIdType maximumNumberOfPathVertices = static_cast<vtkIdType>(forward.Weights.size());
+  vtkIdType numberOfPathVertices = 0;
+  for (vtkIdType v = endVertex; v >= 0 && numberOfPathVertices < maximumNumberOfPathVertices; v = forward.Predecessors[v])
+    {
+    pathVertices->InsertNextId(v);
+    numberOfPathVertices++;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::GetSettledVertices(vtkIdList* settledVertices)
+{
+  if (!settledVertices)
+    {
+    return;
+    }
+  const std::vector<vtkIdType>& vertices = this->Internal->Forward.SettledVertices;
+  settledVertices->SetNumberOfIds(static_cast<vtkIdType>(vertices.size()));
+  std::copy(vertices.begin(), vertices.end(), settledVertices->GetPointer(0));
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphQuery::ComputeFastMarchingDistanceField(vtkIdType sourceVertex, vtkIdList* endVertices)
+{
+  this->Internal->FastMarchingSourceVertex = -1;
+  if (!this->Graph)
+    {
+    vtkErrorMacro("ComputeFastMarchingDistanceField: graph is not set");
+    return;
+    }
+  vtkSlicerDijkstraGraph* graph = this->Graph;
+  const vtkIdType numberOfVertices = graph->GetNumberOfVertices();
+  if (sourceVertex < 0 || sourceVertex >= numberOfVertices)
+    {
+    vtkErrorMacro("ComputeFastMarchingDistanceField: source vertex " << sourceVertex
+      << " is out of range [0, " << numberOfVertices - 1 << "]");
+    return;
+    }
+  if (graph->GetNumberOfTriangles() == 0)
+    {
+    vtkErrorMacro("ComputeFastMarchingDistanceField: triangles are not built in the graph");
+    return;
+    }
+  vtkIdType numberOfEndVertices = (endVertices ? endVertices->GetNumberOfIds() : 0);
+  for (vtkIdType i = 0; i < numberOfEndVertices; i++)
+    {
+    if (endVertices->GetId(i) < 0 || endVertices->GetId(i) >= numberOfVertices)
+      {
+      vtkErrorMacro("ComputeFastMarchingDistanceField: end vertex " << endVertices->GetId(i)
+        << " is out of range [0, " << numberOfVertices - 1 << "]");
+      return;
+      }
+    }
+  const vtkIdType* endVertexIds = (numberOfEndVertices > 0 ? endVertices->GetPointer(0) : nullptr);
+  this->Internal->FastMarchingSourceVertex = sourceVertex;
+
+  vtkInternal::SearchFront& front = this->Internal->Forward;
+  front.Reset(numberOfVertices);
+  front.SetWeight(sourceVertex, 0.0, -1);
+  front.Push(sourceVertex, 0.0);
+
+  std::vector<char>& isTarget = this->Internal->IsTarget;
+  isTarget.resize(numberOfVertices, 0);
+  vtkIdType numberOfRemainingTargets = this->Internal->SetTargets(endVertexIds, numberOfEndVertices, 1);
+
+  const vtkIdType* triangles = graph->Triangles.data();
+  const vtkIdType* vertexTriangleOffsets = graph->VertexTriangleOffsets.data();
+  const vtkIdType* vertexTriangles = graph->VertexTriangles.data();
+  const double* points = graph->Points.data();
+  const std::vector<double>& weights = front.Weights;
+  const std::vector<char>& settled = front.Settled;
+
+  // When all end vertices are reached, the search continues until the vertices of all triangles that the paths
+  // may cross are settled. Along a path the distance is less than the distance of its end vertex,
+  // therefore these vertices are not farther than the longest edge.
+  double stopWeight = this->MaximumPathCost;
+  vtkIdType u = -1;
+  while (front.GetMinimumKey() <= stopWeight && (u = front.SettleMinimum()) >= 0)
+    {
+    if (isTarget[u])
+      {
+      numberOfRemainingTargets--;
+      if (numberOfRemainingTargets == 0)
+        {
+        stopWeight = std::min(stopWeight, weights[u] + graph->MaximumEdgeLength);
+        }
+      }
+    for (vtkIdType index = vertexTriangleOffsets[u]; index < vertexTriangleOffsets[u + 1]; index++)
+      {
+      const vtkIdType* triangle = triangles + 3 * vertexTriangles[index];
+      for (int i = 0; i < 3; i++)
+        {
+        // update vertex w from u, and also from x if it is already settled
+        vtkIdType w = triangle[i];
+        vtkIdType x = triangle[0] + triangle[1] + triangle[2] - u - w;
+        if (w == u || settled[w])
+          {
+          continue;
+          }
+        const double* pointU = points + 3 * u;
+        const double* pointW = points + 3 * w;
+        double weight = weights[u] + sqrt(vtkMath::Distance2BetweenPoints(pointU, pointW));
+        if (settled[x])
+          {
+          weight = std::min(weight, ComputeTriangleArrivalTime(pointU, points + 3 * x, pointW, weights[u], weights[x]));
+          }
+        if (weight < weights[w] && weight <= this->MaximumPathCost)
+          {
+          front.SetWeight(w, weight, u);
+          front.Push(w, weight);
+          }
+        }
+      }
+    }
+
+  this->Internal->SetTargets(endVertexIds, numberOfEndVertices, 0);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraphQuery::GetFastMarchingPath(vtkIdType endVertex, vtkPoints* pathPoints)
+{
+  const vtkIdType sourceVertex = this->Internal->FastMarchingSourceVertex;
+  const std::vector<double>& weights = this->Internal->Forward.Weights;
+  if (!pathPoints || !this->Graph || sourceVertex < 0 || endVertex < 0
+    || endVertex >= static_cast<vtkIdType>(weights.size()) || weights[endVertex] == VTK_DOUBLE_MAX)
+    {
+    return false;
+    }
+  vtkSlicerDijkstraGraph* graph = this->Graph;
+  const vtkIdType* triangles = graph->Triangles.data();
+  const vtkIdType* vertexTriangleOffsets = graph->VertexTriangleOffsets.data();
+  const vtkIdType* vertexTriangles = graph->VertexTriangles.data();
+  const double* points = graph->Points.data();
+  const double epsilon = 1e-9;
+
+  // Current position is a vertex (edgeVertexB < 0) or a point on the edge between edgeVertexA and edgeVertexB
+  // at parameter edgeParameter (0 = edgeVertexA, 1 = edgeVertexB).
+  vtkIdType edgeVertexA = endVertex;
+  vtkIdType edgeVertexB = -1;
+  double edgeParameter = 0.0;
+  double currentWeight = weights[endVertex];
+  double currentPoint[3] = { points[3 * endVertex], points[3 * endVertex + 1], points[3 * endVertex + 2] };
+  pathPoints->InsertNextPoint(currentPoint);
+
+  // Each step crosses a triangle or moves to a vertex with lower distance, the number of steps is limited
+  // to protect against infinite loops caused by numerical errors.
+  const vtkIdType maximumNumberOfSteps = 4 * graph->GetNumberOfTriangles() + 100;
+  for (vtkIdType step = 0; step < maximumNumberOfSteps; step++)
+    {
+    if (edgeVertexB < 0 && edgeVertexA == sourceVertex)
+      {
+      return true;
+      }
+
+    // Find the steepest descent across the triangles that contain the current position.
+    // If the gradient points out of all the triangles then the path continues along the steepest edge
+    // (the current position is at a vertex) or along the current edge (the edge is a valley of the distance field).
+    double bestRate = 0.0;
+    double bestBarycentric[3] = { 0.0, 0.0, 0.0 };
+    const vtkIdType* bestTriangle = nullptr;
+    double bestVertexRate = 0.0;
+    vtkIdType bestVertex = -1;
+    bool sourceInTriangle = false;
+    for (vtkIdType index = vertexTriangleOffsets[edgeVertexA]; index < vertexTriangleOffsets[edgeVertexA + 1]; index++)
+      {
+      const vtkIdType* triangle = triangles + 3 * vertexTriangles[index];
+      if (edgeVertexB >= 0 && triangle[0] != edgeVertexB && triangle[1] != edgeVertexB && triangle[2] != edgeVertexB)
+        {
+        // the triangle does not contain the current edge
+        continue;
+        }
+      double barycentric[3] = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < 3; i++)
+        {
+        if (triangle[i] == edgeVertexA)
+          {
+          barycentric[i] = 1.0 - edgeParameter;
+          }
+        else if (triangle[i] == edgeVertexB)
+          {
+          barycentric[i] = edgeParameter;
+          }
+        }
+      bool allReached = true;
+      for (int i = 0; i < 3; i++)
+        {
+        allReached = allReached && weights[triangle[i]] != VTK_DOUBLE_MAX;
+        sourceInTriangle = sourceInTriangle || triangle[i] == sourceVertex;
+        if (edgeVertexB < 0 && triangle[i] != edgeVertexA && weights[triangle[i]] < currentWeight)
+          {
+          const double* vertexPoint = points + 3 * triangle[i];
+          double vertexDistance = sqrt(vtkMath::Distance2BetweenPoints(currentPoint, vertexPoint));
+          double vertexRate = (vertexDistance > 0.0 ? (currentWeight - weights[triangle[i]]) / vertexDistance : VTK_DOUBLE_MAX);
+          if (vertexRate > bestVertexRate)
+            {
+            bestVertexRate = vertexRate;
+            bestVertex = triangle[i];
+            }
+          }
+        }
+      if (!allReached)
+        {
+        continue;
+        }
+
+      // Gradient of the linearly interpolated distance: g = alpha * e1 + beta * e2, where g.e1 = t1 - t0, g.e2 = t2 - t0
+      const double* p0 = points + 3 * triangle[0];
+      const double* p1 = points + 3 * triangle[1];
+      const double* p2 = points + 3 * triangle[2];
+      double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+      double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+      double e11 = vtkMath::Dot(e1, e1);
+      double e12 = vtkMath::Dot(e1, e2);
+      double e22 = vtkMath::Dot(e2, e2);
+      double determinant = e11 * e22 - e12 * e12;
+      if (determinant <= epsilon * e11 * e22)
+        {
+        // degenerate triangle
+        continue;
+        }
+      double dt1 = weights[triangle[1]] - weights[triangle[0]];
+      double dt2 = weights[triangle[2]] - weights[triangle[0]];
+      double alpha = (dt1 * e22 - dt2 * e12) / determinant;
+      double beta = (dt2 * e11 - dt1 * e12) / determinant;
+
+      // Move against the gradient (in barycentric coordinates) until the triangle boundary is reached
+      double direction[3] = { alpha + beta, -alpha, -beta };
+      double stepLength = VTK_DOUBLE_MAX;
+      for (int i = 0; i < 3; i++)
+        {
+        if (direction[i] < 0.0)
+          {
+          stepLength = std::min(stepLength, barycentric[i] / -direction[i]);
+          }
+        }
+      if (stepLength == VTK_DOUBLE_MAX || stepLength <= epsilon)
+        {
+        // the descent direction points out of this triangle
+        continue;
+        }
+      double exitBarycentric[3] = { 0.0, 0.0, 0.0 };
+      double exitPoint[3] = { 0.0, 0.0, 0.0 };
+      double exitWeight = 0.0;
+      for (int i = 0; i < 3; i++)
+        {
+        exitBarycentric[i] = std::max(0.0, barycentric[i] + stepLength * direction[i]);
+        }
+      double barycentricSum = exitBarycentric[0] + exitBarycentric[1] + exitBarycentric[2];
+      for (int i = 0; i < 3; i++)
+        {
+        exitBarycentric[i] /= barycentricSum;
+        exitWeight += exitBarycentric[i] * weights[triangle[i]];
+        for (int j = 0; j < 3; j++)
+          {
+          exitPoint[j] += exitBarycentric[i] * points[3 * triangle[i] + j];
+          }
+        }
+      double stepDistance = sqrt(vtkMath::Distance2BetweenPoints(currentPoint, exitPoint));
+      if (stepDistance <= 0.0 || exitWeight >= currentWeight)
+        {
+        continue;
+        }
+      double rate = (currentWeight - exitWeight) / stepDistance;
+      if (rate > bestRate)
+        {
+        bestRate = rate;
+        bestTriangle = triangle;
+        std::copy(exitBarycentric, exitBarycentric + 3, bestBarycentric);
+        }
+      }
+
+    if (sourceInTriangle)
+      {
+      // The shortest path within a triangle is a straight line
+      edgeVertexA = sourceVertex;
+      edgeVertexB = -1;
+      }
+    else if (bestTriangle)
+      {
+      // Snap to a vertex or an edge of the triangle
+      int numberOfNonZero = 0;
+      int nonZeroIndices[3] = { -1, -1, -1 };
+      for (int i = 0; i < 3; i++)
+        {
+        if (bestBarycentric[i] > epsilon)
+          {
+          nonZeroIndices[numberOfNonZero++] = i;
+          }
+        }
+      if (numberOfNonZero == 1)
+        {
+        edgeVertexA = bestTriangle[nonZeroIndices[0]];
+        edgeVertexB = -1;
+        }
+      else
+        {
+        if (numberOfNonZero == 3)
+          {
+          // Numerical error, the exit point is close to an edge: remove the smallest coordinate
+          int smallestIndex = static_cast<int>(std::min_element(bestBarycentric, bestBarycentric + 3) - bestBarycentric);
+          std::remove(nonZeroIndices, nonZeroIndices + 3, smallestIndex);
+          }
+        edgeVertexA = bestTriangle[nonZeroIndices[0]];
+        edgeVertexB = bestTriangle[nonZeroIndices[1]];
+        edgeParameter = bestBarycentric[nonZeroIndices[1]] / (bestBarycentric[nonZeroIndices[0]] + bestBarycentric[nonZeroIndices[1]]);
+        }
+      }
+    else if (bestVertex >= 0)
+      {
+      edgeVertexA = bestVertex;
+      edgeVertexB = -1;
+      }
+    else if (edgeVertexB >= 0)
+      {
+      // The distance does not decrease across any triangle, continue along the edge
+      edgeVertexA = (weights[edgeVertexA] < weights[edgeVertexB] ? edgeVertexA : edgeVertexB);
+      edgeVertexB = -1;
+      }
+    else
+      {
+      vtkErrorMacro("GetFastMarchingPath: failed to descend from distance " << currentWeight);
+      return false;
+      }
+
+    // Update the current position
+    if (edgeVertexB < 0)
+      {
+      currentWeight = weights[edgeVertexA];
+      std::copy(points + 3 * edgeVertexA, points + 3 * edgeVertexA + 3, currentPoint);
+      }
+    else
+      {
+      currentWeight = (1.0 - edgeParameter) * weights[edgeVertexA] + edgeParameter * weights[edgeVertexB];
+      for (int j = 0; j < 3; j++)
+        {
+        currentPoint[j] = (1.0 - edgeParameter) * points[3 * edgeVertexA + j] + edgeParameter * points[3 * edgeVertexB + j];
+        }
+      }
+    pathPoints->InsertNextPoint(currentPoint);
+    }
+  vtkErrorMacro("GetFastMarchingPath: maximum number of steps is exceeded");
+  return false;
+}
@@ -0,0 +1,146 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerDijkstraGraphQuery_h
+#define __vtkSlicerDijkstraGraphQuery_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// export
+#include "vtkAddonExport.h"
+
+// STD includes
+#include <functional>
+
+class vtkDoubleArray;
+class vtkIdList;
+class vtkPoints;
+class vtkSlicerDijkstraGraph;
+
+/// Shortest path search in a vtkSlicerDijkstraGraph.
+///
+/// The query stores the state and result of a search (cumulative weights, predecessors, heap) and only reads the graph.
+/// Multiple queries can search the same graph concurrently, for example, one query per thread.
+/// Memory of the search state is kept between searches, therefore it is efficient to reuse the same query object.
+/// \sa vtkSlicerDijkstraGraph, vtkSlicerDijkstraGraphGeodesicPath
+class VTK_ADDON_EXPORT vtkSlicerDijkstraGraphQuery : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkSlicerDijkstraGraphQuery, vtkObject);
+  static vtkSlicerDijkstraGraphQuery* New();
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Graph that is searched.
+  virtual void SetGraph(vtkSlicerDijkstraGraph* graph);
+  vtkGetObjectMacro(Graph, vtkSlicerDijkstraGraph);
+
+  /// Maximum cost of the paths that are searched.
+  /// Searches stop when all vertices that can be reached within this cost are settled,
+  /// therefore the cost of a search is proportional to the size of the neighborhood, not the size of the graph.
+  /// Vertices that are farther from the source are considered unreachable.
+  /// Default value is VTK_DOUBLE_MAX (no limit).
+  vtkSetMacro(MaximumPathCost, double);
+  vtkGetMacro(MaximumPathCost, double);
+
+  /// Find the shortest path from startVertex to endVertex.
+  /// The search stops as soon as the shortest path is found, without processing the rest of the search front.
+  /// If searchMode is unidirectional and the graph has landmarks then A* search is used.
+  /// Returns false if the end vertex cannot be reached.
+  /// \sa vtkSlicerDijkstraGraphGeodesicPath::SetSearchMode()
+  bool FindShortestPath(vtkIdType startVertex, vtkIdType endVertex, int searchMode);
+
+  /// Find the shortest paths from startVertex to all the end vertices with a single search.
+  /// If stopWhenEndVerticesReached is false or endVertices is empty then the search continues
+  /// until all reachable vertices are visited.
+  void FindShortestPaths(vtkIdType startVertex, vtkIdList* endVertices, bool stopWhenEndVerticesReached);
+
+  /// Compute the cost of the shortest path from the source vertex to each vertex.
+  /// If reverse is true then the cost of the shortest path from each vertex to the source vertex is computed.
+  void ComputeDistanceField(vtkIdType sourceVertex, bool reverse = false);
+
+  /// Compute the cost of the shortest path from the source vertex to each vertex using multiple threads.
+  /// Delta-stepping algorithm is used: vertices are processed in buckets of bucketWidth cost range,
+  /// and the vertices of a bucket are relaxed in parallel until their weights do not change.
+  /// Results are the same as ComputeDistanceField within floating-point tolerance, but settled vertices
+  /// are returned in the order they were first reached. If bucketWidth is not positive then the average edge cost
+  /// is used. This is faster than ComputeDistanceField only for very large graphs.
+  /// The search is performed serially if a dynamic edge cost function is set, as it may not be thread-safe.
+  void ComputeDistanceFieldParallel(vtkIdType sourceVertex, double bucketWidth = 0.0);
+
+  /// Compute the geodesic distance from the source vertex to each vertex by the fast marching method on the triangles
+  /// of the graph. The distance is measured along straight lines across the triangles instead of along the edges,
+  /// therefore it is more accurate than the Dijkstra distance (which overestimates the geodesic distance) without
+  /// subdividing the mesh. Edge costs, scalar weights, and dynamic edge costs are not used.
+  /// If endVertices is specified then the search stops when all the end vertices and their surroundings
+  /// (required by GetFastMarchingPath) are reached.
+  /// Triangles must be built in the graph.
+  /// \sa vtkSlicerDijkstraGraph::BuildTriangles()
+  void ComputeFastMarchingDistanceField(vtkIdType sourceVertex, vtkIdList* endVertices = nullptr);
+
+  /// Append the points of the shortest path from endVertex to the source vertex of the last fast marching search
+  /// to pathPoints (endVertex first). The path is found by descending along the gradient of the distance field
+  /// across the triangles, therefore path points are generally not mesh vertices.
+  /// Returns false if endVertex was not reached.
+  bool GetFastMarchingPath(vtkIdType endVertex, vtkPoints* pathPoints);
+
+  /// Cumulative weight (cost of the shortest path) of the vertex in the last search.
+  /// Returns -1 if the vertex was not reached.
+  double GetCumulativeWeight(vtkIdType vertex);
+
+  /// Fill the array with the cumulative weights of all vertices in the last search.
+  /// Vertices that were not reached by the search have a weight of -1.
+  void GetCumulativeWeights(vtkDoubleArray* weights);
+
+  /// Append the vertices of the path that was found from the search source to endVertex
+  /// (in reverse order: endVertex first) to pathVertices.
+  /// Returns false if endVertex was not reached.
+  bool GetPath(vtkIdType endVertex, vtkIdList* pathVertices);
+
+  /// Get the vertices whose shortest path from the source was determined by the last search,
+  /// in the order they were settled (increasing order of distance, unless A* search was used).
+  /// For a distance field computation with MaximumPathCost set, these are all the vertices within the maximum cost.
+  /// For bidirectional searches only the vertices settled by the forward search are returned.
+  void GetSettledVertices(vtkIdList* settledVertices);
+
+  /// Function that computes an additional cost for going from vertex u to vertex v, which depends on the
+  /// search state or external data. It must not be negative. It is not available in wrapped languages.
+  /// By default it is not set.
+  typedef std::function<double(vtkIdType u, vtkIdType v)> DynamicEdgeCostFunctionType;
+  void SetDynamicEdgeCostFunction(const DynamicEdgeCostFunctionType& costFunction);
+
+protected:
+  vtkSlicerDijkstraGraphQuery();
+  ~vtkSlicerDijkstraGraphQuery() override;
+  vtkSlicerDijkstraGraphQuery(const vtkSlicerDijkstraGraphQuery&) = delete;
+  void operator=(const vtkSlicerDijkstraGraphQuery&) = delete;
+
+  /// Search from startVertex until all end vertices are reached (if stopAtEndVertices is true)
+  /// or all reachable vertices are visited.
+  void UnidirectionalSearch(vtkIdType startVertex, const vtkIdType* endVertices, vtkIdType numberOfEndVertices,
+    bool stopAtEndVertices, bool transposed);
+
+  /// Search simultaneously from startVertex and endVertex until the shortest path is found.
+  void BidirectionalSearch(vtkIdType startVertex, vtkIdType endVertex);
+
+  vtkSlicerDijkstraGraph* Graph;
+  double MaximumPathCost;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif